@@ -68,7 +68,7 @@ namespace detail {
 		template<Enum Type>
 		decltype(auto) get() {
 			const auto index = alternatives::template index_of_f([]<typename Alternative>() {
-				return Type == Alternative::type;
+				return Type == Alternative::enum_v;
 			});
 			static_assert(index < alternatives::size);
 			return std::get<index>(*reinterpret_cast<base_t*>(this));
@@ -96,8 +96,8 @@ private:
 	static constexpr auto max_header_size			= sizeof(type_integral_t) + max_meta_size;
 	static constexpr auto max_body_size				= std::max({ Messages::max_body_size... });
 	static constexpr auto max_header_packet_size	= aes_256_info::ivSize + aes_256_info::cipherLength(max_header_size);
-	static constexpr auto max_body_packet_size		= aes_256_info::ivSize + aes_256_info::cipherLength(max_header_size);
-	static constexpr auto text_buffer_size			= max_header_size + max_body_size;
+	static constexpr auto max_body_packet_size		= aes_256_info::ivSize + aes_256_info::cipherLength(max_body_size);
+	static constexpr auto text_buffer_size			= aes_256_info::cipherLength(max_header_size) + aes_256_info::cipherLength(max_body_size);
 	static constexpr auto packet_buffer_size		= max_header_packet_size + max_body_packet_size;
 
 	using messages = ztu::pack<Messages...>;
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <util/uix.hpp>
+#include <concepts>
+#include <system_error>
+#include <span>
+
+namespace frame_storage_concepts {
+
+	using namespace ztu::uix;
+
+	template<class T>
+	concept storage_size = requires(const T storage) {
+		/**
+		 * @brief Returns the capacity of the storage in bytes.
+		 */
+		{ storage.size() } -> std::same_as<usize>;
+
+		/**
+		 * @brief Returns the smallest unit that can be erased, offsets and sizes passed to 'erase' should be multiples of it.
+		 */
+		{ storage.block_size() } -> std::same_as<usize>;
+	};
+
+	template<class T>
+	concept storage_erase = requires(T storage, usize offset, usize size) {
+		/**
+		 * @brief Resets the given range so it can be written again.
+		 *
+		 * @note Implementations may erase more than requested to match their erase block size.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ storage.erase(offset, size) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept storage_write = requires(T storage, usize offset, std::span<const u8> data) {
+		/**
+		 * @brief Writes data to a previously erased range.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ storage.write(offset, data) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept storage_map = requires(T storage, std::span<const u8> &region) {
+		/**
+		 * @brief Maps the whole storage into the address space for reading.
+		 * If the storage is already mapped the existing mapping is returned.
+		 *
+		 * @param region Set to the mapped memory on success.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ storage.map(region) } -> std::same_as<std::error_code>;
+
+		/**
+		 * @brief Releases the mapping, previously returned regions must not be accessed afterwards.
+		 */
+		{ storage.unmap() } -> std::same_as<void>;
+	};
+}
+
+
+template<class T>
+concept frame_storage_concept = (
+	frame_storage_concepts::storage_size<T> and
+	frame_storage_concepts::storage_erase<T> and
+	frame_storage_concepts::storage_write<T> and
+	frame_storage_concepts::storage_map<T>
+);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <util/uix.hpp>
+#include <concepts>
+#include <system_error>
+
+namespace nvs_backend_concepts {
+
+	using namespace ztu::uix;
+
+	template<class T>
+	concept backend_open = requires(T backend, const char *name) {
+		/**
+		 * @brief Opens the namespace (or file) all following operations refer to.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ backend.open(name) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T, typename I>
+	concept backend_integral = requires(T backend, const char *key, I &dst, I src) {
+		/**
+		 * @brief Reads or writes an integer, values of a different integer type are not converted.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ backend.get_int(key, dst) } -> std::same_as<std::error_code>;
+		{ backend.set_int(key, src) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept backend_integrals = (
+		backend_integral<T, u8> and backend_integral<T, i8> and
+		backend_integral<T, u16> and backend_integral<T, i16> and
+		backend_integral<T, u32> and backend_integral<T, i32> and
+		backend_integral<T, u64> and backend_integral<T, i64>
+	);
+
+	template<class T>
+	concept backend_string = requires(T backend, const char *key, char *dst, usize &size, const char *src) {
+		/**
+		 * @brief Reads a null terminated string.
+		 *
+		 * @param dst If 'nullptr' only the required size including the terminator is written to 'size'.
+		 * @param size The size of 'dst', set to the number of bytes read.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ backend.get_str(key, dst, size) } -> std::same_as<std::error_code>;
+
+		{ backend.set_str(key, src) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept backend_blob = requires(T backend, const char *key, void *dst, usize &size, const void *src, usize srcSize) {
+		/**
+		 * @brief Reads a binary blob, same conventions as 'get_str'.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ backend.get_blob(key, dst, size) } -> std::same_as<std::error_code>;
+
+		{ backend.set_blob(key, src, srcSize) } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept backend_commit = requires(T backend) {
+		/**
+		 * @brief Makes all writes since the last commit persistent.
+		 *
+		 * Values that have been set are readable before they are committed,
+		 * but may be lost on power loss.
+		 *
+		 * @return An 'std::error_code' that indicates the status of the function. Returns '0' on success and a non-zero value on error.
+		 */
+		{ backend.commit() } -> std::same_as<std::error_code>;
+	};
+
+	template<class T>
+	concept backend_commit_timer = requires(T backend, i64 delayMicros, void (*callback)(void*), void *arg) {
+		/**
+		 * @brief Calls 'callback' once after 'delayMicros', used to coalesce the commits of consecutive writes.
+		 *
+		 * @return false if the timer could not be started.
+		 */
+		{ backend.schedule_commit(delayMicros, callback, arg) } -> std::same_as<bool>;
+
+		/**
+		 * @brief Cancels a scheduled call, does nothing if none is pending.
+		 */
+		{ backend.cancel_commit() } -> std::same_as<void>;
+	};
+}
+
+
+template<class T>
+concept nvs_backend_concept = (
+	nvs_backend_concepts::backend_open<T> and
+	nvs_backend_concepts::backend_integrals<T> and
+	nvs_backend_concepts::backend_string<T> and
+	nvs_backend_concepts::backend_blob<T> and
+	nvs_backend_concepts::backend_commit<T> and
+	nvs_backend_concepts::backend_commit_timer<T>
+);
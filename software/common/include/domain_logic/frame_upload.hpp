@@ -0,0 +1,131 @@
+#pragma once
+
+#include <lighting/frame_library.hpp>
+#include <concepts/hmac_sha_512_engine_concept.hpp>
+#include <concepts/frame_storage_concept.hpp>
+#include <util/uix.hpp>
+#include <array>
+#include <concepts>
+#include <span>
+#include <system_error>
+
+// Frame libraries do not fit into a single message, so they are uploaded in chunks.
+// Every request of the plugin is answered with an UPLOAD_STATUS by the sign:
+//
+//   UPLOAD_BEGIN  (id, clips)         -> READY at the offset to continue from, or COMPLETE
+//   UPLOAD_CHUNK  (id, offset, data)  -> READY at the next offset, or REJECTED with the expected offset
+//   UPLOAD_COMMIT (id)                -> COMPLETE
+//
+// The id is derived from the content of the library. Beginning an upload with the id of
+// an interrupted one continues at the last written offset instead of starting over.
+// Chunks carry a truncated HMAC of id, offset and data, so a corrupted or foreign chunk
+// never ends up in flash.
+
+namespace frame_upload {
+
+	using namespace ztu::uix;
+
+	inline constexpr usize chunkSize = 512;
+	inline constexpr usize maxClips = 32;
+	inline constexpr usize macSize = 32;
+
+	inline constexpr usize clipInfoSize = sizeof(u32) + sizeof(u16);
+	inline constexpr usize chunkHeaderSize = 2 * sizeof(u32);
+	inline constexpr usize maxClipsSize = maxClips * clipInfoSize;
+	inline constexpr usize maxChunkSize = chunkHeaderSize + chunkSize + macSize;
+
+	using chunk_mac = std::array<u8, macSize>;
+
+	enum class status : u8 {
+		READY,		// send the data starting at 'offset'
+		REJECTED,	// the chunk was dropped, continue at 'offset'
+		COMPLETE,	// the library is installed
+		FAILED		// the upload was aborted and has to begin again
+	};
+
+	struct reply {
+		u32 uploadId;
+		u32 offset;
+		status state;
+	};
+
+	struct clip_list {
+		[[nodiscard]] std::span<const frame_clip_info> clips() const {
+			return { m_clips.begin(), numClips };
+		}
+
+		std::array<frame_clip_info, maxClips> m_clips{};
+		u16 numClips{ 0 };
+	};
+
+	struct chunk {
+		u32 uploadId;
+		u32 offset;
+		// both point into the buffer the chunk was decoded from
+		std::span<const u8> data;
+		std::span<const u8> signedBytes;
+		chunk_mac mac;
+	};
+
+	/**
+	 * @return The number of bytes written or zero if there are too many clips.
+	 */
+	[[nodiscard]] inline usize encodeClips(std::span<const frame_clip_info> clips, std::span<u8> dst);
+
+	[[nodiscard]] inline bool decodeClips(std::span<const u8> src, clip_list &list);
+
+	/**
+	 * @brief Writes id, offset and data of the chunk, the mac is appended by the caller.
+	 *
+	 * @return The bytes covered by the mac, empty if the chunk does not fit.
+	 */
+	[[nodiscard]] inline std::span<const u8> encodeChunk(const chunk &c, std::span<u8> dst);
+
+	[[nodiscard]] inline bool decodeChunk(std::span<const u8> src, chunk &c);
+
+	template<hmac_sha_512_engine_concept engine_t>
+	[[nodiscard]] std::error_code authenticate(engine_t &engine, std::span<const u8> signedBytes, chunk_mac &mac);
+
+	template<hmac_sha_512_engine_concept engine_t>
+	[[nodiscard]] bool verify(engine_t &engine, const chunk &c);
+}
+
+/**
+ * @brief Sign side of the upload, writes verified chunks through a 'frame_library_writer'.
+ *
+ * Only the progress of the current upload is kept, so memory use does not depend on the library size.
+ */
+template<frame_storage_concept storage_t>
+class frame_upload_receiver {
+public:
+	explicit frame_upload_receiver(storage_t &storage);
+
+	/**
+	 * @brief Starts a new upload or resumes the current one if id and clips match.
+	 * 'beforeErase' is called once new clips are accepted, right before the previous library is erased,
+	 * so neither resumed nor rejected uploads call it.
+	 */
+	template<std::invocable F>
+	[[nodiscard]] frame_upload::reply begin(u32 uploadId, std::span<const frame_clip_info> clips, F &&beforeErase);
+
+	template<hmac_sha_512_engine_concept engine_t>
+	[[nodiscard]] frame_upload::reply write(engine_t &engine, const frame_upload::chunk &c);
+
+	[[nodiscard]] frame_upload::reply commit(u32 uploadId);
+
+	[[nodiscard]] std::error_code error() const;
+
+private:
+	[[nodiscard]] frame_upload::reply fail(const std::error_code &e);
+
+	frame_library_writer<storage_t> writer;
+	frame_upload::clip_list clips{};
+	u32 uploadId{ 0 };
+	u32 nextOffset{ 0 };
+	bool inProgress{ false };
+	std::error_code lastError{};
+};
+
+#define INCLUDE_FRAME_UPLOAD_IMPLEMENTATION
+#include <domain_logic/frame_upload.ipp>
+#undef INCLUDE_FRAME_UPLOAD_IMPLEMENTATION
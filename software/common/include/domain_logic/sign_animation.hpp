@@ -1,11 +1,14 @@
 #pragma once
 
 #include <lighting/animation.hpp>
+#include <lighting/animation_params.hpp>
 
 constexpr auto maxSequenceLength = 8;
 constexpr auto ticksPerColor = 1024;
-constexpr auto numPixels = 16;
-constexpr auto numFrames = 8;
+// Stop motion animations repeat frames of 'stopMotionPixels' colors along the strip,
+// the length of the strip itself is only known at runtime.
+constexpr auto stopMotionPixels = 16;
+constexpr auto stopMotionFrames = 8;
 
 using sign_suppliers = color_suppliers<maxSequenceLength>;
 using sign_supplier = color_supplier<sign_suppliers>;
@@ -17,7 +20,9 @@ using sign_sequencer = color_sequencer<ticksPerColor, sign_supplier>;
 
 using sign_mix_type = color_mixing::type;
 
-using sign_animations = animations<ticksPerColor, numPixels, numFrames, sign_sequencer, sign_scaler>;
+using sign_animations = animations<ticksPerColor, stopMotionPixels, stopMotionFrames, sign_sequencer, sign_scaler>;
 using sign_animation = variable_speed_animation<sign_animations>;
 
 using sign_basic_animation = sign_animation::animation_t;
+
+using sign_animation_params = animation_params;
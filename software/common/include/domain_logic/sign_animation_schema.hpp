@@ -0,0 +1,69 @@
+#pragma once
+
+#include <domain_logic/sign_animation.hpp>
+#include <util/schema.hpp>
+
+// Single description of all animation types.
+// The wire format in 'sign_animation_transcoding.hpp' and the json converters of the plugin
+// are generated from these lists, so field order and names must only be changed here.
+
+namespace ztu::schema {
+
+	template<>
+	struct of<sign_supplier> : variant<sign_supplier,
+		alternative<"RANDOM">,
+		alternative<"SEQUENCE",
+			field<"colors", bounded_array<&sign_suppliers::sequence::m_colors, &sign_suppliers::sequence::numColors>>
+		>
+	> {};
+
+	template<>
+	struct of<sign_scaler> : variant<sign_scaler,
+		alternative<"PING_PONG">,
+		alternative<"SINUS">,
+		alternative<"RANDOM">,
+		alternative<"SMOOTH_RANDOM">
+	> {};
+
+	template<>
+	struct of<sign_sequencer> : object<sign_sequencer,
+		member_field<"supplier", &sign_sequencer::supplier>,
+		field<"mixType", enumeration<&sign_sequencer::mixType, sign_mix_type::NO_MIXING>>
+	> {};
+
+	template<>
+	struct of<sign_basic_animation> : variant<sign_basic_animation,
+		alternative<"UNIFORM_COLOR",
+			member_field<"sequencer", &sign_animations::uniform_color::sequencer>
+		>,
+		alternative<"MOVING_COLORS",
+			member_field<"sequencer", &sign_animations::moving_colors::sequencer>,
+			member_field<"perPixelOffset", &sign_animations::moving_colors::perPixelOffset>,
+			member_field<"pixelOffset", &sign_animations::moving_colors::pixelOffset>
+		>,
+		alternative<"MOVING_PIXEL",
+			member_field<"sequencer", &sign_animations::moving_pixel::sequencer>,
+			member_field<"scaler", &sign_animations::moving_pixel::scaler>,
+			member_field<"colorSpeed", &sign_animations::moving_pixel::colorSpeed>,
+			member_field<"width", &sign_animations::moving_pixel::width>
+		>,
+		alternative<"STOP_MOTION",
+			field<"frames", bounded_array<
+				&sign_animations::stop_motion::m_frames,
+				&sign_animations::stop_motion::numFrames,
+				sign_animations::stopMotionPixels
+			>>
+		>,
+		alternative<"LIBRARY_STOP_MOTION",
+			member_field<"clip", &sign_animations::library_stop_motion::clipIndex>,
+			member_field<"ticksPerFrame", &sign_animations::library_stop_motion::ticksPerFrame>
+		>
+	> {};
+
+	template<>
+	struct of<sign_animation> : object<sign_animation,
+		member_field<"animator", &sign_animation::animator>,
+		member_field<"speed", &sign_animation::speed>,
+		field<"seed", appended<&sign_animation::seed>>
+	> {};
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <util/uix.hpp>
+#include <util/metrics.hpp>
+#include <util/byte_fields.hpp>
+#include <array>
+#include <span>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Runtime numbers of a sign at one point in time.
+ */
+struct sign_metrics {
+	u32 uptimeSeconds;
+
+	// animation task
+	u32 frames;
+	u32 missedTicks;					// ticks that took longer than their slot
+	u32 renderMicrosLast;
+	u32 renderMicrosAverage;
+	u32 renderMicrosMax;
+
+	// memory, stack high water marks are the bytes never used
+	u32 freeHeap;
+	u32 minFreeHeap;
+	u32 largestFreeBlock;
+	u32 mainStackHighWater;
+	u32 animationStackHighWater;
+
+	// connection to the plugin
+	u32 wifiConnects;
+	u32 wifiFailures;
+	u32 pluginConnects;
+	u32 handshakes;						// completed challenge exchanges
+	u32 handshakeFailures;
+	u32 handshakeMillisLast;
+	u32 handshakeMillisAverage;
+	u32 handshakeMillisMax;
+	u32 decryptErrors;
+};
+
+namespace sign_metrics_fields {
+
+	struct field {
+		const char *name;
+		u32 sign_metrics::*member;
+	};
+
+	/**
+	 * @brief Names of the metrics, in the style of prometheus so the sign and the plugin report them alike.
+	 */
+	inline constexpr std::array fields{
+		field{ "uptime_seconds", &sign_metrics::uptimeSeconds },
+		field{ "frames_total", &sign_metrics::frames },
+		field{ "missed_ticks_total", &sign_metrics::missedTicks },
+		field{ "render_micros_last", &sign_metrics::renderMicrosLast },
+		field{ "render_micros_average", &sign_metrics::renderMicrosAverage },
+		field{ "render_micros_max", &sign_metrics::renderMicrosMax },
+		field{ "free_heap_bytes", &sign_metrics::freeHeap },
+		field{ "min_free_heap_bytes", &sign_metrics::minFreeHeap },
+		field{ "largest_free_block_bytes", &sign_metrics::largestFreeBlock },
+		field{ "main_stack_unused_bytes", &sign_metrics::mainStackHighWater },
+		field{ "animation_stack_unused_bytes", &sign_metrics::animationStackHighWater },
+		field{ "wifi_connects_total", &sign_metrics::wifiConnects },
+		field{ "wifi_failures_total", &sign_metrics::wifiFailures },
+		field{ "plugin_connects_total", &sign_metrics::pluginConnects },
+		field{ "handshakes_total", &sign_metrics::handshakes },
+		field{ "handshake_failures_total", &sign_metrics::handshakeFailures },
+		field{ "handshake_millis_last", &sign_metrics::handshakeMillisLast },
+		field{ "handshake_millis_average", &sign_metrics::handshakeMillisAverage },
+		field{ "handshake_millis_max", &sign_metrics::handshakeMillisMax },
+		field{ "decrypt_errors_total", &sign_metrics::decryptErrors }
+	};
+
+	static_assert(fields.size() * sizeof(u32) == sizeof(sign_metrics), "every metric needs a name");
+
+	inline constexpr usize encodedSize = fields.size() * sizeof(u32);
+
+	/**
+	 * @brief Writes the metrics as words in the order of 'fields', 'dst' has to hold 'encodedSize' bytes.
+	 * @return The number of bytes written, zero if 'dst' is too small.
+	 */
+	[[nodiscard]] inline usize encode(const sign_metrics &src, std::span<u8> dst) {
+		if (dst.size() < encodedSize)
+			return 0;
+
+		auto it = dst.data();
+		for (const auto &field : fields) {
+			it = ztu::byte_fields::put(it, src.*field.member);
+		}
+		return encodedSize;
+	}
+
+	[[nodiscard]] inline bool decode(std::span<const u8> src, sign_metrics &dst) {
+		if (src.size() != encodedSize)
+			return false;
+
+		auto it = src.data();
+		for (const auto &field : fields) {
+			it = ztu::byte_fields::take(it, dst.*field.member);
+		}
+		return true;
+	}
+}
+
+/**
+ * @brief Counters of the connection to the plugin, incremented by the main task and read by anyone.
+ */
+struct sign_connection_metrics {
+	ztu::metric_counter wifiConnects;
+	ztu::metric_counter wifiFailures;
+	ztu::metric_counter pluginConnects;
+	ztu::metric_counter handshakeFailures;
+	ztu::metric_counter decryptErrors;
+	ztu::metric_timing handshakeMillis;
+};
@@ -2,6 +2,8 @@
 
 #include <util/uix.hpp>
 
+using namespace ztu::uix;
+
 enum class sign_state : u8 {
 	CONNECTED,
 	RECORDING,
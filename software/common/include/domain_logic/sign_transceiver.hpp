@@ -1,17 +1,32 @@
 #pragma once
 
-#pragma once
-
 #include <domain_logic/sign_state.hpp>
 #include <domain_logic/sign_animation.hpp>
+#include <domain_logic/frame_upload.hpp>
 
 #include <sign_animation_transcoding.hpp>
 #include <aes_transceiver.hpp>
+#include <util/clock_estimator.hpp>
+#include <util/state_machine_stats.hpp>
+#include <domain_logic/sign_metrics.hpp>
+#include <cstring>
 
 enum class sign_message_type : u8 {
 	CHANGE_STATE = 0,
 	SET_ANIMATION = 1,
-	HEARTBEAT = 2
+	HEARTBEAT = 2,
+	SET_PARAMS = 3,
+	TIME_PING = 4,
+	TIME_PONG = 5,
+	TIME_SYNC = 6,
+	UPLOAD_BEGIN = 7,
+	UPLOAD_CHUNK = 8,
+	UPLOAD_COMMIT = 9,
+	UPLOAD_STATUS = 10,
+	STATE_STATS_REQUEST = 11,
+	STATE_STATS = 12,
+	GET_METRICS = 13,
+	METRICS = 14
 };
 
 namespace sign_messages {
@@ -21,21 +36,25 @@ namespace sign_messages {
 		static constexpr auto type = sign_message_type::CHANGE_STATE;
 		static constexpr usize max_body_size = 0U;
 
-		using data_t = std::tuple<sign_state>;
+		// The state gets applied at the given reference time in microseconds, zero means immediately.
+		using data_t = std::tuple<sign_state, i64>;
 
 		struct meta_t {
+			i64 applyAt;
 			sign_state state;
 			[[nodiscard]] inline u16 body_size() const {
 				return 0;
 			}
 		};
 
-		inline static bool serialize(meta_t& meta, std::span<u8>, const sign_state &state) {
+		inline static bool serialize(meta_t& meta, std::span<u8>, const sign_state &state, const i64 &applyAt) {
+			meta.applyAt = applyAt;
 			meta.state = state;
 			return true;
 		}
 
-		inline static bool deserialize(const meta_t& meta, std::span<const u8>, sign_state &state) {
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, sign_state &state, i64 &applyAt) {
+			applyAt = meta.applyAt;
 			state = meta.state;
 			return true;
 		}
@@ -44,14 +63,12 @@ namespace sign_messages {
 	struct set_animation_message {
 
 		static constexpr auto type = sign_message_type::SET_ANIMATION;
-		// This assumes that sizeof(sign_animation) is smaller or equal to
-		// the serialized version.  That's not great, not terrible.
-		// Might lead to issues in the future ¯\_(ツ)_/¯.
-		static constexpr usize max_body_size = sizeof(sign_animation);
+		static constexpr usize max_body_size = sign_animation_transcoding::max_encoded_size;
 
-		using data_t = std::tuple<sign_state, sign_animation>;
+		using data_t = std::tuple<sign_state, sign_animation, i64>;
 
 		struct meta_t {
+			i64 applyAt;
 			u16 animationLength;
 			sign_state state;
 			[[nodiscard]] inline u16 body_size() const {
@@ -63,18 +80,16 @@ namespace sign_messages {
 			meta_t& meta,
 			std::span<u8> body,
 			const sign_state &state,
-			const sign_animation &animation
+			const sign_animation &animation,
+			const i64 &applyAt
 		) {
-
-			auto it = body.begin();
-			*it++ = static_cast<u8>(state);
-			sign_animation_transcoding::serialize(animation, it);
-
-			if (it > body.end())
+			const auto length = sign_animation_transcoding::serialize(animation, body);
+			if (not length)
 				return false;
 
-			meta.animationLength = it - 1 - body.begin();
+			meta.animationLength = static_cast<u16>(*length);
 			meta.state = state;
+			meta.applyAt = applyAt;
 
 			return true;
 		}
@@ -83,11 +98,15 @@ namespace sign_messages {
 			const meta_t& meta,
 			std::span<const u8> body,
 			sign_state &state,
-			sign_animation &animation
+			sign_animation &animation,
+			i64 &applyAt
 		) {
 			state = meta.state;
-			auto it = body.begin();
-			return sign_animation_transcoding::deserialize(animation, it);
+			applyAt = meta.applyAt;
+			return (
+				meta.state < sign_state::LAST and
+				sign_animation_transcoding::deserialize(animation, body)
+			);
 		}
 	};
 
@@ -112,13 +131,389 @@ namespace sign_messages {
 			return true;
 		}
 	};
+
+	struct set_params_message {
+
+		static constexpr auto type = sign_message_type::SET_PARAMS;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<sign_animation_params>;
+
+		// The parameters fit into the header, this keeps the
+		// message as cheap as possible when sent at a high rate.
+		struct meta_t {
+			sign_animation_params params;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const sign_animation_params &params) {
+			meta.params = params;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, sign_animation_params &params) {
+			params = meta.params;
+			return true;
+		}
+	};
+
+	// Clock synchronization is a three way exchange: the plugin pings with its reference time,
+	// the sign answers with its receive and send time and the plugin returns the resulting sample.
+
+	struct time_ping_message {
+
+		static constexpr auto type = sign_message_type::TIME_PING;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<i64>;
+
+		struct meta_t {
+			i64 referenceTime;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const i64 &referenceTime) {
+			meta.referenceTime = referenceTime;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, i64 &referenceTime) {
+			referenceTime = meta.referenceTime;
+			return true;
+		}
+	};
+
+	struct time_pong_message {
+
+		static constexpr auto type = sign_message_type::TIME_PONG;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<i64, i64, i64>;
+
+		struct meta_t {
+			i64 referenceTime;
+			i64 receiveTime;
+			i64 sendTime;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(
+			meta_t& meta,
+			std::span<u8>,
+			const i64 &referenceTime,
+			const i64 &receiveTime,
+			const i64 &sendTime
+		) {
+			meta.referenceTime = referenceTime;
+			meta.receiveTime = receiveTime;
+			meta.sendTime = sendTime;
+			return true;
+		}
+
+		inline static bool deserialize(
+			const meta_t& meta,
+			std::span<const u8>,
+			i64 &referenceTime,
+			i64 &receiveTime,
+			i64 &sendTime
+		) {
+			referenceTime = meta.referenceTime;
+			receiveTime = meta.receiveTime;
+			sendTime = meta.sendTime;
+			return true;
+		}
+	};
+
+	struct time_sync_message {
+
+		static constexpr auto type = sign_message_type::TIME_SYNC;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<clock_sample>;
+
+		struct meta_t {
+			clock_sample sample;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const clock_sample &sample) {
+			meta.sample = sample;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, clock_sample &sample) {
+			sample = meta.sample;
+			return true;
+		}
+	};
+
+	// Frame library upload, see 'frame_upload.hpp' for the exchange.
+
+	struct upload_begin_message {
+
+		static constexpr auto type = sign_message_type::UPLOAD_BEGIN;
+		static constexpr usize max_body_size = frame_upload::maxClipsSize;
+
+		using data_t = std::tuple<u32, frame_upload::clip_list>;
+
+		struct meta_t {
+			u32 uploadId;
+			u16 clipsLength;
+			[[nodiscard]] inline u16 body_size() const {
+				return clipsLength;
+			}
+		};
+
+		inline static bool serialize(
+			meta_t& meta,
+			std::span<u8> body,
+			const u32 &uploadId,
+			const frame_upload::clip_list &clips
+		) {
+			const auto length = frame_upload::encodeClips(clips.clips(), body);
+			if (length == 0)
+				return false;
+
+			meta.uploadId = uploadId;
+			meta.clipsLength = static_cast<u16>(length);
+
+			return true;
+		}
+
+		inline static bool deserialize(
+			const meta_t& meta,
+			std::span<const u8> body,
+			u32 &uploadId,
+			frame_upload::clip_list &clips
+		) {
+			uploadId = meta.uploadId;
+			return frame_upload::decodeClips(body, clips);
+		}
+	};
+
+	struct upload_chunk_message {
+
+		static constexpr auto type = sign_message_type::UPLOAD_CHUNK;
+		static constexpr usize max_body_size = frame_upload::maxChunkSize;
+
+		// The data of the received chunk points into the receive buffer
+		// and is only valid until the next message is decrypted.
+		using data_t = std::tuple<frame_upload::chunk>;
+
+		struct meta_t {
+			u16 chunkLength;
+			[[nodiscard]] inline u16 body_size() const {
+				return chunkLength;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8> body, const frame_upload::chunk &chunk) {
+			const auto signedBytes = frame_upload::encodeChunk(chunk, body);
+			if (signedBytes.empty())
+				return false;
+
+			std::copy(chunk.mac.begin(), chunk.mac.end(), body.begin() + signedBytes.size());
+			meta.chunkLength = static_cast<u16>(signedBytes.size() + chunk.mac.size());
+
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t&, std::span<const u8> body, frame_upload::chunk &chunk) {
+			return frame_upload::decodeChunk(body, chunk);
+		}
+	};
+
+	struct upload_commit_message {
+
+		static constexpr auto type = sign_message_type::UPLOAD_COMMIT;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<u32>;
+
+		struct meta_t {
+			u32 uploadId;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const u32 &uploadId) {
+			meta.uploadId = uploadId;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, u32 &uploadId) {
+			uploadId = meta.uploadId;
+			return true;
+		}
+	};
+
+	// Sent by the sign in response to every upload message.
+	struct upload_status_message {
+
+		static constexpr auto type = sign_message_type::UPLOAD_STATUS;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<frame_upload::reply>;
+
+		struct meta_t {
+			frame_upload::reply reply;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const frame_upload::reply &reply) {
+			meta.reply = reply;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, frame_upload::reply &reply) {
+			reply = meta.reply;
+			return reply.state <= frame_upload::status::FAILED;
+		}
+	};
+
+	// Stats of the main task of the sign, queried one state at a time.
+
+	struct state_stats_request_message {
+
+		static constexpr auto type = sign_message_type::STATE_STATS_REQUEST;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<u8>;
+
+		struct meta_t {
+			u8 state;
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8>, const u8 &state) {
+			meta.state = state;
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t& meta, std::span<const u8>, u8 &state) {
+			state = meta.state;
+			return true;
+		}
+	};
+
+	// Sent by the sign in response to a STATE_STATS_REQUEST, 'numStates' is zero if the state does not exist.
+	struct state_stats_message {
+
+		static constexpr auto type = sign_message_type::STATE_STATS;
+		static constexpr usize max_body_size = state_stats::encodedSummarySize;
+
+		using data_t = std::tuple<state_stats::summary>;
+
+		struct meta_t {
+			u16 summaryLength;
+			[[nodiscard]] inline u16 body_size() const {
+				return summaryLength;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8> body, const state_stats::summary &summary) {
+			const auto length = state_stats::encode(summary, body);
+			if (length == 0)
+				return false;
+
+			meta.summaryLength = static_cast<u16>(length);
+
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t&, std::span<const u8> body, state_stats::summary &summary) {
+			if (not state_stats::decode(body, summary))
+				return false;
+
+			return summary.numStates <= state_stats::maxStates and (summary.numStates == 0 or summary.state < summary.numStates);
+		}
+	};
+
+	// Runtime metrics of the sign, queried as a whole.
+
+	struct get_metrics_message {
+
+		static constexpr auto type = sign_message_type::GET_METRICS;
+		static constexpr usize max_body_size = 0U;
+
+		using data_t = std::tuple<>;
+
+		struct meta_t {
+			[[nodiscard]] inline u16 body_size() const {
+				return 0;
+			}
+		};
+
+		inline static bool serialize(meta_t&, std::span<u8>) {
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t&, std::span<const u8>) {
+			return true;
+		}
+	};
+
+	// Sent by the sign in response to GET_METRICS.
+	struct metrics_message {
+
+		static constexpr auto type = sign_message_type::METRICS;
+		static constexpr usize max_body_size = sign_metrics_fields::encodedSize;
+
+		using data_t = std::tuple<sign_metrics>;
+
+		struct meta_t {
+			u16 metricsLength;
+			[[nodiscard]] inline u16 body_size() const {
+				return metricsLength;
+			}
+		};
+
+		inline static bool serialize(meta_t& meta, std::span<u8> body, const sign_metrics &metrics) {
+			const auto length = sign_metrics_fields::encode(metrics, body);
+			if (length == 0)
+				return false;
+
+			meta.metricsLength = static_cast<u16>(length);
+
+			return true;
+		}
+
+		inline static bool deserialize(const meta_t&, std::span<const u8> body, sign_metrics &metrics) {
+			return sign_metrics_fields::decode(body, metrics);
+		}
+	};
 }
 
 using sign_transceiver = aes_transceiver<
 	sign_message_type,
 	sign_messages::change_state_message,
 	sign_messages::set_animation_message,
-	sign_messages::heartbeat_message
+	sign_messages::heartbeat_message,
+	sign_messages::set_params_message,
+	sign_messages::time_ping_message,
+	sign_messages::time_pong_message,
+	sign_messages::time_sync_message,
+	sign_messages::upload_begin_message,
+	sign_messages::upload_chunk_message,
+	sign_messages::upload_commit_message,
+	sign_messages::upload_status_message,
+	sign_messages::state_stats_request_message,
+	sign_messages::state_stats_message,
+	sign_messages::get_metrics_message,
+	sign_messages::metrics_message
 >;
 
 using sign_header = sign_transceiver::header_t;
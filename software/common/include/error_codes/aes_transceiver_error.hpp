@@ -8,7 +8,8 @@ namespace aes_transceiver_error {
 		INVALID_MESSAGE_TYPE,
 		INVALID_MESSAGE_SIZE,
 		SERIALIZATION_ERROR,
-		DESERIALIZATION_ERROR
+		DESERIALIZATION_ERROR,
+		UNEXPECTED_MESSAGE
 	};
 
 	struct category : std::error_category {
@@ -26,6 +27,8 @@ namespace aes_transceiver_error {
 				return "The serialization function returned an error";
 			case DESERIALIZATION_ERROR:
 				return "The deserialization function returned an error";
+			case UNEXPECTED_MESSAGE:
+				return "Received a message that does not answer the pending request";
 			default:
 				return "(unrecognized error)";
 			}
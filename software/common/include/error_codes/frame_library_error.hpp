@@ -0,0 +1,54 @@
+#pragma once
+
+#include <system_error>
+
+namespace frame_library_error {
+	enum class codes {
+		OK,
+		LIBRARY_TOO_LARGE,
+		INVALID_CLIP,
+		CHUNK_OUT_OF_RANGE,
+		NOT_STARTED,
+		INVALID_LIBRARY,
+		UPLOAD_REJECTED
+	};
+
+	struct category : std::error_category {
+		[[nodiscard]] const char* name() const noexcept override {
+			return "frame_library";
+		}
+		[[nodiscard]] std::string message(int ev) const override {
+			switch (static_cast<codes>(ev)) {
+				using enum codes;
+			case LIBRARY_TOO_LARGE:
+				return "The library does not fit into the storage";
+			case INVALID_CLIP:
+				return "A clip has no frames or no pixels";
+			case CHUNK_OUT_OF_RANGE:
+				return "The chunk lies outside of the frame data";
+			case NOT_STARTED:
+				return "No library upload is in progress";
+			case INVALID_LIBRARY:
+				return "The storage does not contain a valid library";
+			case UPLOAD_REJECTED:
+				return "The sign did not accept the upload";
+			default:
+				return "(unrecognized error)";
+			}
+		}
+	};
+}
+
+inline frame_library_error::category& frame_library_category() {
+	static frame_library_error::category cat;
+	return cat;
+}
+
+namespace frame_library_error {
+	inline std::error_code make_error_code(codes e) {
+		return { static_cast<int>(e), frame_library_category() };
+	}
+}
+
+template <>
+struct std::is_error_code_enum<frame_library_error::codes> : public std::true_type {};
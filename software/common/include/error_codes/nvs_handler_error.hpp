@@ -0,0 +1,60 @@
+#pragma once
+
+#include <system_error>
+
+namespace nvs_handler_error {
+	enum class codes {
+		OK,
+		NOT_OPEN,
+		NOT_FOUND,
+		TYPE_MISMATCH,
+		INVALID_NAME,
+		INVALID_LENGTH,
+		VALUE_TOO_LONG,
+		INVALID_VERSION,
+		SERIALIZATION_FAILED
+	};
+
+	struct category : std::error_category {
+		[[nodiscard]] const char* name() const noexcept override {
+			return "nvs_handler";
+		}
+		[[nodiscard]] std::string message(int ev) const override {
+			switch (static_cast<codes>(ev)) {
+				using enum codes;
+			case NOT_OPEN:
+				return "The storage has not been opened";
+			case NOT_FOUND:
+				return "No value is stored under the key";
+			case TYPE_MISMATCH:
+				return "The stored value has a different type";
+			case INVALID_NAME:
+				return "The key is too long";
+			case INVALID_LENGTH:
+				return "The buffer is too small for the stored value";
+			case VALUE_TOO_LONG:
+				return "The stored value is larger than its type allows";
+			case INVALID_VERSION:
+				return "The stored value could not be deserialized";
+			case SERIALIZATION_FAILED:
+				return "The value could not be serialized";
+			default:
+				return "(unrecognized error)";
+			}
+		}
+	};
+}
+
+inline nvs_handler_error::category& nvs_handler_category() {
+	static nvs_handler_error::category cat;
+	return cat;
+}
+
+namespace nvs_handler_error {
+	inline std::error_code make_error_code(codes e) {
+		return { static_cast<int>(e), nvs_handler_category() };
+	}
+}
+
+template <>
+struct std::is_error_code_enum<nvs_handler_error::codes> : public std::true_type {};
@@ -7,6 +7,7 @@
 #include "animations/moving_colors.hpp"
 #include "animations/moving_pixel.hpp"
 #include "animations/stop_motion.hpp"
+#include "animations/library_stop_motion.hpp"
 
 using namespace ztu::uix;
 
@@ -15,7 +16,8 @@ using animation = std::variant<
 	typename animations_t::uniform_color,
 	typename animations_t::moving_colors,
 	typename animations_t::moving_pixel,
-	typename animations_t::stop_motion
+	typename animations_t::stop_motion,
+	typename animations_t::library_stop_motion
 >;
 
 template<class animations_t>
@@ -52,15 +54,17 @@ struct variable_speed_animation {
 
 	animation_t animator;
 	i8 speed{ 1 };
+	u32 seed{ 0 };		// salt of the random suppliers and scalers, zero lets every sign pick its own
 };
 
-template<u32 TicksPerColor, u32 NumPixels, u32 NumFrames, class color_sequencer_t, class temporal_scaler_t>
+template<u32 TicksPerColor, u32 StopMotionPixels, u32 StopMotionFrames, class color_sequencer_t, class temporal_scaler_t>
 struct animations {
 	static constexpr auto ticksPerColor = TicksPerColor;
-	static constexpr auto numPixels = NumPixels;
-	static constexpr auto numFrames = NumFrames;
+	static constexpr auto stopMotionPixels = StopMotionPixels;
+	static constexpr auto stopMotionFrames = StopMotionFrames;
 	using uniform_color = animation_detail::uniform_color<color_sequencer_t>;
 	using moving_colors = animation_detail::moving_colors<color_sequencer_t>;
 	using moving_pixel = animation_detail::moving_pixel<color_sequencer_t, temporal_scaler_t>;
-	using stop_motion = animation_detail::stop_motion<TicksPerColor, NumPixels, NumFrames>;
+	using stop_motion = animation_detail::stop_motion<TicksPerColor, StopMotionPixels, StopMotionFrames>;
+	using library_stop_motion = animation_detail::library_stop_motion;
 };
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <util/uix.hpp>
+
+using namespace ztu::uix;
+
+// Live modulation applied on top of the running animation.
+// Kept at 4 bytes so it can be swapped atomically and fits into a message header.
+struct animation_params {
+	static constexpr u16 unitSpeed = 256;
+
+	u8 brightness{ U8_MAX };	// 0 = off, 255 = unmodified
+	u8 hueShift{ 0 };			// rotation of the color wheel in 1/256 turns
+	u16 speed{ unitSpeed };		// 8.8 fixed point multiplier of the animation speed
+
+	constexpr bool operator==(const animation_params&) const = default;
+};
+
+static_assert(sizeof(animation_params) == 4);
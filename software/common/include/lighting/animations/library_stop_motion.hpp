@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../frame_library.hpp"
+#include <util/uix.hpp>
+#include <span>
+#include <algorithm>
+
+
+namespace animation_detail {
+
+	/**
+	 * @brief Plays a clip of the active frame library without copying it into ram.
+	 * Shows black if no library is available or the clip does not exist.
+	 */
+	struct library_stop_motion {
+
+		constexpr library_stop_motion() = default;
+
+		constexpr library_stop_motion(u16 newClipIndex, u16 newTicksPerFrame)
+			: clipIndex{ newClipIndex }, ticksPerFrame{ newTicksPerFrame } {}
+
+		void init(u32) {}
+
+		void operator()(std::span<color> dst, const u32 t) {
+			(*this)(dst, t, 0, dst.size());
+		}
+
+		void operator()(std::span<color> dst, const u32 t, const usize firstPixel, const usize) {
+			const auto library = frame_library::active();
+			const auto clip = library ? library->clip(clipIndex) : std::nullopt;
+
+			if (not clip) {
+				std::fill(dst.begin(), dst.end(), colors::black);
+				return;
+			}
+
+			const auto frameIndex = (t / std::max<u32>(ticksPerFrame, 1)) % clip->numFrames;
+			clip->render(frameIndex, dst, firstPixel);
+		}
+
+		constexpr bool operator==(const library_stop_motion &other) const = default;
+
+		u16 clipIndex{ 0 };
+		u16 ticksPerFrame{ 1 };
+	};
+
+}
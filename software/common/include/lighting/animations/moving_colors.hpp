@@ -21,14 +21,18 @@ namespace animation_detail {
 			perPixelOffset{ newPerPixelOffset },
 			pixelOffset{ newPixelOffset } {}
 
-		void init() {
-			sequencer.init();
+		void init(u32 seed) {
+			sequencer.init(seed);
 		}
 
 		void operator()(std::span<color> dst, const u32 t) {
+			(*this)(dst, t, 0, dst.size());
+		}
+
+		void operator()(std::span<color> dst, const u32 t, const usize firstPixel, const usize) {
 			auto t_local = static_cast<i32>(pixelOffset * perPixelOffset);
 			for (isize i = 0, n = dst.size(); i < n; i++) {
-				const auto t_pixel = static_cast<int>(i * perPixelOffset);
+				const auto t_pixel = static_cast<int>((static_cast<isize>(firstPixel) + i) * perPixelOffset);
 				dst[i] = sequencer(t - std::abs(t_pixel - t_local));
 			}
 		}
@@ -5,6 +5,8 @@
 #include "../color_mixing.hpp"
 
 #include <util/variant_visit.hpp>
+#include <util/hash_u32.hpp>
+#include <algorithm>
 
 namespace animation_detail {
 
@@ -25,35 +27,51 @@ namespace animation_detail {
 			width{ newWidth } {}
 		
 
-		void init() {
-			sequencer.init();
-			ztu::visit([](auto &theScaler) {
-				theScaler.init();
+		void init(u32 seed) {
+			sequencer.init(seed);
+			// hashed, so random colors do not move in step with random positions
+			ztu::visit([&](auto &theScaler) {
+				theScaler.init(ztu::hash_u32(seed));
 			}, scaler);
 		}
 
 		void operator()(std::span<color> dst, const u32 t) {
+			(*this)(dst, t, 0, dst.size());
+		}
+
+		/**
+		 * @brief Renders the pixels of a strip of 'numPixels' pixels that start at 'firstPixel' into dst,
+		 * the pixel travels along the whole strip no matter how it is split up.
+		 */
+		void operator()(std::span<color> dst, const u32 t, const usize firstPixel, const usize numPixels) {
 		
+			const auto travel = numPixels > width ? static_cast<float>(numPixels - width) - std::numeric_limits<float>::epsilon() : 0.0f;
+
 			auto offset = 0.0f;
 			ztu::visit([&](auto &scale) {
-				offset = (static_cast<float>(dst.size() - width) - std::numeric_limits<float>::epsilon()) * scale(static_cast<u32>(t));
+				offset = travel * scale(static_cast<u32>(t));
 			}, scaler);
 			
-			const auto minPixel = static_cast<u32>(std::floor(offset));
-			const auto maxPixel = minPixel + width;
+			const auto minPixel = static_cast<usize>(std::floor(offset));
+			const auto maxPixel = minPixel + std::max<usize>(width, 1);
 			float a = offset - minPixel;
 
 			const auto c = sequencer(static_cast<u32>(std::round(colorSpeed * t)));
 
 			constexpr auto colorLerp = &color_mixing::mix<color_mixing::type::LINEAR_INTERPOLATION>;
 
-			auto i = 0U;
-			while (i < minPixel)	dst[i++] = colors::black;
-									dst[i++] = colorLerp(c, colors::black, a);
-			while (i < maxPixel)	dst[i++] = c;
-									dst[i++] = colorLerp(colors::black, c, a);
-			while (i < dst.size())	dst[i++] = colors::black;
-
+			const auto lastPixel = firstPixel + dst.size();
+			const auto fillRange = [&](usize from, usize to, const color &value) {
+				from = std::clamp(from, firstPixel, lastPixel);
+				to = std::clamp(to, from, lastPixel);
+				std::fill(dst.begin() + (from - firstPixel), dst.begin() + (to - firstPixel), value);
+			};
+
+			fillRange(firstPixel,	minPixel,		colors::black);
+			fillRange(minPixel,		minPixel + 1,	colorLerp(c, colors::black, a));
+			fillRange(minPixel + 1,	maxPixel,		c);
+			fillRange(maxPixel,		maxPixel + 1,	colorLerp(colors::black, c, a));
+			fillRange(maxPixel + 1,	lastPixel,		colors::black);
 		}
 
 
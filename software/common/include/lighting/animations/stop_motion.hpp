@@ -26,16 +26,25 @@ namespace animation_detail {
 			std::copy(newFrames.begin(), newFrames.end(), m_frames.begin());
 		}
 
-		void init() {}
+		void init(u32) {}
 
 		void operator()(std::span<color> dst, const u32 t) {
-			assert(numFrames > 0 && numFrames <= MaxFrames);
+			(*this)(dst, t, 0, dst.size());
+		}
+
+		// the frame repeats along the strip, so a part of it starts wherever 'firstPixel' falls into the frame
+		void operator()(std::span<color> dst, const u32 t, const usize firstPixel, const usize) {
+			assert(numFrames > 0 && numFrames <= NumPixels * MaxFrames);
 
-			const auto frameIndex = (t % TicksPerColor) / numFrames;
+			// 'numFrames' counts colors, the frames they make up share one color period
+			const auto frameCount = numFrames / NumPixels;
+			const auto frameIndex = (t % TicksPerColor) * frameCount / TicksPerColor;
 			const auto frame = &m_frames[frameIndex * NumPixels];
 
-			for (isize i = 0, n = dst.size(); i < n; i++) {
-				dst[i] = frame[i % NumPixels];
+			auto pixel = dst.begin();
+			for (auto p = firstPixel % NumPixels; pixel != dst.end(); p = 0) {
+				const auto run = std::min<usize>(NumPixels - p, dst.end() - pixel);
+				pixel = std::copy_n(frame + p, run, pixel);
 			}
 		}
 
@@ -12,14 +12,18 @@ namespace animation_detail {
 		constexpr uniform_color(const color_sequencer_t &newSequencer)
 			: sequencer{ newSequencer } {}
 
-		void init() {
-			sequencer.init();
+		void init(u32 seed) {
+			sequencer.init(seed);
 		}
 
 		void operator()(std::span<color> dst, const u32 t) {
 			std::fill(dst.begin(), dst.end(), sequencer(t));
 		}
 
+		void operator()(std::span<color> dst, const u32 t, const usize, const usize) {
+			(*this)(dst, t);
+		}
+
 		constexpr bool operator==(const uniform_color<color_sequencer_t> &other) const = default;
 		
 		color_sequencer_t sequencer;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <lighting/color.hpp>
+#include <lighting/animation_params.hpp>
+#include <array>
+#include <span>
+
+// Applies brightness and hue rotation to a rendered frame.
+// The transform is folded into a single fixed point matrix when the
+// parameters change, so applying it costs a few multiplications per pixel.
+class color_modulator {
+public:
+	constexpr color_modulator() = default;
+
+	explicit color_modulator(const animation_params &params);
+
+	void operator()(std::span<color> colors) const;
+
+	[[nodiscard]] constexpr bool identity() const {
+		return m_mode == mode::IDENTITY;
+	}
+
+private:
+	static constexpr auto fractionBits = 12;
+
+	enum class mode : u8 {
+		IDENTITY,
+		SCALE,
+		MATRIX
+	};
+
+	mode m_mode{ mode::IDENTITY };
+	std::array<i32, 9> m_matrix{};
+};
+
+#define INCLUDE_COLOR_MODULATOR_IMPLEMENTATION
+#include <lighting/color_modulator.ipp>
+#undef INCLUDE_COLOR_MODULATOR_IMPLEMENTATION
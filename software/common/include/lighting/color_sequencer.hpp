@@ -11,9 +11,9 @@
 template<usize TicksPerColor, class color_supplier_t>
 struct color_sequencer {
 
-	void init() {
-		ztu::visit([](auto &theSupplier) {
-			theSupplier.init();
+	void init(u32 seed) {
+		ztu::visit([&](auto &theSupplier) {
+			theSupplier.init(seed);
 		}, supplier);
 	}
 
@@ -21,7 +21,7 @@ struct color_sequencer {
 		const auto t_color = t / TicksPerColor;
 		const auto t_mix = t - t_color * TicksPerColor;
 
-		color a, b;
+		color a{}, b{};
 
 		ztu::visit([&](auto &supply) {
 			a = supply(t_color);
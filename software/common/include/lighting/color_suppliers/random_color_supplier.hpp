@@ -3,7 +3,6 @@
 #include <util/uix.hpp>
 #include <util/hash_u32.hpp>
 #include "../color.hpp"
-#include <fill_random.hpp>
 
 namespace color_suppliers_detail {
 
@@ -13,9 +12,8 @@ namespace color_suppliers_detail {
 
 		constexpr random_color_supplier() = default;
 
-		void init() {
-			const auto begin = reinterpret_cast<u8*>(&salt); 
-			fill_random({ begin, begin + sizeof(salt) });
+		void init(u32 seed) {
+			salt = seed;
 		}
 
 		color operator()(const u32 t) {
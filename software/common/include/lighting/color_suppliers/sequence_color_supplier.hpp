@@ -26,7 +26,7 @@ namespace color_suppliers_detail {
 			numColors = newColors.size();
 		}
 
-		void init() {}
+		void init(u32) {}
 
 		color operator()(u32 index) {
 			return m_colors[index % numColors];
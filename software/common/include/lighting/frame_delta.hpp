@@ -0,0 +1,56 @@
+#pragma once
+
+#include "color.hpp"
+#include <util/uix.hpp>
+#include <span>
+
+using namespace ztu::uix;
+
+// Frames sent to the live preview of the config website, each one either complete or
+// as difference to the previous one. A delta lists the runs of pixels that changed,
+// runs that are one unchanged pixel apart are merged, as a new run costs more than the pixel.
+//
+// Layout (little endian):
+//   header
+//   KEY     numPixels * rgb
+//   DELTA   runs until the end of the message, each one
+//             u16 skip    unchanged pixels since the end of the previous run
+//             u16 count
+//             count * rgb
+
+namespace frame_delta {
+
+	enum class kind : u8 {
+		KEY = 0,
+		DELTA = 1
+	};
+
+	inline constexpr usize color_size = 3;
+	inline constexpr usize header_size = 4;
+	inline constexpr usize run_header_size = 4;
+
+	[[nodiscard]] constexpr usize max_encoded_size(usize numPixels) {
+		return header_size + numPixels * color_size;
+	}
+
+	/**
+	 * @brief Encodes 'current' as delta to 'previous' or as key frame if that is smaller
+	 * or 'previous' is empty.
+	 *
+	 * @param dst Has to hold at least 'max_encoded_size(current.size())' bytes.
+	 * @return Number of bytes written.
+	 */
+	[[nodiscard]] usize encode(std::span<const color> previous, std::span<const color> current, std::span<u8> dst);
+
+	/**
+	 * @brief Applies an encoded frame to 'frame', which has to hold the previous frame for deltas.
+	 *
+	 * @return false if the message is malformed or has a different number of pixels,
+	 * 'frame' may be partially updated in that case.
+	 */
+	[[nodiscard]] bool decode(std::span<const u8> src, std::span<color> frame);
+}
+
+#define INCLUDE_FRAME_DELTA_IMPLEMENTATION
+#include <lighting/frame_delta.ipp>
+#undef INCLUDE_FRAME_DELTA_IMPLEMENTATION
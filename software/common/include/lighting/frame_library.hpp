@@ -0,0 +1,144 @@
+#pragma once
+
+#include "color.hpp"
+#include <concepts/frame_storage_concept.hpp>
+#include <error_codes/frame_library_error.hpp>
+#include <util/uix.hpp>
+#include <atomic>
+#include <optional>
+#include <span>
+#include <system_error>
+
+using namespace ztu::uix;
+
+// A frame library is a read only collection of long frame sequences ("clips") in memory mapped flash.
+//
+// Layout (little endian):
+//   header
+//   clip table   numClips * clip_entry
+//   frame data   rgb bytes, the frames of a clip are stored back to back
+//
+// The header is written last, so an interrupted upload never leaves a valid looking library behind.
+
+namespace frame_library_format {
+
+	inline constexpr u32 magic = 0x4c53534f; // "OSSL"
+	inline constexpr u16 version = 1;
+
+	inline constexpr usize color_size = 3;
+
+	struct header {
+		u32 magic;
+		u16 version;
+		u16 numClips;
+		u32 dataSize;
+	};
+	static_assert(sizeof(header) == 12);
+
+	struct clip_entry {
+		u32 offset;
+		u32 numFrames;
+		u16 numPixels;
+		u16 reserved;
+	};
+	static_assert(sizeof(clip_entry) == 12);
+}
+
+/**
+ * @brief View of a single clip inside the mapped library.
+ */
+struct frame_clip {
+	std::span<const u8> data;
+	u32 numFrames;
+	u16 numPixels;
+
+	/**
+	 * @brief Copies the frame straight from the mapped memory into dst,
+	 * the clip is repeated if dst has more pixels than the clip.
+	 * 'firstPixel' is the position of dst on the strip, for strips that are rendered in parts.
+	 */
+	void render(u32 frameIndex, std::span<color> dst, usize firstPixel = 0) const;
+};
+
+class frame_library {
+public:
+	constexpr frame_library() = default;
+
+	/**
+	 * @brief Validates the library in the given region.
+	 *
+	 * @return std::nullopt if the region does not contain a complete library.
+	 */
+	[[nodiscard]] static std::optional<frame_library> open(std::span<const u8> region);
+
+	[[nodiscard]] usize size() const;
+
+	[[nodiscard]] std::optional<frame_clip> clip(usize index) const;
+
+	/**
+	 * @brief Frame data of all clips, as passed to 'frame_library_writer::write'.
+	 */
+	[[nodiscard]] std::span<const u8> data() const;
+
+	/**
+	 * @brief Library used by animations that play clips, nullptr if none is available.
+	 */
+	[[nodiscard]] static const frame_library* active();
+
+	static void activate(const frame_library *library);
+
+private:
+	std::span<const u8> clipTable;
+	std::span<const u8> frameData;
+
+	inline static std::atomic<const frame_library*> activeLibrary{ nullptr };
+};
+
+struct frame_clip_info {
+	u32 numFrames;
+	u16 numPixels;
+};
+
+/**
+ * @brief Writes a library in chunks.
+ *
+ * 'begin' invalidates the previous library and writes the clip table, the frame data can then be written in any order.
+ * 'finish' writes the header which makes the library valid.
+ *
+ * Erasing a whole flash partition takes seconds, so blocks are only erased right before the first write to them.
+ */
+template<frame_storage_concept storage_t>
+class frame_library_writer {
+public:
+	explicit frame_library_writer(storage_t &newStorage);
+
+	/**
+	 * @brief Checks the clips without touching the storage, 'begin' rejects the same clips.
+	 */
+	[[nodiscard]] std::error_code check(std::span<const frame_clip_info> clips) const;
+
+	[[nodiscard]] std::error_code begin(std::span<const frame_clip_info> clips);
+
+	/**
+	 * @param offset Offset into the frame data, the clips are stored back to back in the order passed to 'begin'.
+	 */
+	[[nodiscard]] std::error_code write(usize offset, std::span<const u8> chunk);
+
+	[[nodiscard]] std::error_code finish();
+
+	[[nodiscard]] usize dataSize() const;
+
+private:
+	[[nodiscard]] std::error_code eraseUntil(usize end);
+
+	storage_t &storage;
+	usize dataOffset{ 0 };
+	usize erasedUntil{ 0 };
+	u32 numDataBytes{ 0 };
+	u16 numClips{ 0 };
+	bool started{ false };
+};
+
+#define INCLUDE_FRAME_LIBRARY_IMPLEMENTATION
+#include <lighting/frame_library.ipp>
+#undef INCLUDE_FRAME_LIBRARY_IMPLEMENTATION
@@ -11,7 +11,7 @@ namespace temporal_scalers_detail {
 	public:
 		constexpr ping_pong_scaler() = default;
 
-		void init() {}
+		void init(u32) {}
 
 		float operator()(u32 t) {
 			const auto a = static_cast<float>(t % TicksPerColor) / static_cast<float>(TicksPerColor);
@@ -2,7 +2,6 @@
 
 #include <util/uix.hpp>
 #include <util/hash_u32.hpp>
-#include <fill_random.hpp>
 
 namespace temporal_scalers_detail {
 
@@ -12,9 +11,8 @@ namespace temporal_scalers_detail {
 	public:
 		constexpr random_scaler() = default;
 
-		void init() {
-			const auto begin = reinterpret_cast<u8*>(&salt); 
-			fill_random({ begin, begin + sizeof(salt) });
+		void init(u32 seed) {
+			salt = seed;
 		}
 
 		float operator()(u32 t) {
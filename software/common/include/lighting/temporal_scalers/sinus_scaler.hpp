@@ -12,7 +12,7 @@ namespace temporal_scalers_detail {
 	public:
 		constexpr sinus_scaler() = default;
 
-		void init() {}
+		void init(u32) {}
 
 		float operator()(u32 t) {
 			constexpr auto TWO_PI = 2.0f * std::numbers::pi_v<float>; 
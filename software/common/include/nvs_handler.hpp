@@ -0,0 +1,467 @@
+#pragma once
+
+// I'm sorry, I swear this seemed like a good idea an hour ago...
+
+#include <concepts/nvs_backend_concept.hpp>
+#include <error_codes/nvs_handler_error.hpp>
+
+#include <type_traits>
+#include <concepts>
+#include <array>
+#include <algorithm>
+#include <bitset>
+#include <mutex>
+#include <tuple>
+#include <util/string_literal.hpp>
+#include <util/for_each.hpp>
+#include <util/pack.hpp>
+#include <optional>
+#include <span>
+#include <util/function.hpp>
+#include <util/uix.hpp>
+#include <system_error>
+
+using namespace ztu::uix;
+
+namespace detail {
+	template<typename T>
+	concept enum_t = std::is_enum_v<T> && std::is_unsigned_v<std::underlying_type_t<T>>;
+
+	template<typename T>
+	concept default_constructable = std::is_default_constructible_v<T>;
+
+	template<enum_t auto EnumValue, typename T, auto GetValue>
+		requires (ztu::supplier<decltype(GetValue), T>)
+	struct type_descriptor_t {
+		static constexpr auto enumValue = EnumValue;
+		using type = T;
+		inline static const T getValue() {
+			return GetValue();
+		} 
+	};
+}
+
+template<detail::enum_t auto Key, class TypeDesc>
+struct nvs_entry {
+	using keyType = decltype(Key);
+	static constexpr auto key = Key;
+	using typeDesc = TypeDesc;
+};
+
+namespace detail {
+	template<size_t I, class T>
+	struct indexed : public T {
+		static constexpr auto index = I;
+	};
+	
+	template<enum_t auto EnumValue, size_t Index, nvs_entry... Entries>
+	struct find_nvs_entry {
+		using type = void;
+	};
+
+	template<enum_t auto EnumValue, size_t Index, nvs_entry First, nvs_entry... Rest>
+	struct find_nvs_entry<EnumValue, Index, First, Rest...> : public std::conditional<
+		EnumValue == decltype(First)::key,
+		indexed<Index, decltype(First)>,
+		typename find_nvs_entry<EnumValue, Index + 1, Rest...>::type
+	> {};
+
+	template<enum_t auto EnumValue, nvs_entry... Entries>
+	using find_nvs_entry_t = typename find_nvs_entry<EnumValue, 0, Entries...>::type;
+
+
+	template<std::unsigned_integral... Is>
+	constexpr bool is_unique_sequence(const Is... integers) {
+		std::array<size_t, sizeof...(Is)> data{ integers... };
+		std::sort(data.begin(), data.end());
+		return std::adjacent_find(data.begin(), data.end()) == data.end();
+	}
+	
+	constexpr auto numDigits(std::unsigned_integral auto n, std::unsigned_integral auto base = 10U) {
+		if (n < base) return 1U;
+		auto digits = 0U;
+		while (n > 0) {
+			n /= base;
+			digits++;
+		}
+		return digits;
+	}
+
+	template<std::unsigned_integral auto N, std::unsigned_integral auto B>
+	constexpr auto intToString() {
+		constexpr auto length = numDigits(N, B);
+		std::array<char, length + 1> str;
+		auto it = str.rbegin();
+		*it++ = '\0';
+		auto num = N;
+		do {
+			*it++ = (char) ('0' + num % B);
+			num /= B;
+		} while (it != str.rend());
+		return str;
+	}
+
+	template<std::unsigned_integral auto... Is>
+	constexpr auto createUniqueKeys(std::index_sequence<Is...>) {
+		constexpr auto base = unsigned('~') - unsigned('0') + 1U;
+		return std::tuple( intToString<Is, base>()... );
+	}
+};
+
+/**
+ * @brief Typed, cached access to a key value store.
+ *
+ * The store itself is a policy, 'esp_nvs_backend' on the sign and 'file_nvs_backend'
+ * on the host, so caching and commit behaviour can be exercised without the hardware.
+ */
+template<nvs_backend_concept backend_t, nvs_entry... Entries>
+	requires (
+		detail::is_unique_sequence(
+			static_cast<
+				std::underlying_type_t<typename decltype(Entries)::keyType>
+			>(Entries.key)...
+		)
+	)
+class nvs_handler {
+
+private:
+	template<detail::enum_t auto EnumValue>
+	using getEntry = typename detail::find_nvs_entry_t<EnumValue, Entries...>;
+
+	template<detail::enum_t auto EnumValue>
+	using getType = typename getEntry<EnumValue>::typeDesc::type;
+
+	template<size_t Index>
+	using getDesc = typename ztu::at<Index, decltype(Entries)...>::typeDesc;
+
+	static constexpr auto numEntries = sizeof...(Entries);
+
+public:
+	nvs_handler() = default;
+
+	/**
+	 * @brief Opens the namespace, entries are loaded into ram when they are first accessed.
+	 */
+	bool open(const char *name) {
+		return not backend.open(name);
+	}
+
+	/**
+	 * @brief Updates the cached value and schedules a commit.
+	 *
+	 * Consecutive changes are written together once 'commitDelayMicros' passed,
+	 * unchanged values are not written at all. Use 'save' to write immediately.
+	 * If the commit cannot be scheduled the changes are written right away,
+	 * 'wroteData' is false if that fails.
+	 */
+	template<detail::enum_t auto EnumValue>
+	void set(const getType<EnumValue>& value, bool& wroteData = ignoreSuccess) {
+		using entry = getEntry<EnumValue>;
+
+		const auto lock = std::lock_guard{ mutex };
+
+		load<entry::index>();
+
+		auto &cached = std::get<entry::index>(values);
+		wroteData = true;
+
+		if (stored[entry::index] and not dirty[entry::index] and cached == value)
+			return;
+
+		cached = value;
+		dirty.set(entry::index);
+
+		if (not commitScheduled) {
+			commitScheduled = backend.schedule_commit(
+				commitDelayMicros,
+				[](void *arg) {
+					static_cast<nvs_handler*>(arg)->save();
+				},
+				this
+			);
+			if (not commitScheduled) {
+				wroteData = not saveLocked();
+			}
+		}
+	}
+
+	/**
+	 * @brief Returns the cached value, 'readData' is false if the default value is returned.
+	 */
+	template<detail::enum_t auto EnumValue>
+	auto get(bool& readData = ignoreSuccess) {
+		using entry = getEntry<EnumValue>;
+
+		const auto lock = std::lock_guard{ mutex };
+
+		load<entry::index>();
+
+		readData = stored[entry::index] or dirty[entry::index];
+		return std::get<entry::index>(values);
+	}
+
+	/**
+	 * @brief Writes all changed entries and commits them.
+	 *
+	 * @return The first error that occurred, entries that failed stay dirty.
+	 */
+	std::error_code save() {
+		const auto lock = std::lock_guard{ mutex };
+		return saveLocked();
+	}
+
+	/**
+	 * @brief Access to the store, e.g. for its statistics on the host.
+	 */
+	backend_t& get_backend() {
+		return backend;
+	}
+
+	/**
+	 * @brief Saves the entries still waiting for their commit, they would be lost otherwise.
+	 */
+	~nvs_handler() {
+		const auto lock = std::lock_guard{ mutex };
+		if (dirty.any()) {
+			saveLocked();
+		}
+		backend.cancel_commit();
+	}
+
+private:
+	std::error_code saveLocked() {
+		if (commitScheduled) {
+			backend.cancel_commit();
+			commitScheduled = false;
+		}
+
+		if (dirty.none())
+			return {};
+
+		std::error_code result{};
+
+		ztu::for_each::index<numEntries>([&]<auto Index>() {
+			if (dirty[Index]) {
+				constexpr auto &key = std::get<Index>(keys);
+				const auto e = getDesc<Index>::store(backend, key.data(), std::get<Index>(values));
+				if (not e) {
+					dirty.reset(Index);
+					stored.set(Index);
+				} else if (not result) {
+					result = e;
+				}
+			}
+			return false;
+		});
+
+		if (const auto e = backend.commit(); e and not result) {
+			result = e;
+		}
+
+		return result;
+	}
+
+	template<size_t Index>
+	void load() {
+		if (loaded[Index])
+			return;
+
+		using desc = getDesc<Index>;
+		constexpr auto &key = std::get<Index>(keys);
+		auto &value = std::get<Index>(values);
+		stored[Index] = not desc::retrieve(backend, key.data(), value);
+		if (not stored[Index]) {
+			value = desc::getValue();
+		}
+		loaded.set(Index);
+	}
+
+	static constexpr i64 commitDelayMicros = 2'000'000;
+	inline static bool ignoreSuccess = false;
+	static constexpr auto keys = detail::createUniqueKeys(
+		std::make_index_sequence<numEntries>()
+	);
+
+	backend_t backend{};
+
+	std::mutex mutex;
+	std::tuple<typename decltype(Entries)::typeDesc::type...> values{};
+	std::bitset<numEntries> loaded{}, stored{}, dirty{};
+	bool commitScheduled{ false };
+};
+
+namespace default_types {
+
+	enum class default_type_enum : uint8_t {
+		U8, I8,
+		U16, I16,
+		U32, I32,
+		U64, I64,
+		STRING,
+		ARRAY,
+		OBJECT,
+		TRANSCODED
+	};
+	using enum default_type_enum;
+
+	template<
+		default_type_enum EnumValue,
+		std::integral T,
+		auto GetValue
+	>
+	struct basic_default_descriptor : public detail::type_descriptor_t<EnumValue, T, GetValue> {
+		template<nvs_backend_concept backend_t>
+		static std::error_code retrieve(backend_t &backend, const char *key, T &dst) {
+			return backend.get_int(key, dst);
+		}
+		template<nvs_backend_concept backend_t>
+		static std::error_code store(backend_t &backend, const char *key, const T &src) {
+			return backend.set_int(key, src);
+		}
+	};
+	
+	template<auto GetValue>
+	using u8_t = basic_default_descriptor<U8, u8, GetValue>;
+	template<auto GetValue>
+	using i8_t = basic_default_descriptor<I8, i8, GetValue>;
+
+	template<auto GetValue>
+	using u16_t = basic_default_descriptor<U16, u16, GetValue>;
+	template<auto GetValue>
+	using i16_t = basic_default_descriptor<I16, i16, GetValue>;
+
+	template<auto GetValue>
+	using u32_t = basic_default_descriptor<U32, u32, GetValue>;
+	template<auto GetValue>
+	using i32_t = basic_default_descriptor<I32, i32, GetValue>;
+
+	template<auto GetValue>
+	using u64_t = basic_default_descriptor<U64, u64, GetValue>;
+	template<auto GetValue>
+	using i64_t = basic_default_descriptor<I64, i64, GetValue>;
+
+	template<size_t MaxSize, auto GetValue>
+	struct string_t : public detail::type_descriptor_t<STRING, ztu::string_literal<MaxSize + 1>, GetValue> {
+		using type = ztu::string_literal<MaxSize + 1>;
+		template<nvs_backend_concept backend_t>
+		static std::error_code retrieve(backend_t &backend, const char *key, type &dst) {
+			usize size;
+			if (const auto e = backend.get_str(key, nullptr, size); e)
+				return e;
+
+			if (size > type::max_size)
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::VALUE_TOO_LONG);
+
+			dst.resize(size);
+			if (const auto e = backend.get_str(key, dst.begin(), size); e)
+				return e;
+
+			return {};
+		}
+
+		template<nvs_backend_concept backend_t>
+		static std::error_code store(backend_t &backend, const char *key, const type &src) {
+			return backend.set_str(key, src.c_str());
+		}
+	};
+
+	template<typename T, size_t MaxElements, auto GetValue>
+	struct array_t : public detail::type_descriptor_t<ARRAY, std::array<T, MaxElements>, GetValue>  {
+		using type = std::array<T, MaxElements>;
+		static constexpr auto numBytes = MaxElements * sizeof(T);
+		template<nvs_backend_concept backend_t>
+		static std::error_code retrieve(backend_t &backend, const char *key, type &dst) {
+			usize size;
+			if (const auto e = backend.get_blob(key, nullptr, size); e)
+				return e;
+
+			if (size > dst.size())
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::VALUE_TOO_LONG);
+			
+			if (const auto e = backend.get_blob(key, dst.data(), size); e)
+				return e;
+
+			return {};
+		}
+
+		template<nvs_backend_concept backend_t>
+		static std::error_code store(backend_t &backend, const char *key, const type &src) {
+			return backend.set_blob(key, src.data(), numBytes);
+		}
+	};
+
+	template<class T, auto GetValue>
+	struct object_t : public detail::type_descriptor_t<OBJECT, T, GetValue> {
+		using type = T;
+		template<nvs_backend_concept backend_t>
+		static std::error_code retrieve(backend_t &backend, const char *key, type &dst) {
+			usize size;
+			if (const auto e = backend.get_blob(key, nullptr, size); e)
+				return e;
+
+			if (size != sizeof(T))
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::VALUE_TOO_LONG);
+			
+			if (const auto e = backend.get_blob(key, &dst, size); e)
+				return e;
+
+			return {};
+		}
+
+		template<nvs_backend_concept backend_t>
+		static std::error_code store(backend_t &backend, const char *key, const type &src) {
+			return backend.set_blob(key, &src, sizeof(T));
+		}
+	};
+
+	template<typename T>
+	using object_serializer = std::optional<size_t>(*)(const T&, std::span<u8>);
+
+	template<typename T>
+	using object_deserializer = bool(*)(T&, std::span<const u8>);
+
+	/**
+	 * @brief Stores the object in its serialized form instead of as raw bytes.
+	 *
+	 * The blob only takes up the serialized size and stays readable across changes of the struct layout,
+	 * blobs the deserializer rejects (e.g. of an unknown version) fall back to the default value.
+	 */
+	template<
+		class T,
+		size_t MaxSize,
+		object_serializer<T> Serializer,
+		object_deserializer<T> Deserializer,
+		auto GetValue
+	>
+	struct transcoded_t : public detail::type_descriptor_t<TRANSCODED, T, GetValue> {
+		using type = T;
+		template<nvs_backend_concept backend_t>
+		static std::error_code retrieve(backend_t &backend, const char *key, type &dst) {
+			usize size;
+			if (const auto e = backend.get_blob(key, nullptr, size); e)
+				return e;
+
+			if (size > MaxSize)
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::VALUE_TOO_LONG);
+
+			std::array<u8, MaxSize> buffer;
+			if (const auto e = backend.get_blob(key, buffer.data(), size); e)
+				return e;
+
+			if (not Deserializer(dst, { buffer.data(), size }))
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::INVALID_VERSION);
+
+			return {};
+		}
+
+		template<nvs_backend_concept backend_t>
+		static std::error_code store(backend_t &backend, const char *key, const type &src) {
+			std::array<u8, MaxSize> buffer;
+			const auto size = Serializer(src, buffer);
+			if (not size)
+				return nvs_handler_error::make_error_code(nvs_handler_error::codes::SERIALIZATION_FAILED);
+
+			return backend.set_blob(key, buffer.data(), *size);
+		}
+	};
+}
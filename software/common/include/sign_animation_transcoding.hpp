@@ -1,195 +1,477 @@
 #pragma once
 
-#include <domain_logic/sign_animation.hpp>
-#include <util/for_each.hpp>
+#include <domain_logic/sign_animation_schema.hpp>
+#include <util/bit_stream.hpp>
+#include <optional>
 
-// This file is dedicated to C++'s enraging lack of reflection
+// The encoders are generated from the field lists in 'sign_animation_schema.hpp'.
+//
+// Layout (version 2):
+//   u8      version
+//   bits    variant indices and enums of all fields, in field order, padded to full bytes
+//   ...     remaining field data in field order
+//
+// Integers are LEB128 varints (signed ones zigzag encoded), floats are little endian,
+// colors are three bytes each. Color arrays longer than a palette are stored as
+// palette indices if the palette is smaller than the raw colors.
+//
+// Readers ignore trailing bytes, so fields appended by later
+// revisions of the same version are skipped by older firmware.
+// The appended field is left out while it holds its default, which older data reads as.
+// Readers only see whether it is there by the data ending before it, so there can only be
+// one, the last field of the animation. Another one needs a new version.
 
 namespace sign_animation_transcoding {
+
+	inline constexpr u8 version = 2;
+
 	namespace detail {
-		template<typename T, typename It>
-		inline void serializePrimitive(const T &value, It &dst) {
-			static_assert(std::is_trivially_copyable_v<T>);
-			using array_t = std::array<u8, sizeof(T)>;
-			const auto &bytes = *reinterpret_cast<const array_t*>(&value);
-			std::copy(bytes.begin(), bytes.end(), dst);
-			dst += bytes.size();
-		}
 
-		template<typename S, typename T, size_t maxSize, typename It>
-		inline bool serializePrimitiveArray(std::span<const T, maxSize> values, It &dst) {
-			serializePrimitive(static_cast<S>(values.size()), dst);
-			for (const auto& value : values) {
-				serializePrimitive(value, dst);
-			}
-			return true;
+		using namespace ztu::schema;
+
+		inline constexpr usize color_size = 3;
+
+		inline constexpr usize max_palette_size = 16;
+
+		template<typename T>
+		struct value_codec {};
+
+		template<class Accessor>
+		struct field_codec {};
+
+
+		//------------------------[ field lists ]------------------------//
+
+		template<class Fields>
+		inline constexpr usize header_bits = fold<Fields>(usize{ 0 }, [](auto a, auto b) { return a + b; }, []<class Field>() {
+			return field_codec<typename Field::accessor>::header_bits;
+		});
+
+		template<class Fields>
+		inline constexpr usize max_body_size = fold<Fields>(usize{ 0 }, [](auto a, auto b) { return a + b; }, []<class Field>() {
+			return field_codec<typename Field::accessor>::max_body_size;
+		});
+
+		template<class Fields>
+		inline void writeHeaders(ztu::bit_writer &dst, const auto &value) {
+			for_each_indexed<Fields>([&]<auto, class Field>() {
+				field_codec<typename Field::accessor>::writeHeader(dst, value);
+				return false;
+			});
 		}
 
-		template<typename It>
-		inline void serializeSupplier(const sign_supplier &value, It &dst) {
-			const auto index = value.index();
-			*dst++ = static_cast<u8>(index);
-			// index 0 is 'random' and does not contain relevant data
-			if (index == 1) {
-				const auto &sequence = std::get<sign_suppliers::sequence>(value);
-				using seq_size_t = std::remove_cvref_t<decltype(sequence.numColors)>;
-				serializePrimitiveArray<seq_size_t>(sequence.colors(), dst);
-			}
+		template<class Fields>
+		inline void writeBodies(ztu::bit_writer &dst, const auto &value) {
+			for_each_indexed<Fields>([&]<auto, class Field>() {
+				field_codec<typename Field::accessor>::writeBody(dst, value);
+				return false;
+			});
 		}
 
-		template<typename It>
-		inline void serializeScaler(const sign_scaler &value, It &dst) {
-			*dst++ = static_cast<u8>(value.index());
-			// node of the scalers contain relevant data
+		template<class Fields>
+		inline bool readHeaders(ztu::bit_reader &src, auto &value) {
+			return not for_each_indexed<Fields>([&]<auto, class Field>() {
+				return not field_codec<typename Field::accessor>::readHeader(src, value);
+			});
 		}
 
-		template<typename It>
-		inline void serializeSequencer(const sign_sequencer &value, It &dst) {
-			serializeSupplier(value.supplier, dst);
-			serializePrimitive(value.mixType, dst);
+		template<class Fields>
+		inline bool readBodies(ztu::bit_reader &src, auto &value) {
+			return not for_each_indexed<Fields>([&]<auto, class Field>() {
+				return not field_codec<typename Field::accessor>::readBody(src, value);
+			});
 		}
-	}
 
-	template<typename It>
-	inline void serialize(const sign_animation &value, It &dst) {
-		const auto &animation = value.animator;
-		const auto index = animation.index();
-		*dst++ = static_cast<u8>(index);
-		switch (index) {
-			case 0: {
-				const auto &uniform_color = std::get<sign_animations::uniform_color>(animation);
-				detail::serializeSequencer(uniform_color.sequencer, dst);
-				break;
-			}
-			case 1: {
-				const auto &moving_colors = std::get<sign_animations::moving_colors>(animation);
-				detail::serializeSequencer(moving_colors.sequencer, dst);
-				detail::serializePrimitive(moving_colors.perPixelOffset, dst);
-				detail::serializePrimitive(moving_colors.pixelOffset, dst);
-				break;
-			}
-			case 2: {
-				const auto &moving_colors = std::get<sign_animations::moving_pixel>(animation);
-				detail::serializeSequencer(moving_colors.sequencer, dst);
-				detail::serializeScaler(moving_colors.scaler, dst);
-				detail::serializePrimitive(moving_colors.colorSpeed, dst);
-				detail::serializePrimitive(moving_colors.width, dst);
-				break;
-			}
-			case 3: {
-				const auto &stop_motion = std::get<sign_animations::stop_motion>(animation);
-				using sm_size_t = std::remove_cvref_t<decltype(stop_motion.numFrames)>;
-				detail::serializePrimitiveArray<sm_size_t>(stop_motion.frames(), dst);
-				break;
+
+		//------------------------[ values ]------------------------//
+
+		template<std::integral T>
+		struct value_codec<T> {
+			static constexpr u64 encode(const T value) {
+				if constexpr (std::is_signed_v<T>) {
+					return ztu::zigzag_encode(value);
+				} else {
+					return value;
+				}
 			}
-		}
-		*dst++ = value.speed;
-	}
 
-	namespace detail {
-		template<typename T, typename It>
-		inline bool deserializePrimitive(T &value, It &src) {
-			static_assert(std::is_trivially_copyable_v<T>);
-			using array_t = std::array<u8, sizeof(T)>;
-			auto &bytes = *reinterpret_cast<array_t*>(&value);
-			std::copy(src, src + sizeof(T), bytes.begin());
-			src += bytes.size();
-			return true;
-		}
+			static constexpr usize header_bits = 0;
+			static constexpr usize max_body_size = std::max(
+				ztu::varint_size(encode(std::numeric_limits<T>::min())),
+				ztu::varint_size(encode(std::numeric_limits<T>::max()))
+			);
+
+			static void writeHeader(ztu::bit_writer&, const T&) {}
 
-		template<typename T, size_t maxSize, typename S, typename It>
-		inline bool deserializePrimitiveArray(std::span<T, maxSize> dst, S &size, It &src) {
-			deserializePrimitive(size, src);
-			if (size > dst.size()) return false;
-			for (S i = 0; i < size; i++) {
-				deserializePrimitive(dst[i], src);
+			static void writeBody(ztu::bit_writer &dst, const T &value) {
+				dst.write_varint(encode(value));
 			}
-			return true;
-		}
 
-		template<typename It>
-		inline bool deserializeSupplier(sign_supplier &value, It &src) {
-			const auto index = *src++;
-			switch (index) {
-				case 0: {
-					value.emplace<sign_suppliers::random>();
-					break;
+			static bool readHeader(ztu::bit_reader&, T&) {
+				return true;
+			}
+
+			static bool readBody(ztu::bit_reader &src, T &value) {
+				const auto raw = src.read_varint();
+				if constexpr (std::is_signed_v<T>) {
+					const auto decoded = ztu::zigzag_decode(raw);
+					if (decoded < std::numeric_limits<T>::min() or decoded > std::numeric_limits<T>::max())
+						return false;
+					value = static_cast<T>(decoded);
+				} else {
+					if (raw > std::numeric_limits<T>::max())
+						return false;
+					value = static_cast<T>(raw);
 				}
-				case 1: {
-					auto &sequence = value.emplace<sign_suppliers::sequence>();
-					deserializePrimitiveArray(std::span{ sequence.m_colors }, sequence.numColors, src);
-					break;
+				return src.ok();
+			}
+		};
+
+		template<std::floating_point T>
+		struct value_codec<T> {
+			static constexpr usize header_bits = 0;
+			static constexpr usize max_body_size = sizeof(T);
+
+			static void writeHeader(ztu::bit_writer&, const T&) {}
+
+			static void writeBody(ztu::bit_writer &dst, const T &value) {
+				dst.write_le(value);
+			}
+
+			static bool readHeader(ztu::bit_reader&, T&) {
+				return true;
+			}
+
+			static bool readBody(ztu::bit_reader &src, T &value) {
+				value = src.read_le<T>();
+				return src.ok();
+			}
+		};
+
+		template<described_object T>
+		struct value_codec<T> {
+			using fields = of<T>::fields;
+
+			static constexpr usize header_bits = detail::header_bits<fields>;
+			static constexpr usize max_body_size = detail::max_body_size<fields>;
+
+			static void writeHeader(ztu::bit_writer &dst, const T &value) {
+				writeHeaders<fields>(dst, value);
+			}
+
+			static void writeBody(ztu::bit_writer &dst, const T &value) {
+				writeBodies<fields>(dst, value);
+			}
+
+			static bool readHeader(ztu::bit_reader &src, T &value) {
+				return readHeaders<fields>(src, value);
+			}
+
+			static bool readBody(ztu::bit_reader &src, T &value) {
+				return readBodies<fields>(src, value);
+			}
+		};
+
+		template<described_variant T>
+		struct value_codec<T> {
+			using alternatives = of<T>::alternatives;
+
+			static constexpr auto index_bits = ztu::bits_for(std::variant_size_v<T> - 1);
+
+			static constexpr usize header_bits = index_bits + fold<alternatives>(usize{ 0 }, [](auto a, auto b) { return std::max(a, b); }, []<class Alternative>() {
+				return detail::header_bits<typename Alternative::fields>;
+			});
+
+			static constexpr usize max_body_size = fold<alternatives>(usize{ 0 }, [](auto a, auto b) { return std::max(a, b); }, []<class Alternative>() {
+				return detail::max_body_size<typename Alternative::fields>;
+			});
+
+			static void writeHeader(ztu::bit_writer &dst, const T &value) {
+				dst.write_bits(value.index(), index_bits);
+				for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+					if (value.index() != Index)
+						return false;
+					writeHeaders<typename Alternative::fields>(dst, std::get<Index>(value));
+					return true;
+				});
+			}
+
+			static void writeBody(ztu::bit_writer &dst, const T &value) {
+				for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+					if (value.index() != Index)
+						return false;
+					writeBodies<typename Alternative::fields>(dst, std::get<Index>(value));
+					return true;
+				});
+			}
+
+			static bool readHeader(ztu::bit_reader &src, T &value) {
+				const auto index = src.read_bits(index_bits);
+				auto ok = false;
+				for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+					if (index != Index)
+						return false;
+					ok = readHeaders<typename Alternative::fields>(src, value.template emplace<Index>());
+					return true;
+				});
+				return ok and src.ok();
+			}
+
+			static bool readBody(ztu::bit_reader &src, T &value) {
+				auto ok = false;
+				for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+					if (value.index() != Index)
+						return false;
+					ok = readBodies<typename Alternative::fields>(src, std::get<Index>(value));
+					return true;
+				});
+				return ok;
+			}
+		};
+
+
+		//------------------------[ accessors ]------------------------//
+
+		template<auto Member>
+		struct field_codec<member<Member>> {
+			using accessor = member<Member>;
+			using codec = value_codec<typename accessor::value_type>;
+
+			static constexpr usize header_bits = codec::header_bits;
+			static constexpr usize max_body_size = codec::max_body_size;
+
+			static void writeHeader(ztu::bit_writer &dst, const auto &obj) {
+				codec::writeHeader(dst, accessor::get(obj));
+			}
+
+			static void writeBody(ztu::bit_writer &dst, const auto &obj) {
+				codec::writeBody(dst, accessor::get(obj));
+			}
+
+			static bool readHeader(ztu::bit_reader &src, auto &obj) {
+				return codec::readHeader(src, accessor::ref(obj));
+			}
+
+			static bool readBody(ztu::bit_reader &src, auto &obj) {
+				return codec::readBody(src, accessor::ref(obj));
+			}
+		};
+
+		template<auto Member>
+		struct field_codec<appended<Member>> {
+			using accessor = appended<Member>;
+			using value_type = accessor::value_type;
+			using codec = value_codec<value_type>;
+
+			static_assert(codec::header_bits == 0, "appended fields are read after all headers");
+
+			static constexpr usize header_bits = 0;
+			static constexpr usize max_body_size = codec::max_body_size;
+
+			static void writeHeader(ztu::bit_writer&, const auto&) {}
+
+			static void writeBody(ztu::bit_writer &dst, const auto &obj) {
+				if (accessor::get(obj) != value_type{}) {
+					codec::writeBody(dst, accessor::get(obj));
 				}
-				default: return false;
 			}
 
-			return true;
-		}
+			static bool readHeader(ztu::bit_reader&, auto&) {
+				return true;
+			}
 
-		template<typename It>
-		inline bool deserializeScaler(sign_scaler &value, It &src) {
-			const auto index = *src++;
-			return ztu::for_each::indexed_type<
-				sign_scalers::ping_pong,
-				sign_scalers::sinus,
-				sign_scalers::random,
-				sign_scalers::smooth_random
-			>([&]<auto Index, typename T>() {
-				if (index == Index) {
-					value.emplace<Index>();
+			static bool readBody(ztu::bit_reader &src, auto &obj) {
+				if (src.exhausted()) {
+					accessor::ref(obj) = value_type{};
 					return true;
 				}
-				return false;
-			});
-		}
+				return codec::readBody(src, accessor::ref(obj));
+			}
+		};
+
+		template<auto Member, auto Max>
+		struct field_codec<enumeration<Member, Max>> {
+			using accessor = enumeration<Member, Max>;
+
+			static constexpr usize header_bits = ztu::bits_for(accessor::max);
+			static constexpr usize max_body_size = 0;
+
+			static void writeHeader(ztu::bit_writer &dst, const auto &obj) {
+				dst.write_bits(static_cast<u64>(accessor::get(obj)), header_bits);
+			}
+
+			static void writeBody(ztu::bit_writer&, const auto&) {}
+
+			static bool readHeader(ztu::bit_reader &src, auto &obj) {
+				const auto value = src.read_bits(header_bits);
+				return accessor::set(obj, static_cast<typename accessor::value_type>(value)) and src.ok();
+			}
+
+			static bool readBody(ztu::bit_reader&, auto&) {
+				return true;
+			}
+		};
+
+		template<auto Array, auto Count, usize Multiple>
+			requires std::same_as<typename bounded_array<Array, Count, Multiple>::element_type, color>
+		struct field_codec<bounded_array<Array, Count, Multiple>> {
+			using accessor = bounded_array<Array, Count, Multiple>;
+
+			// Short arrays would not get any smaller, so they do not even carry the palette size.
+			static constexpr bool indexed = accessor::capacity > max_palette_size;
 
-		template<typename It>
-		inline bool deserializeSequencer(sign_sequencer &value, It &dst) {
-			return (
-				deserializeSupplier(value.supplier, dst) and
-				deserializePrimitive(value.mixType, dst)
+			static constexpr usize header_bits = 0;
+			static constexpr usize max_body_size = (
+				ztu::varint_size(accessor::capacity) +
+				(indexed ? ztu::varint_size(max_palette_size) : 0) +
+				accessor::capacity * color_size // the raw encoding is used if the palette is not smaller
 			);
-		}
-	}
 
-	template<typename It>
-	inline bool deserialize(sign_animation &value, It &src) {
-		auto ok = true;
-
-		auto &animation = value.animator;
-		const auto index = *src++;
-
-		switch (index) {
-			case 0: {
-				auto &uniform_color = animation.emplace<sign_animations::uniform_color>();
-				ok = detail::deserializeSequencer(uniform_color.sequencer, src);
-				break;
-			};
-			case 1: {
-				auto &moving_colors = animation.emplace<sign_animations::moving_colors>();
-				ok = (
-					detail::deserializeSequencer(moving_colors.sequencer, src) and
-					detail::deserializePrimitive(moving_colors.perPixelOffset, src) and
-					detail::deserializePrimitive(moving_colors.pixelOffset, src)
-				);
-				break;
-			};
-			case 2: {
-				auto &moving_colors = animation.emplace<sign_animations::moving_pixel>();
-				ok = (
-					detail::deserializeSequencer(moving_colors.sequencer, src) and
-					detail::deserializeScaler(moving_colors.scaler, src) and
-					detail::deserializePrimitive(moving_colors.colorSpeed, src) and
-					detail::deserializePrimitive(moving_colors.width, src)
-				);
-				break;
-			}
-			case 3: {
-				auto &stop_motion = animation.emplace<sign_animations::stop_motion>();
-				detail::deserializePrimitiveArray(std::span{ stop_motion.m_frames }, stop_motion.numFrames, src);
-				break;
+			static void writeColors(ztu::bit_writer &dst, std::span<const color> colors) {
+				for (const auto &c : colors) {
+					dst.write_byte(c.r);
+					dst.write_byte(c.g);
+					dst.write_byte(c.b);
+				}
 			}
-		}
-		return ok and detail::deserializePrimitive(value.speed, src);
+
+			static bool readColors(ztu::bit_reader &src, std::span<color> colors) {
+				for (auto &c : colors) {
+					c.r = src.read_byte();
+					c.g = src.read_byte();
+					c.b = src.read_byte();
+				}
+				return src.ok();
+			}
+
+			static void writeHeader(ztu::bit_writer&, const auto&) {}
+
+			static void writeBody(ztu::bit_writer &dst, const auto &obj) {
+				const auto colors = accessor::get(obj);
+
+				dst.write_varint(colors.size());
+
+				if constexpr (not indexed) {
+					writeColors(dst, colors);
+				} else {
+					std::array<color, max_palette_size> palette;
+					usize paletteSize = 0;
+					for (const auto &c : colors) {
+						const auto end = palette.begin() + paletteSize;
+						if (std::find(palette.begin(), end, c) == end) {
+							if (paletteSize == palette.size()) {
+								paletteSize = 0;
+								break;
+							}
+							palette[paletteSize++] = c;
+						}
+					}
+
+					const auto indexBits = ztu::bits_for(std::max<usize>(paletteSize, 1) - 1);
+					const auto indexedSize = paletteSize * color_size + (colors.size() * indexBits + 7) / 8;
+					if (indexedSize >= colors.size() * color_size) {
+						paletteSize = 0;
+					}
+
+					dst.write_varint(paletteSize);
+
+					if (paletteSize == 0) {
+						writeColors(dst, colors);
+						return;
+					}
+
+					writeColors(dst, { palette.begin(), paletteSize });
+					for (const auto &c : colors) {
+						const auto index = std::find(palette.begin(), palette.begin() + paletteSize, c) - palette.begin();
+						dst.write_bits(static_cast<u64>(index), indexBits);
+					}
+				}
+			}
+
+			static bool readHeader(ztu::bit_reader&, auto&) {
+				return true;
+			}
+
+			static bool readBody(ztu::bit_reader &src, auto &obj) {
+				const auto numColors = src.read_varint();
+				const auto paletteSize = indexed ? src.read_varint() : 0;
+
+				if (not accessor::valid_size(numColors) or paletteSize > max_palette_size)
+					return false;
+
+				std::array<color, accessor::capacity> colors;
+				const auto used = std::span{ colors.begin(), numColors };
+
+				if (paletteSize == 0) {
+					if (not readColors(src, used))
+						return false;
+				} else {
+					std::array<color, max_palette_size> palette;
+					readColors(src, { palette.begin(), paletteSize });
+
+					const auto indexBits = ztu::bits_for(paletteSize - 1);
+					for (auto &c : used) {
+						const auto index = src.read_bits(indexBits);
+						if (index >= paletteSize)
+							return false;
+						c = palette[index];
+					}
+				}
+
+				return src.ok() and accessor::set(obj, used);
+			}
+		};
+	}
+
+	using animation_codec = detail::value_codec<sign_animation>;
+
+	static_assert(
+		ztu::schema::appended_last<sign_animation>(),
+		"an appended field left out would be read from the bytes of the next one"
+	);
+
+	/**
+	 * @brief Upper bound of the encoded size of any sign_animation.
+	 */
+	inline constexpr usize max_encoded_size = (
+		sizeof(version) +
+		(animation_codec::header_bits + 7) / 8 +
+		animation_codec::max_body_size
+	);
+
+	/**
+	 * @brief Encodes the animation into dst.
+	 *
+	 * @return The number of bytes written or std::nullopt if dst is too small.
+	 */
+	[[nodiscard]] inline std::optional<usize> serialize(const sign_animation &value, std::span<u8> dst) {
+		auto writer = ztu::bit_writer(dst);
+
+		writer.write_byte(version);
+		animation_codec::writeHeader(writer, value);
+		animation_codec::writeBody(writer, value);
+
+		if (not writer.ok())
+			return std::nullopt;
+
+		return writer.size();
+	}
+
+	/**
+	 * @brief Decodes an animation written by serialize.
+	 *
+	 * @return false if the data is malformed or uses an unknown version.
+	 */
+	[[nodiscard]] inline bool deserialize(sign_animation &value, std::span<const u8> src) {
+		auto reader = ztu::bit_reader(src);
+
+		if (reader.read_byte() != version)
+			return false;
+
+		return (
+			animation_codec::readHeader(reader, value) and
+			animation_codec::readBody(reader, value) and
+			reader.ok()
+		);
 	}
 }
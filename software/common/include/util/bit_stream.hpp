@@ -0,0 +1,197 @@
+#pragma once
+
+#include <span>
+#include <bit>
+#include <concepts>
+#include <algorithm>
+#include "uix.hpp"
+
+namespace ztu {
+
+	/**
+	 * @brief Number of bits needed to store every value in [0, max_value].
+	 */
+	inline constexpr u8 bits_for(u64 max_value) {
+		return static_cast<u8>(std::bit_width(max_value));
+	}
+
+	/**
+	 * @brief Maximum number of bytes of a LEB128 varint holding values up to max_value.
+	 */
+	inline constexpr usize varint_size(u64 max_value) {
+		return std::max<usize>(1, (std::bit_width(max_value) + 6) / 7);
+	}
+
+	inline constexpr u64 zigzag_encode(i64 value) {
+		return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+	}
+
+	inline constexpr i64 zigzag_decode(u64 value) {
+		return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+	}
+
+	/**
+	 * @brief Writes bit fields, varints and raw bytes into a fixed buffer.
+	 *
+	 * Bit fields are packed lsb first, byte sized writes start at the next full byte.
+	 * Writing past the end of the buffer clears 'ok' and turns all further writes into no-ops.
+	 */
+	class bit_writer {
+	public:
+		inline constexpr explicit bit_writer(std::span<u8> dst) : m_dst{ dst } {}
+
+		inline constexpr bool write_bits(u64 value, u8 count) {
+			for (u8 i = 0; i != count; ++i) {
+				if (m_bit == 0) {
+					if (m_pos == m_dst.size()) return m_ok = false;
+					m_dst[m_pos++] = 0;
+				}
+				m_dst[m_pos - 1] |= static_cast<u8>(((value >> i) & 1) << m_bit);
+				m_bit = (m_bit + 1) % 8;
+			}
+			return m_ok;
+		}
+
+		inline constexpr bool write_byte(u8 value) {
+			align();
+			if (not m_ok or m_pos == m_dst.size()) return m_ok = false;
+			m_dst[m_pos++] = value;
+			return true;
+		}
+
+		inline constexpr bool write_bytes(std::span<const u8> bytes) {
+			for (const auto byte : bytes) {
+				if (not write_byte(byte)) return false;
+			}
+			return m_ok;
+		}
+
+		inline constexpr bool write_varint(u64 value) {
+			do {
+				const auto low = static_cast<u8>(value & 0x7f);
+				value >>= 7;
+				if (not write_byte(low | (value ? 0x80 : 0x00))) return false;
+			} while (value);
+			return m_ok;
+		}
+
+		inline constexpr bool write_zigzag(i64 value) {
+			return write_varint(zigzag_encode(value));
+		}
+
+		template<typename T>
+			requires (std::is_trivially_copyable_v<T> and sizeof(T) <= sizeof(u64))
+		inline constexpr bool write_le(const T &value) {
+			using uint_t = ztu::uint_t<sizeof(T)>;
+			const auto bits = std::bit_cast<uint_t>(value);
+			for (usize i = 0; i != sizeof(T); ++i) {
+				if (not write_byte(static_cast<u8>(bits >> (i * 8)))) return false;
+			}
+			return m_ok;
+		}
+
+		inline constexpr void align() {
+			m_bit = 0;
+		}
+
+		[[nodiscard]] inline constexpr bool ok() const {
+			return m_ok;
+		}
+
+		[[nodiscard]] inline constexpr usize size() const {
+			return m_pos;
+		}
+
+	private:
+		std::span<u8> m_dst;
+		usize m_pos{ 0 };
+		u8 m_bit{ 0 };
+		bool m_ok{ true };
+	};
+
+	/**
+	 * @brief Reads what bit_writer wrote.
+	 *
+	 * Reading past the end of the buffer clears 'ok', all further reads yield zero.
+	 */
+	class bit_reader {
+	public:
+		inline constexpr explicit bit_reader(std::span<const u8> src) : m_src{ src } {}
+
+		inline constexpr u64 read_bits(u8 count) {
+			u64 value = 0;
+			for (u8 i = 0; i != count; ++i) {
+				if (m_bit == 0) {
+					if (m_pos == m_src.size()) {
+						m_ok = false;
+						return 0;
+					}
+					++m_pos;
+				}
+				value |= static_cast<u64>((m_src[m_pos - 1] >> m_bit) & 1) << i;
+				m_bit = (m_bit + 1) % 8;
+			}
+			return value;
+		}
+
+		inline constexpr u8 read_byte() {
+			align();
+			if (not m_ok or m_pos == m_src.size()) {
+				m_ok = false;
+				return 0;
+			}
+			return m_src[m_pos++];
+		}
+
+		inline constexpr bool read_bytes(std::span<u8> bytes) {
+			for (auto &byte : bytes) {
+				byte = read_byte();
+			}
+			return m_ok;
+		}
+
+		inline constexpr u64 read_varint() {
+			u64 value = 0;
+			for (u8 shift = 0; shift < 64; shift += 7) {
+				const auto byte = read_byte();
+				value |= static_cast<u64>(byte & 0x7f) << shift;
+				if (not (byte & 0x80)) return value;
+			}
+			m_ok = false;
+			return 0;
+		}
+
+		inline constexpr i64 read_zigzag() {
+			return zigzag_decode(read_varint());
+		}
+
+		template<typename T>
+			requires (std::is_trivially_copyable_v<T> and sizeof(T) <= sizeof(u64))
+		inline constexpr T read_le() {
+			using uint_t = ztu::uint_t<sizeof(T)>;
+			uint_t bits = 0;
+			for (usize i = 0; i != sizeof(T); ++i) {
+				bits |= static_cast<uint_t>(static_cast<uint_t>(read_byte()) << (i * 8));
+			}
+			return std::bit_cast<T>(bits);
+		}
+
+		inline constexpr void align() {
+			m_bit = 0;
+		}
+
+		[[nodiscard]] inline constexpr bool ok() const {
+			return m_ok;
+		}
+
+		[[nodiscard]] inline constexpr bool exhausted() const {
+			return m_pos == m_src.size();
+		}
+
+	private:
+		std::span<const u8> m_src;
+		usize m_pos{ 0 };
+		u8 m_bit{ 0 };
+		bool m_ok{ true };
+	};
+}
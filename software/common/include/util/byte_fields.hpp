@@ -0,0 +1,42 @@
+#pragma once
+
+#include "uix.hpp"
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace ztu::byte_fields {
+
+	// Structs on the wire are written field by field with fixed widths, so neither padding
+	// nor the word size of the sign and the plugin changes the encoding. Both are little endian.
+
+	template<typename T>
+		requires std::is_integral_v<T>
+	inline u8* put(u8 *dst, const T &value) {
+		std::memcpy(dst, &value, sizeof(T));
+		return dst + sizeof(T);
+	}
+
+	template<typename T, usize N>
+	inline u8* put(u8 *dst, const std::array<T, N> &values) {
+		for (const auto &value : values) {
+			dst = put(dst, value);
+		}
+		return dst;
+	}
+
+	template<typename T>
+		requires std::is_integral_v<T>
+	inline const u8* take(const u8 *src, T &value) {
+		std::memcpy(&value, src, sizeof(T));
+		return src + sizeof(T);
+	}
+
+	template<typename T, usize N>
+	inline const u8* take(const u8 *src, std::array<T, N> &values) {
+		for (auto &value : values) {
+			src = take(src, value);
+		}
+		return src;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include "uix.hpp"
+
+using namespace ztu::uix;
+
+/**
+ * @brief A single observation relating the local clock to the reference clock.
+ *
+ * All times are in microseconds.
+ */
+struct clock_sample {
+	i64 local;
+	i64 reference;
+	i64 delay;
+
+	/**
+	 * @brief Creates a sample from an NTP style exchange.
+	 *
+	 * @param t0 Reference time at which the request was sent.
+	 * @param t1 Local time at which the request was received.
+	 * @param t2 Local time at which the reply was sent.
+	 * @param t3 Reference time at which the reply was received.
+	 */
+	[[nodiscard]] inline static constexpr clock_sample from_exchange(i64 t0, i64 t1, i64 t2, i64 t3);
+};
+
+/**
+ * @brief Linear mapping between the local and the reference clock.
+ *
+ * Small enough to be copied into the animation task every tick.
+ */
+struct clock_mapping {
+	i64 anchorLocal{ 0 };
+	i64 anchorOffset{ 0 };
+	i32 skewPpb{ 0 };
+	bool synchronized{ false };
+
+	[[nodiscard]] inline constexpr i64 toReference(i64 local) const;
+
+	[[nodiscard]] inline constexpr i64 toLocal(i64 reference) const;
+};
+
+/**
+ * @brief Estimates offset and skew of the local clock from a window of samples.
+ *
+ * Samples with a round trip delay far above the best one in the window are
+ * ignored, the remaining ones are fitted with least squares.
+ */
+template<usize NumSamples>
+class clock_estimator {
+	static_assert(NumSamples >= 2);
+
+public:
+	// Offset jumps above this are treated as a clock step instead of drift.
+	static constexpr i64 stepThreshold = 1'000'000;
+	// Skew is only estimated once the samples cover this time span.
+	static constexpr i64 minSkewSpan = 10'000'000;
+	static constexpr i32 maxSkewPpb = 500'000;
+
+	inline void addSample(const clock_sample &sample);
+
+	inline void reset();
+
+	[[nodiscard]] inline const clock_mapping& mapping() const;
+
+private:
+	inline void estimate();
+
+	std::array<clock_sample, NumSamples> m_samples{};
+	usize m_count{ 0 }, m_next{ 0 };
+	clock_mapping m_mapping{};
+};
+
+#define INCLUDE_CLOCK_ESTIMATOR_IMPLEMENTATION
+#include <util/clock_estimator.ipp>
+#undef INCLUDE_CLOCK_ESTIMATOR_IMPLEMENTATION
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include "uix.hpp"
+
+namespace ztu {
+
+	/**
+	 * @brief Event count that any task may increment without locking.
+	 *
+	 * Wraps around after 2^32 events, readers only ever see whole values.
+	 */
+	class metric_counter {
+	public:
+		void add(u32 n = 1) {
+			m_value.fetch_add(n, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] u32 value() const {
+			return m_value.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<u32> m_value{ 0 };
+	};
+
+	struct timing_summary {
+		u32 count;
+		u32 last;
+		u32 average;
+		u32 max;
+	};
+
+	/**
+	 * @brief Durations recorded by a single task, readable from any other task.
+	 *
+	 * Only 32 bit atomics are used, so recording stays lock free on targets without 64 bit atomics.
+	 * The average is weighted exponentially over roughly the last 16 recordings.
+	 * Fields are read independently, a summary taken during a recording may mix two of them.
+	 */
+	class metric_timing {
+	public:
+		void record(u32 duration) {
+			// scaled by 16 to keep the fraction of the weighted average
+			duration = std::min(duration, max_duration);
+			const auto average = m_average.load(std::memory_order_relaxed);
+			const auto count = m_count.load(std::memory_order_relaxed);
+			m_average.store(count == 0 ? duration * 16 : average - average / 16 + duration, std::memory_order_relaxed);
+			m_last.store(duration, std::memory_order_relaxed);
+			if (duration > m_max.load(std::memory_order_relaxed)) {
+				m_max.store(duration, std::memory_order_relaxed);
+			}
+			m_count.store(count + 1, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] timing_summary summary() const {
+			return {
+				.count = m_count.load(std::memory_order_relaxed),
+				.last = m_last.load(std::memory_order_relaxed),
+				.average = m_average.load(std::memory_order_relaxed) / 16,
+				.max = m_max.load(std::memory_order_relaxed)
+			};
+		}
+
+	private:
+		static constexpr u32 max_duration = std::numeric_limits<u32>::max() / 16;
+
+		std::atomic<u32> m_count{ 0 };
+		std::atomic<u32> m_last{ 0 };
+		std::atomic<u32> m_average{ 0 };
+		std::atomic<u32> m_max{ 0 };
+	};
+}
@@ -768,7 +768,7 @@ namespace ztu {
 		template<template<typename, typename> class Less>
 		using sort = ztu::sort<Less, T, Ts...>;
 
-		static constexpr auto size = sizeof...(Ts);
+		static constexpr auto size = sizeof...(Ts) + 1;
 
 		static constexpr auto empty = size == 0;
 
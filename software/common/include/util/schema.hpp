@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <variant>
+#include <algorithm>
+#include <type_traits>
+#include "uix.hpp"
+#include "pack.hpp"
+#include "for_each.hpp"
+#include "string_literal.hpp"
+
+/**
+ * Compile time descriptions of plain structs and variants.
+ *
+ * A description only lists the fields and how to access them,
+ * encoders and converters are generated from it by iterating the field packs.
+ * Types are described by specializing 'ztu::schema::of'.
+ */
+namespace ztu::schema {
+
+	namespace detail {
+		template<auto Member>
+		struct member_traits {};
+
+		template<class Class, typename Value, Value Class::*Member>
+		struct member_traits<Member> {
+			using class_type = Class;
+			using value_type = Value;
+		};
+	}
+
+	/**
+	 * @brief Plain data member, read and written as is.
+	 */
+	template<auto Member>
+	struct member {
+		using class_type = detail::member_traits<Member>::class_type;
+		using value_type = detail::member_traits<Member>::value_type;
+
+		static constexpr const value_type& get(const class_type &obj) {
+			return obj.*Member;
+		}
+
+		static constexpr value_type& ref(class_type &obj) {
+			return obj.*Member;
+		}
+
+		static constexpr bool set(class_type &obj, const value_type &value) {
+			obj.*Member = value;
+			return true;
+		}
+	};
+
+	/**
+	 * @brief Enum member with values in [0, Max].
+	 */
+	template<auto Member, auto Max>
+		requires std::is_enum_v<typename detail::member_traits<Member>::value_type>
+	struct enumeration {
+		using class_type = detail::member_traits<Member>::class_type;
+		using value_type = detail::member_traits<Member>::value_type;
+
+		static constexpr auto max = static_cast<u64>(Max);
+
+		static constexpr value_type get(const class_type &obj) {
+			return obj.*Member;
+		}
+
+		static constexpr bool set(class_type &obj, const value_type value) {
+			if (static_cast<u64>(value) > max)
+				return false;
+			obj.*Member = value;
+			return true;
+		}
+	};
+
+	/**
+	 * @brief Fixed capacity array member of which only the first 'Count' elements are in use.
+	 *
+	 * Sizes have to be non zero multiples of 'Multiple'.
+	 */
+	template<auto Array, auto Count, usize Multiple = 1>
+	struct bounded_array {
+		using class_type = detail::member_traits<Array>::class_type;
+		using array_type = detail::member_traits<Array>::value_type;
+		using count_type = detail::member_traits<Count>::value_type;
+		using element_type = array_type::value_type;
+		using value_type = std::span<const element_type>;
+
+		static constexpr usize capacity = std::tuple_size_v<array_type>;
+		static constexpr usize multiple = Multiple;
+
+		static constexpr bool valid_size(const u64 size) {
+			return size != 0 and size <= capacity and size % multiple == 0;
+		}
+
+		static constexpr value_type get(const class_type &obj) {
+			return { (obj.*Array).begin(), static_cast<usize>(obj.*Count) };
+		}
+
+		static constexpr bool set(class_type &obj, const value_type values) {
+			if (not valid_size(values.size()))
+				return false;
+			std::copy(values.begin(), values.end(), (obj.*Array).begin());
+			obj.*Count = static_cast<count_type>(values.size());
+			return true;
+		}
+	};
+
+	/**
+	 * @brief Plain data member added by a later revision of an encoding.
+	 *
+	 * Encoders leave out the value-initialized value, readers of data without the member
+	 * get it. Readers only tell by the end of the data whether it is there, so a description
+	 * can have a single one, as the last field of the outermost object (see 'appended_last').
+	 */
+	template<auto Member>
+	struct appended : member<Member> {};
+
+	template<string_literal Name, class Accessor>
+	struct field {
+		static constexpr auto name = Name;
+		using accessor = Accessor;
+	};
+
+	template<string_literal Name, auto Member>
+	using member_field = field<Name, member<Member>>;
+
+	/**
+	 * @brief Describes a struct as an ordered list of fields.
+	 */
+	template<typename T, class... Fields>
+	struct object {
+		using type = T;
+		using fields = pack<Fields...>;
+	};
+
+	template<string_literal Name, class... Fields>
+	struct alternative {
+		static constexpr auto name = Name;
+		using fields = pack<Fields...>;
+	};
+
+	/**
+	 * @brief Describes a std::variant, the alternatives are listed in the order of the variant.
+	 */
+	template<typename T, class... Alternatives>
+		requires (std::variant_size_v<T> == sizeof...(Alternatives))
+	struct variant {
+		using type = T;
+		using alternatives = pack<Alternatives...>;
+	};
+
+	template<typename T>
+	struct of {};
+
+	template<typename T>
+	concept described_object = requires {
+		typename of<T>::fields;
+	};
+
+	template<typename T>
+	concept described_variant = requires {
+		typename of<T>::alternatives;
+	};
+
+	/**
+	 * @brief Calls 'f.template operator()<Index, Element>()' for every element of the pack
+	 * until one returns true.
+	 */
+	template<class Pack>
+	inline constexpr bool for_each_indexed(auto &&f) {
+		return []<typename... Ts>(pack<Ts...>, auto &&g) {
+			return for_each::indexed_type<Ts...>(g);
+		}(Pack{}, f);
+	}
+
+	/**
+	 * @brief Folds 'f.template operator()<Element>()' over all elements with 'op', starting at 'init'.
+	 */
+	template<class Pack, typename R>
+	inline constexpr R fold(R init, auto &&op, auto &&f) {
+		for_each_indexed<Pack>([&]<auto, typename T>() {
+			init = op(init, f.template operator()<T>());
+			return false;
+		});
+		return init;
+	}
+
+	template<class Accessor>
+	inline constexpr bool is_appended = false;
+
+	template<auto Member>
+	inline constexpr bool is_appended<appended<Member>> = true;
+
+	/**
+	 * @brief Number of 'appended' fields of 'T' and of all objects and variants it holds.
+	 */
+	template<typename T>
+	inline constexpr usize num_appended = 0;
+
+	template<class Fields>
+	inline constexpr usize num_appended_fields = fold<Fields>(usize{ 0 }, [](auto a, auto b) { return a + b; }, []<class Field>() {
+		using accessor = Field::accessor;
+		return usize{ is_appended<accessor> } + num_appended<typename accessor::value_type>;
+	});
+
+	template<described_object T>
+	inline constexpr usize num_appended<T> = num_appended_fields<typename of<T>::fields>;
+
+	template<described_variant T>
+	inline constexpr usize num_appended<T> = fold<typename of<T>::alternatives>(usize{ 0 }, [](auto a, auto b) { return a + b; }, []<class Alternative>() {
+		return num_appended_fields<typename Alternative::fields>;
+	});
+
+	/**
+	 * @brief Whether 'T' has at most one 'appended' field, which then is its own last field.
+	 */
+	template<described_object T>
+	inline consteval bool appended_last() {
+		if constexpr (num_appended<T> == 0) {
+			return true;
+		} else {
+			return num_appended<T> == 1 and is_appended<typename of<T>::fields::last::accessor>;
+		}
+	}
+}
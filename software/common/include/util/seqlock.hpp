@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "uix.hpp"
+
+namespace ztu {
+
+	/**
+	 * @brief Single writer, multiple reader lock free snapshot of a trivially copyable value.
+	 *
+	 * Readers never block the writer, they retry if the value changed while being copied.
+	 * The value is stored in relaxed atomic words so torn reads are detected instead of being a data race.
+	 */
+	template<typename T>
+		requires std::is_trivially_copyable_v<T> and std::is_default_constructible_v<T>
+	class seqlock {
+		static constexpr auto num_words = (sizeof(T) + sizeof(u32) - 1) / sizeof(u32);
+		using words_t = std::array<u32, num_words>;
+
+	public:
+		seqlock() : seqlock(T{}) {}
+
+		explicit seqlock(const T &value) {
+			store(value);
+		}
+
+		void store(const T &value) {
+			words_t words{};
+			std::memcpy(words.data(), &value, sizeof(T));
+
+			const auto sequence = m_sequence.load(std::memory_order_relaxed);
+			m_sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			for (usize i = 0; i != num_words; ++i) {
+				m_words[i].store(words[i], std::memory_order_relaxed);
+			}
+
+			m_sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		[[nodiscard]] T load() const {
+			words_t words;
+			u32 before, after;
+			do {
+				before = m_sequence.load(std::memory_order_acquire);
+				for (usize i = 0; i != num_words; ++i) {
+					words[i] = m_words[i].load(std::memory_order_relaxed);
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				after = m_sequence.load(std::memory_order_relaxed);
+			} while (before != after or (before & 1));
+
+			T value;
+			std::memcpy(&value, words.data(), sizeof(T));
+			return value;
+		}
+
+		[[nodiscard]] u32 version() const {
+			return m_sequence.load(std::memory_order_acquire) / 2;
+		}
+
+	private:
+		std::atomic<u32> m_sequence{ 0 };
+		std::array<std::atomic<u32>, num_words> m_words{};
+	};
+}
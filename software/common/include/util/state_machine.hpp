@@ -9,8 +9,46 @@
 #include "pack.hpp"
 #include "function.hpp"
 
-template<class F, class... States>
-class state_machine {
+template<class T>
+concept state_machine_state = requires {
+	T::states;
+	T::transitions;
+};
+
+template<class T, typename Enum>
+concept state_machine_instrumentation = requires(T &instrumentation, Enum state) {
+	/**
+	 * @brief Called with the initial state before the first state runs.
+	 */
+	{ instrumentation.start(state) };
+
+	/**
+	 * @brief Called after every run with the state that ran and the one that runs next.
+	 */
+	{ instrumentation.step(state, state) };
+};
+
+/**
+ * @brief Instrumentation that records nothing and compiles to nothing.
+ */
+struct no_instrumentation {
+	inline void start(auto) {}
+	inline void step(auto, auto) {}
+};
+
+/**
+ * @brief Runs the state whose 'states' contain the current enum value until 'on_state_change' returns false.
+ *
+ * Every state declares the enum values its 'run' may return in 'transitions'.
+ * Only these edges are instantiated and dispatched through a table, arguments of the
+ * next state are moved over from the current one as long as their types match
+ * position by position, the remaining ones are default constructed.
+ *
+ * Every step is reported to the instrumentation, which may be a reference
+ * so the recorded data outlives the state machine.
+ */
+template<class Instrumentation, class F, state_machine_state... States>
+class basic_state_machine {
 private:
 	template<class State>
 	using run_t = decltype(&State::run);
@@ -24,8 +62,16 @@ private:
 	>;
 	using enum_t = ztu::function::ret_t<run_t<ztu::first<States...>>>;
 
+	static_assert(state_machine_instrumentation<std::remove_reference_t<Instrumentation>, enum_t>);
+
+	static constexpr auto num_alternatives = std::variant_size_v<variant_t>;
+
+	using transition_t = void(*)(variant_t&);
+	using transition_table_t = std::array<std::array<transition_t, num_alternatives>, num_alternatives>;
+	using run_state_t = enum_t(*)(variant_t&, enum_t);
+
 public:
-	inline explicit state_machine(F&& on_state_change);
+	inline explicit basic_state_machine(F&& on_state_change, Instrumentation instrumentation = {});
 
 	template<class State, typename... Args>
 	inline enum_t run(enum_t InitialState, Args&&... args);
@@ -33,16 +79,47 @@ public:
 	template<typename... Args>
 	inline enum_t run(enum_t initial_state, Args&&... args);
 
+	/**
+	 * @brief Number of edges between different states, including the ones into the first state.
+	 *
+	 * Each one instantiates a single move of the arguments.
+	 */
+	static constexpr std::size_t num_transitions();
+
 private:
 	static constexpr auto invalid_index = 0;
-	inline static constexpr std::size_t to_index(enum_t e);
+	inline static constexpr std::size_t find_index(enum_t e);
+	inline static std::size_t to_index(enum_t e);
+
+	template<std::size_t Index>
+	static constexpr auto transition_targets();
+
+	static constexpr bool transitions_declared();
+
+	template<std::size_t SrcIndex, std::size_t DstIndex>
+	static void transition(variant_t &state);
+
+	template<std::size_t Index>
+	static enum_t run_state(variant_t &state, enum_t curr_state);
+
+	static constexpr transition_table_t make_transition_table();
+
+	static constexpr auto make_run_table();
+
+	static constexpr auto make_index_table();
+
+	inline enum_t run_loop(enum_t initial_state);
 
 private:
 
 	variant_t m_state{};
 	F m_on_state_change; // bool (*)(enum_t, enum_t&)
+	Instrumentation m_instrumentation;
 };
 
+template<class F, class... States>
+using state_machine = basic_state_machine<no_instrumentation, F, States...>;
+
 #define INCLUDE_STATE_MACHINE_IMPLEMENTATION
 #include <util/state_machine.ipp>
 #undef INCLUDE_STATE_MACHINE_IMPLEMENTATION
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <util/uix.hpp>
+#include <util/function.hpp>
+#include <array>
+#include <optional>
+#include <span>
+
+using namespace ztu::uix;
+
+namespace state_stats {
+
+	inline constexpr usize numBuckets = 16;
+	inline constexpr usize maxStates = 16;
+	inline constexpr usize maxNameLength = 24;
+
+	/**
+	 * @brief Histogram bucket of a dwell time.
+	 *
+	 * Bucket 0 holds times below 1ms, bucket b times in [2^(b-1), 2^b) ms and the last one everything longer.
+	 */
+	[[nodiscard]] constexpr usize bucket(i64 micros);
+
+	/**
+	 * @brief Everything recorded about one state, 'encode' writes it in the same layout on every platform.
+	 */
+	struct summary {
+		std::array<u32, numBuckets> histogram;	// completed visits per dwell time bucket
+		std::array<u32, maxStates> transitions;	// steps from this state into every state, staying included
+		u32 visits;
+		u32 totalMillis;						// of the completed visits
+		u32 maxMillis;
+		u32 currentMillis;						// of the ongoing visit, zero if the state is not active
+		std::array<char, maxNameLength> name;	// filled in by the owner of the state machine
+		u8 state;
+		u8 numStates;
+		bool active;
+	};
+
+	inline constexpr usize encodedSummarySize = (numBuckets + maxStates + 4) * sizeof(u32) + maxNameLength + 3;
+
+	/**
+	 * @brief Writes the fields of the summary one by one, 'dst' has to hold 'encodedSummarySize' bytes.
+	 * @return The number of bytes written, zero if 'dst' is too small.
+	 */
+	[[nodiscard]] inline usize encode(const summary &src, std::span<u8> dst);
+
+	[[nodiscard]] inline bool decode(std::span<const u8> src, summary &dst);
+}
+
+/**
+ * @brief Instrumentation policy of 'basic_state_machine' that records dwell times and transition counts.
+ *
+ * All memory is allocated up front, recording only updates a few counters.
+ * The stats are not synchronized, read them from the task running the state machine.
+ */
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+class state_machine_stats {
+public:
+	void start(Enum state);
+
+	void step(Enum from, Enum to);
+
+	/**
+	 * @return The stats of the state or 'std::nullopt' if it is out of range.
+	 */
+	[[nodiscard]] std::optional<state_stats::summary> summary(Enum state) const;
+
+	/**
+	 * @brief Number of steps taken by the state machine.
+	 */
+	[[nodiscard]] u64 steps() const;
+
+	void reset();
+
+private:
+	struct state_record {
+		std::array<u32, state_stats::numBuckets> histogram;
+		std::array<u32, NumStates> transitions;
+		u32 visits;
+		u64 totalMicros;
+		i64 maxMicros;
+	};
+
+	[[nodiscard]] static std::optional<usize> index(Enum state);
+
+	void enter(usize index, i64 now);
+
+	std::array<state_record, NumStates> m_states{};
+	std::optional<usize> m_current{};
+	i64 m_enteredAt{ 0 };
+	u64 m_steps{ 0 };
+};
+
+#define INCLUDE_STATE_MACHINE_STATS_IMPLEMENTATION
+#include <util/state_machine_stats.ipp>
+#undef INCLUDE_STATE_MACHINE_STATS_IMPLEMENTATION
@@ -594,7 +594,7 @@ ztu_ic string_literal<N>::this_type& string_literal<N>::replace(size_type index,
 
 template<sl_ssize_t N> requires (N > 0)
 ztu_nic bool string_literal<N>::operator==(const std::string &str) const {
-	const auto o_length = str.length();
+	const auto o_length = static_cast<size_type>(str.length());
 	for (size_type i = 0; i < o_length; i++) {
 		if (m_value[i] == '\0' or m_value[i] != str[i]) {
 			return false;
@@ -605,7 +605,7 @@ ztu_nic bool string_literal<N>::operator==(const std::string &str) const {
 
 template<sl_ssize_t N> requires (N > 0)
 ztu_nic bool string_literal<N>::operator==(const std::string_view &str) const {
-	const auto o_length = str.length();
+	const auto o_length = static_cast<size_type>(str.length());
 	for (size_type i = 0; i < o_length; i++) {
 		if (m_value[i] == '\0' or m_value[i] != str[i]) {
 			return false;
@@ -3,6 +3,7 @@
 #endif
 
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 
 
@@ -23,22 +24,23 @@ std::error_code aes_transceiver<Enum, Messages...>::encrypt_message(
 	const auto text_buffer_view = std::span<u8>{ m_text_buffer };
 	const auto packet_buffer_view = std::span<u8>{ m_packet_buffer };
 
-	usize header_size = 0;
-	auto type_buffer	= text_buffer_view.subspan(header_size, sizeof(type_integral_t));
-	header_size		  += type_buffer.size();
-	auto meta_buffer	= text_buffer_view.subspan(header_size, sizeof(meta_t));
-	header_size		  += meta_buffer.size();
+	// Every header is padded to the largest meta, so all header packets
+	// have the same size and the receiver knows how many bytes to read.
+	constexpr auto header_size = max_header_size;
+	auto type_buffer	= text_buffer_view.subspan(0, sizeof(type_integral_t));
+	auto meta_buffer	= text_buffer_view.subspan(type_buffer.size(), max_meta_size);
 
 	auto padded_header_size	= aes_256_info::cipherLength(header_size); // leave space for pkcs7
-	auto padded_body_buffer = text_buffer_view.subspan(padded_header_size, message::max_body_size);
+	auto padded_body_buffer = text_buffer_view.subspan(padded_header_size, aes_256_info::cipherLength(message::max_body_size));
 
 	meta_t meta;
 
-	if (not message::serialize(meta, padded_body_buffer, std::forward<const Args>(args)...))
+	if (not message::serialize(meta, padded_body_buffer.subspan(0, message::max_body_size), std::forward<const Args>(args)...))
 		return make_error_code(SERIALIZATION_ERROR);
 
 	constexpr auto type_index = static_cast<type_integral_t>(index);
 	std::copy_n(reinterpret_cast<const u8*>(&type_index), sizeof(type_integral_t), type_buffer.begin());
+	std::fill(meta_buffer.begin(), meta_buffer.end(), 0);
 	std::copy_n(reinterpret_cast<const u8*>(&meta      ), sizeof(meta_t         ), meta_buffer.begin());
 
 	std::error_code error;
@@ -85,7 +87,9 @@ std::error_code aes_transceiver<Enum, Messages...>::decrypt_header(
 		if (Index == type_index) {
 			
 			using meta_t = Message::meta_t;
-			const auto meta = *reinterpret_cast<const meta_t*>(header_buffer.data() + sizeof(type_index));
+			// The meta is not aligned inside the buffer.
+			meta_t meta;
+			std::memcpy(&meta, header_buffer.data() + sizeof(type_index), sizeof(meta_t));
 			const auto body_size = meta.body_size();
 			const auto body_packet_size = aes_256_info::ivSize + aes_256_info::cipherLength(body_size);
 
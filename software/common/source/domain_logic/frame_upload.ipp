@@ -0,0 +1,194 @@
+#ifndef INCLUDE_FRAME_UPLOAD_IMPLEMENTATION
+#error Never include this file directly include 'frame_upload.hpp'
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace frame_upload::detail {
+
+	template<typename T>
+	inline u8* put(u8 *dst, const T &value) {
+		std::memcpy(dst, &value, sizeof(T));
+		return dst + sizeof(T);
+	}
+
+	template<typename T>
+	inline const u8* take(const u8 *src, T &value) {
+		std::memcpy(&value, src, sizeof(T));
+		return src + sizeof(T);
+	}
+}
+
+inline ztu::usize frame_upload::encodeClips(std::span<const frame_clip_info> clips, std::span<u8> dst) {
+	const auto size = clips.size() * clipInfoSize;
+	if (clips.size() > maxClips or dst.size() < size)
+		return 0;
+
+	auto it = dst.data();
+	for (const auto &clip : clips) {
+		it = detail::put(it, clip.numFrames);
+		it = detail::put(it, clip.numPixels);
+	}
+
+	return size;
+}
+
+inline bool frame_upload::decodeClips(std::span<const u8> src, clip_list &list) {
+	if (src.size() % clipInfoSize != 0 or src.size() / clipInfoSize > maxClips)
+		return false;
+
+	list.numClips = static_cast<u16>(src.size() / clipInfoSize);
+
+	auto it = src.data();
+	for (auto &clip : std::span{ list.m_clips.begin(), list.numClips }) {
+		it = detail::take(it, clip.numFrames);
+		it = detail::take(it, clip.numPixels);
+	}
+
+	return true;
+}
+
+inline std::span<const u8> frame_upload::encodeChunk(const chunk &c, std::span<u8> dst) {
+	const auto size = chunkHeaderSize + c.data.size();
+	if (c.data.size() > chunkSize or dst.size() < size)
+		return {};
+
+	auto it = dst.data();
+	it = detail::put(it, c.uploadId);
+	it = detail::put(it, c.offset);
+	std::copy(c.data.begin(), c.data.end(), it);
+
+	return dst.subspan(0, size);
+}
+
+inline bool frame_upload::decodeChunk(std::span<const u8> src, chunk &c) {
+	if (src.size() < chunkHeaderSize + macSize or src.size() > maxChunkSize)
+		return false;
+
+	auto it = src.data();
+	it = detail::take(it, c.uploadId);
+	it = detail::take(it, c.offset);
+
+	c.signedBytes = src.subspan(0, src.size() - macSize);
+	c.data = c.signedBytes.subspan(chunkHeaderSize);
+	std::copy_n(c.signedBytes.end(), macSize, c.mac.begin());
+
+	return true;
+}
+
+template<hmac_sha_512_engine_concept engine_t>
+std::error_code frame_upload::authenticate(engine_t &engine, std::span<const u8> signedBytes, chunk_mac &mac) {
+	std::array<u8, 512 / 8> hash;
+	if (const auto e = engine.hash(signedBytes, hash); e)
+		return e;
+
+	std::copy_n(hash.begin(), mac.size(), mac.begin());
+
+	return {};
+}
+
+template<hmac_sha_512_engine_concept engine_t>
+bool frame_upload::verify(engine_t &engine, const chunk &c) {
+	chunk_mac expected;
+	if (authenticate(engine, c.signedBytes, expected))
+		return false;
+
+	// constant time, so the mac cannot be guessed byte by byte
+	u8 difference = 0;
+	for (usize i = 0; i < macSize; i++) {
+		difference |= expected[i] ^ c.mac[i];
+	}
+
+	return difference == 0;
+}
+
+
+template<frame_storage_concept storage_t>
+frame_upload_receiver<storage_t>::frame_upload_receiver(storage_t &storage)
+	: writer{ storage } {}
+
+template<frame_storage_concept storage_t>
+template<std::invocable F>
+frame_upload::reply frame_upload_receiver<storage_t>::begin(
+	u32 newUploadId, std::span<const frame_clip_info> newClips, F &&beforeErase
+) {
+	using namespace frame_upload;
+
+	const auto sameClips = std::ranges::equal(newClips, clips.clips(), [](const auto &a, const auto &b) {
+		return a.numFrames == b.numFrames and a.numPixels == b.numPixels;
+	});
+
+	if (inProgress and newUploadId == uploadId and sameClips) {
+		return { uploadId, nextOffset, status::READY };
+	}
+
+	inProgress = false;
+
+	if (newClips.size() > maxClips)
+		return fail(frame_library_error::make_error_code(frame_library_error::codes::LIBRARY_TOO_LARGE));
+
+	if (const auto e = writer.check(newClips); e)
+		return fail(e);
+
+	beforeErase();
+
+	if (const auto e = writer.begin(newClips); e)
+		return fail(e);
+
+	std::copy(newClips.begin(), newClips.end(), clips.m_clips.begin());
+	clips.numClips = static_cast<u16>(newClips.size());
+	uploadId = newUploadId;
+	nextOffset = 0;
+	inProgress = true;
+
+	return { uploadId, nextOffset, status::READY };
+}
+
+template<frame_storage_concept storage_t>
+template<hmac_sha_512_engine_concept engine_t>
+frame_upload::reply frame_upload_receiver<storage_t>::write(engine_t &engine, const frame_upload::chunk &c) {
+	using namespace frame_upload;
+
+	if (not inProgress or c.uploadId != uploadId)
+		return { c.uploadId, 0, status::FAILED };
+
+	// Out of order chunks are dropped as well, the plugin rewinds to the expected offset.
+	if (c.offset != nextOffset or not verify(engine, c))
+		return { uploadId, nextOffset, status::REJECTED };
+
+	if (const auto e = writer.write(c.offset, c.data); e)
+		return fail(e);
+
+	nextOffset += static_cast<u32>(c.data.size());
+
+	return { uploadId, nextOffset, status::READY };
+}
+
+template<frame_storage_concept storage_t>
+frame_upload::reply frame_upload_receiver<storage_t>::commit(u32 committedId) {
+	using namespace frame_upload;
+
+	if (not inProgress or committedId != uploadId or nextOffset != writer.dataSize())
+		return { committedId, nextOffset, status::FAILED };
+
+	inProgress = false;
+
+	if (const auto e = writer.finish(); e)
+		return fail(e);
+
+	return { uploadId, nextOffset, status::COMPLETE };
+}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_upload_receiver<storage_t>::error() const {
+	return lastError;
+}
+
+template<frame_storage_concept storage_t>
+frame_upload::reply frame_upload_receiver<storage_t>::fail(const std::error_code &e) {
+	lastError = e;
+	inProgress = false;
+	return { uploadId, 0, frame_upload::status::FAILED };
+}
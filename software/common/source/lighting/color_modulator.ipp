@@ -0,0 +1,83 @@
+#ifndef INCLUDE_COLOR_MODULATOR_IMPLEMENTATION
+#error Never include this file directly include 'color_modulator.hpp'
+#endif
+
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+inline color_modulator::color_modulator(const animation_params &params) {
+
+	if (params.brightness == U8_MAX and params.hueShift == 0) {
+		m_mode = mode::IDENTITY;
+		return;
+	}
+
+	constexpr auto one = static_cast<float>(1 << fractionBits);
+	const auto gain = static_cast<float>(params.brightness) / static_cast<float>(U8_MAX);
+
+	const auto toFixed = [&](float x) {
+		return static_cast<i32>(std::lround(x * gain * one));
+	};
+
+	if (params.hueShift == 0) {
+		m_mode = mode::SCALE;
+		m_matrix[0] = toFixed(1.0f);
+		return;
+	}
+
+	// Rotation around the gray axis of the rgb cube.
+	constexpr auto third = 1.0f / 3.0f;
+	const auto sqrtThird = std::sqrt(third);
+	const auto angle = static_cast<float>(params.hueShift) * (2.0f * std::numbers::pi_v<float> / 256.0f);
+	const auto cosA = std::cos(angle);
+	const auto sinA = std::sin(angle);
+
+	const auto diagonal	= toFixed(cosA + (1.0f - cosA) * third);
+	const auto behind	= toFixed((1.0f - cosA) * third - sqrtThird * sinA);
+	const auto ahead	= toFixed((1.0f - cosA) * third + sqrtThird * sinA);
+
+	m_mode = mode::MATRIX;
+	m_matrix = {
+		diagonal, behind, ahead,
+		ahead, diagonal, behind,
+		behind, ahead, diagonal
+	};
+}
+
+inline void color_modulator::operator()(std::span<color> colors) const {
+
+	constexpr auto half = i32{ 1 } << (fractionBits - 1);
+
+	const auto toChannel = [](i32 x) {
+		return static_cast<u8>(std::clamp<i32>((x + half) >> fractionBits, U8_MIN, U8_MAX));
+	};
+
+	switch (m_mode) {
+		case mode::IDENTITY:
+			break;
+		case mode::SCALE: {
+			const auto scale = m_matrix[0];
+			for (auto &c : colors) {
+				c = {
+					toChannel(c.r * scale),
+					toChannel(c.g * scale),
+					toChannel(c.b * scale)
+				};
+			}
+			break;
+		}
+		case mode::MATRIX: {
+			const auto &m = m_matrix;
+			for (auto &c : colors) {
+				const i32 r = c.r, g = c.g, b = c.b;
+				c = {
+					toChannel(m[0] * r + m[1] * g + m[2] * b),
+					toChannel(m[3] * r + m[4] * g + m[5] * b),
+					toChannel(m[6] * r + m[7] * g + m[8] * b)
+				};
+			}
+			break;
+		}
+	}
+}
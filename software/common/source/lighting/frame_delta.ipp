@@ -0,0 +1,136 @@
+#ifndef INCLUDE_FRAME_DELTA_IMPLEMENTATION
+#error Never include this file directly include 'frame_delta.hpp'
+#endif
+
+#include <algorithm>
+
+namespace frame_delta::detail {
+
+	inline void write_u16(u8 *dst, u16 value) {
+		dst[0] = static_cast<u8>(value);
+		dst[1] = static_cast<u8>(value >> 8);
+	}
+
+	inline u16 read_u16(const u8 *src) {
+		return static_cast<u16>(src[0] | (src[1] << 8));
+	}
+
+	inline u8 *write_colors(u8 *dst, std::span<const color> colors) {
+		for (const auto &c : colors) {
+			*dst++ = c.r;
+			*dst++ = c.g;
+			*dst++ = c.b;
+		}
+		return dst;
+	}
+
+	inline usize encode_key(std::span<const color> current, u8 *dst) {
+		dst[0] = static_cast<u8>(kind::KEY);
+		dst[1] = 0;
+		write_u16(dst + 2, static_cast<u16>(current.size()));
+		return write_colors(dst + header_size, current) - dst;
+	}
+}
+
+inline ztu::usize frame_delta::encode(std::span<const color> previous, std::span<const color> current, std::span<u8> dst) {
+	using namespace detail;
+
+	const auto numPixels = current.size();
+	const auto keySize = max_encoded_size(numPixels);
+
+	if (previous.size() != numPixels)
+		return encode_key(current, dst.data());
+
+	dst[0] = static_cast<u8>(kind::DELTA);
+	dst[1] = 0;
+	write_u16(dst.data() + 2, static_cast<u16>(numPixels));
+
+	const auto changed = [&](usize i) { return previous[i] != current[i]; };
+
+	// merging a gap of unchanged pixels into the run is cheaper than starting a new one
+	constexpr auto maxMergedGap = run_header_size / color_size;
+
+	auto size = header_size;
+	for (usize runEnd = 0, i = 0; i < numPixels;) {
+		if (not changed(i)) {
+			i++;
+			continue;
+		}
+
+		const auto runBegin = i;
+		auto end = i + 1;
+		while (end < numPixels) {
+			if (changed(end)) {
+				end++;
+				continue;
+			}
+			auto next = end;
+			while (next < numPixels and not changed(next) and next - end < maxMergedGap) {
+				next++;
+			}
+			if (next == numPixels or not changed(next))
+				break;
+			end = next;
+		}
+
+		const auto count = end - runBegin;
+		size += run_header_size + count * color_size;
+		if (size >= keySize)
+			return encode_key(current, dst.data());
+
+		auto *run = dst.data() + size - run_header_size - count * color_size;
+		write_u16(run, static_cast<u16>(runBegin - runEnd));
+		write_u16(run + 2, static_cast<u16>(count));
+		write_colors(run + run_header_size, current.subspan(runBegin, count));
+
+		runEnd = end;
+		i = end;
+	}
+
+	return size;
+}
+
+inline bool frame_delta::decode(std::span<const u8> src, std::span<color> frame) {
+	using namespace detail;
+
+	if (src.size() < header_size or read_u16(src.data() + 2) != frame.size())
+		return false;
+
+	const auto read_colors = [&](usize offset, usize pixel, usize count) {
+		for (usize i = 0; i != count; i++) {
+			const auto *c = src.data() + offset + i * color_size;
+			frame[pixel + i] = { c[0], c[1], c[2] };
+		}
+	};
+
+	switch (static_cast<kind>(src[0])) {
+		case kind::KEY:
+			if (src.size() != max_encoded_size(frame.size()))
+				return false;
+			read_colors(header_size, 0, frame.size());
+			return true;
+
+		case kind::DELTA: {
+			usize offset = header_size, pixel = 0;
+			while (offset != src.size()) {
+				if (src.size() - offset < run_header_size)
+					return false;
+
+				pixel += read_u16(src.data() + offset);
+				const usize count = read_u16(src.data() + offset + 2);
+				offset += run_header_size;
+
+				if (pixel > frame.size() or frame.size() - pixel < count or (src.size() - offset) / color_size < count)
+					return false;
+
+				read_colors(offset, pixel, count);
+				offset += count * color_size;
+				pixel += count;
+			}
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
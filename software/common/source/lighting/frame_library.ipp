@@ -0,0 +1,215 @@
+#ifndef INCLUDE_FRAME_LIBRARY_IMPLEMENTATION
+#error Never include this file directly include 'frame_library.hpp'
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+inline void frame_clip::render(const u32 frameIndex, std::span<color> dst, const usize firstPixel) const {
+	using frame_library_format::color_size;
+
+	const auto frameSize = static_cast<usize>(numPixels) * color_size;
+	const auto frame = data.subspan((frameIndex % numFrames) * frameSize, frameSize);
+
+	for (usize i = 0, p = (firstPixel % numPixels) * color_size; i < dst.size(); i++) {
+		dst[i] = { frame[p], frame[p + 1], frame[p + 2] };
+		p += color_size;
+		if (p == frameSize) {
+			p = 0;
+		}
+	}
+}
+
+inline std::optional<frame_library> frame_library::open(std::span<const u8> region) {
+	using namespace frame_library_format;
+
+	if (region.size() < sizeof(header))
+		return std::nullopt;
+
+	header head;
+	std::memcpy(&head, region.data(), sizeof(head));
+
+	if (head.magic != magic or head.version != version)
+		return std::nullopt;
+
+	const auto tableSize = static_cast<usize>(head.numClips) * sizeof(clip_entry);
+	if (region.size() - sizeof(header) < tableSize)
+		return std::nullopt;
+
+	const auto dataBegin = sizeof(header) + tableSize;
+	if (region.size() - dataBegin < head.dataSize)
+		return std::nullopt;
+
+	frame_library library;
+	library.clipTable = region.subspan(sizeof(header), tableSize);
+	library.frameData = region.subspan(dataBegin, head.dataSize);
+	return library;
+}
+
+inline usize frame_library::size() const {
+	return clipTable.size() / sizeof(frame_library_format::clip_entry);
+}
+
+inline std::optional<frame_clip> frame_library::clip(usize index) const {
+	using namespace frame_library_format;
+
+	if (index >= size())
+		return std::nullopt;
+
+	clip_entry entry;
+	std::memcpy(&entry, clipTable.data() + index * sizeof(entry), sizeof(entry));
+
+	// entries are checked here instead of in 'open', so a single broken clip does not disable the others
+	const auto clipSize = static_cast<usize>(entry.numFrames) * entry.numPixels * color_size;
+	if (clipSize == 0 or entry.offset > frameData.size() or frameData.size() - entry.offset < clipSize)
+		return std::nullopt;
+
+	return frame_clip{
+		.data = frameData.subspan(entry.offset, clipSize),
+		.numFrames = entry.numFrames,
+		.numPixels = entry.numPixels
+	};
+}
+
+inline std::span<const u8> frame_library::data() const {
+	return frameData;
+}
+
+inline const frame_library* frame_library::active() {
+	return activeLibrary.load(std::memory_order_acquire);
+}
+
+inline void frame_library::activate(const frame_library *library) {
+	activeLibrary.store(library, std::memory_order_release);
+}
+
+
+template<frame_storage_concept storage_t>
+frame_library_writer<storage_t>::frame_library_writer(storage_t &newStorage)
+	: storage{ newStorage } {}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_library_writer<storage_t>::check(std::span<const frame_clip_info> clips) const {
+	using namespace frame_library_format;
+	using enum frame_library_error::codes;
+
+	if (clips.size() > std::numeric_limits<u16>::max())
+		return make_error_code(LIBRARY_TOO_LARGE);
+
+	usize totalDataSize = 0;
+	for (const auto &clip : clips) {
+		if (clip.numFrames == 0 or clip.numPixels == 0)
+			return make_error_code(INVALID_CLIP);
+		totalDataSize += static_cast<usize>(clip.numFrames) * clip.numPixels * color_size;
+	}
+
+	const auto tableSize = clips.size() * sizeof(clip_entry);
+	if (totalDataSize > std::numeric_limits<u32>::max() or sizeof(header) + tableSize + totalDataSize > storage.size())
+		return make_error_code(LIBRARY_TOO_LARGE);
+
+	return {};
+}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_library_writer<storage_t>::begin(std::span<const frame_clip_info> clips) {
+	using namespace frame_library_format;
+
+	started = false;
+
+	if (const auto e = check(clips); e)
+		return e;
+
+	dataOffset = sizeof(header) + clips.size() * sizeof(clip_entry);
+
+	usize totalDataSize = 0;
+	for (const auto &clip : clips) {
+		totalDataSize += static_cast<usize>(clip.numFrames) * clip.numPixels * color_size;
+	}
+
+	// the header is erased as well, which invalidates the previous library until 'finish' is called
+	erasedUntil = 0;
+	if (const auto e = eraseUntil(dataOffset); e)
+		return e;
+
+	u32 offset = 0;
+	for (usize i = 0; i < clips.size(); i++) {
+		const clip_entry entry{
+			.offset = offset,
+			.numFrames = clips[i].numFrames,
+			.numPixels = clips[i].numPixels,
+			.reserved = 0
+		};
+		const auto bytes = std::as_bytes(std::span{ &entry, 1 });
+		const auto e = storage.write(
+			sizeof(header) + i * sizeof(entry),
+			{ reinterpret_cast<const u8*>(bytes.data()), bytes.size() }
+		);
+		if (e) return e;
+		offset += clips[i].numFrames * clips[i].numPixels * color_size;
+	}
+
+	numClips = static_cast<u16>(clips.size());
+	numDataBytes = static_cast<u32>(totalDataSize);
+	started = true;
+
+	return {};
+}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_library_writer<storage_t>::write(usize offset, std::span<const u8> chunk) {
+	using enum frame_library_error::codes;
+
+	if (not started)
+		return make_error_code(NOT_STARTED);
+
+	if (offset > numDataBytes or numDataBytes - offset < chunk.size())
+		return make_error_code(CHUNK_OUT_OF_RANGE);
+
+	if (const auto e = eraseUntil(dataOffset + offset + chunk.size()); e)
+		return e;
+
+	return storage.write(dataOffset + offset, chunk);
+}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_library_writer<storage_t>::finish() {
+	using namespace frame_library_format;
+	using enum frame_library_error::codes;
+
+	if (not started)
+		return make_error_code(NOT_STARTED);
+
+	const header head{
+		.magic = magic,
+		.version = version,
+		.numClips = numClips,
+		.dataSize = numDataBytes
+	};
+	const auto bytes = std::as_bytes(std::span{ &head, 1 });
+
+	started = false;
+
+	return storage.write(0, { reinterpret_cast<const u8*>(bytes.data()), bytes.size() });
+}
+
+template<frame_storage_concept storage_t>
+usize frame_library_writer<storage_t>::dataSize() const {
+	return numDataBytes;
+}
+
+template<frame_storage_concept storage_t>
+std::error_code frame_library_writer<storage_t>::eraseUntil(usize end) {
+	if (end <= erasedUntil)
+		return {};
+
+	const auto blockSize = storage.block_size();
+	const auto alignedEnd = std::min((end + blockSize - 1) / blockSize * blockSize, storage.size());
+
+	if (const auto e = storage.erase(erasedUntil, alignedEnd - erasedUntil); e)
+		return e;
+
+	erasedUntil = alignedEnd;
+
+	return {};
+}
@@ -0,0 +1,109 @@
+#ifndef INCLUDE_CLOCK_ESTIMATOR_IMPLEMENTATION
+#error Never include this file directly include 'clock_estimator.hpp'
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+inline constexpr clock_sample clock_sample::from_exchange(i64 t0, i64 t1, i64 t2, i64 t3) {
+	// Time spent on the local side does not count towards the network delay.
+	const auto delay = std::max<i64>((t3 - t0) - (t2 - t1), 0);
+	return {
+		.local = t1,
+		.reference = t0 + delay / 2,
+		.delay = delay
+	};
+}
+
+inline constexpr i64 clock_mapping::toReference(i64 local) const {
+	return local + anchorOffset + (local - anchorLocal) * skewPpb / 1'000'000'000;
+}
+
+inline constexpr i64 clock_mapping::toLocal(i64 reference) const {
+	const auto local = reference - anchorOffset;
+	return local - (local - anchorLocal) * skewPpb / 1'000'000'000;
+}
+
+template<usize NumSamples>
+inline void clock_estimator<NumSamples>::addSample(const clock_sample &sample) {
+	if (m_mapping.synchronized) {
+		const auto error = m_mapping.toReference(sample.local) - sample.reference;
+		if (error > stepThreshold or error < -stepThreshold) {
+			reset();
+		}
+	}
+
+	m_samples[m_next] = sample;
+	m_next = (m_next + 1) % NumSamples;
+	m_count = std::min(m_count + 1, NumSamples);
+
+	estimate();
+}
+
+template<usize NumSamples>
+inline void clock_estimator<NumSamples>::reset() {
+	m_count = 0;
+	m_next = 0;
+	m_mapping = {};
+}
+
+template<usize NumSamples>
+inline const clock_mapping& clock_estimator<NumSamples>::mapping() const {
+	return m_mapping;
+}
+
+template<usize NumSamples>
+inline void clock_estimator<NumSamples>::estimate() {
+
+	const auto samples = std::span{ m_samples.begin(), m_count };
+	const auto &newest = m_samples[(m_next + NumSamples - 1) % NumSamples];
+
+	// Exchanges that got stuck in a queue have asymmetric delays, only trust the fast ones.
+	const auto minDelay = std::ranges::min(samples, {}, &clock_sample::delay).delay;
+	const auto maxDelay = 2 * minDelay + 1'000;
+
+	const auto offsetBase = newest.reference - newest.local;
+
+	double n = 0.0, sumX = 0.0, sumY = 0.0;
+	i64 minLocal = newest.local, maxLocal = newest.local;
+	for (const auto &sample : samples) {
+		if (sample.delay > maxDelay)
+			continue;
+		n += 1.0;
+		sumX += static_cast<double>(sample.local - newest.local);
+		sumY += static_cast<double>(sample.reference - sample.local - offsetBase);
+		minLocal = std::min(minLocal, sample.local);
+		maxLocal = std::max(maxLocal, sample.local);
+	}
+
+	const auto meanX = sumX / n;
+	const auto meanY = sumY / n;
+
+	auto skew = static_cast<double>(m_mapping.skewPpb) * 1e-9;
+
+	if (maxLocal - minLocal >= minSkewSpan) {
+		double covariance = 0.0, variance = 0.0;
+		for (const auto &sample : samples) {
+			if (sample.delay > maxDelay)
+				continue;
+			const auto dx = static_cast<double>(sample.local - newest.local) - meanX;
+			const auto dy = static_cast<double>(sample.reference - sample.local - offsetBase) - meanY;
+			covariance += dx * dy;
+			variance += dx * dx;
+		}
+		if (variance > 0.0) {
+			skew = covariance / variance;
+		}
+	}
+
+	const auto skewPpb = std::clamp<i64>(std::llround(skew * 1e9), -maxSkewPpb, maxSkewPpb);
+	skew = static_cast<double>(skewPpb) * 1e-9;
+
+	m_mapping = {
+		.anchorLocal = newest.local,
+		.anchorOffset = offsetBase + std::llround(meanY - skew * meanX),
+		.skewPpb = static_cast<i32>(skewPpb),
+		.synchronized = true
+	};
+}
@@ -3,8 +3,8 @@
 #endif
 
 #include <algorithm>
-//#include <cassert>
-#include <util/variant_visit.hpp>
+#include <cassert>
+#include <util/for_each.hpp>
 
 
 namespace detail {
@@ -85,31 +85,13 @@ namespace detail {
 			return false;
 		}(std::make_index_sequence<num_member_matches>{}, std::make_index_sequence<num_default_members>{});
 	}
-
-	template<class Variant, typename... Args>
-	inline void variant_tuple_move(Variant &variant, std::size_t dst_index, Args&&... args) {
-		// This function is responsible for a huge explosion in binary size...s
-		const auto src_index = variant.index();
-		constexpr auto size = std::variant_size_v<Variant>;
-		ztu::for_each::index<size>([&]<auto I>() {
-			return ztu::for_each::index<size>([&]<auto J>() {
-				if (I == src_index and J == dst_index) {
-					if constexpr (I != J) {
-						variant_tuple_move_impl<I, J>(variant, std::forward<Args>(args)...);
-					}
-					return true;
-				}
-				return false;
-			});
-		});
-	}
 }
 
-template<class F, class... States>
-constexpr std::size_t state_machine<F, States...>::to_index(enum_t e) {
-	ssize_t index = invalid_index;
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr std::size_t basic_state_machine<Instrumentation, F, States...>::find_index(enum_t e) {
+	std::size_t index = invalid_index;
 	ztu::for_each::indexed_type<States...>([&]<auto Index, typename State>() {
-		static constexpr auto &states = State::states;
+		constexpr auto &states = State::states;
 		if (std::find(states.begin(), states.end(), e) != states.end()) {
 			index = Index + 1;
 			return true;
@@ -119,57 +101,179 @@ constexpr std::size_t state_machine<F, States...>::to_index(enum_t e) {
 	return index;
 }
 
-template<class F, class... States>
-state_machine<F, States...>::state_machine(F&& on_state_change)
-	: m_on_state_change{ std::forward<F>(on_state_change) }{}
+template<class Instrumentation, class F, state_machine_state... States>
+std::size_t basic_state_machine<Instrumentation, F, States...>::to_index(enum_t e) {
+	static constexpr auto indices = make_index_table();
+	const auto value = static_cast<std::size_t>(e);
+	return value < indices.size() ? indices[value] : invalid_index;
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+template<std::size_t Index>
+constexpr auto basic_state_machine<Instrumentation, F, States...>::transition_targets() {
+	if constexpr (Index == invalid_index) {
+		// the first state can be any of them
+		std::array<std::size_t, num_alternatives - 1> targets;
+		for (std::size_t i = 0; i < targets.size(); i++) {
+			targets[i] = i + 1;
+		}
+		return targets;
+	} else {
+		using state_t = ztu::at<Index - 1, States...>;
+		std::array<std::size_t, state_t::transitions.size()> targets;
+		std::transform(state_t::transitions.begin(), state_t::transitions.end(), targets.begin(), find_index);
+		return targets;
+	}
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr bool basic_state_machine<Instrumentation, F, States...>::transitions_declared() {
+	return [&]<auto... Is>(std::index_sequence<Is...>) {
+		const auto valid = [&](const auto &targets) {
+			return std::find(targets.begin(), targets.end(), invalid_index) == targets.end();
+		};
+		return (valid(transition_targets<Is>()) and ...);
+	}(std::make_index_sequence<num_alternatives>{});
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr std::size_t basic_state_machine<Instrumentation, F, States...>::num_transitions() {
+	const auto table = make_transition_table();
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < num_alternatives; i++) {
+		for (std::size_t j = 0; j < num_alternatives; j++) {
+			count += i != j and table[i][j] != nullptr;
+		}
+	}
+	return count;
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+template<std::size_t SrcIndex, std::size_t DstIndex>
+void basic_state_machine<Instrumentation, F, States...>::transition(variant_t &state) {
+	if constexpr (SrcIndex != DstIndex) {
+		detail::variant_tuple_move_impl<SrcIndex, DstIndex>(state);
+	}
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+template<std::size_t Index>
+basic_state_machine<Instrumentation, F, States...>::enum_t basic_state_machine<Instrumentation, F, States...>::run_state(variant_t &state, enum_t curr_state) {
+	using state_t = ztu::at<Index - 1, States...>;
+	return std::apply([&](auto&... args) {
+		return state_t::run(curr_state, args...);
+	}, *std::get_if<Index>(&state));
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr basic_state_machine<Instrumentation, F, States...>::transition_table_t basic_state_machine<Instrumentation, F, States...>::make_transition_table() {
+	transition_table_t table{};
+	ztu::for_each::index<num_alternatives>([&]<auto Src>() {
+		constexpr auto num_targets = transition_targets<Src>().size();
+		[&]<auto... Ts>(std::index_sequence<Ts...>) {
+			((table[Src][transition_targets<Src>()[Ts]] = &transition<Src, transition_targets<Src>()[Ts]>), ...);
+		}(std::make_index_sequence<num_targets>{});
+		return false;
+	});
+	return table;
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr auto basic_state_machine<Instrumentation, F, States...>::make_run_table() {
+	return []<auto... Is>(std::index_sequence<Is...>) {
+		return std::array<run_state_t, num_alternatives>{
+			nullptr, &run_state<Is + 1>...
+		};
+	}(std::make_index_sequence<sizeof...(States)>{});
+}
 
+template<class Instrumentation, class F, state_machine_state... States>
+constexpr auto basic_state_machine<Instrumentation, F, States...>::make_index_table() {
+	constexpr auto size = []() {
+		std::size_t max_value = 0;
+		ztu::for_each::type<States...>([&]<typename State>() {
+			for (const auto state : State::states) {
+				max_value = std::max(max_value, static_cast<std::size_t>(state));
+			}
+			return false;
+		});
+		return max_value + 1;
+	}();
 
-template<class F, class... States>
+	std::array<std::size_t, size> indices{};
+	for (std::size_t value = 0; value < size; value++) {
+		indices[value] = find_index(static_cast<enum_t>(value));
+	}
+	return indices;
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+basic_state_machine<Instrumentation, F, States...>::basic_state_machine(F&& on_state_change, Instrumentation instrumentation)
+	: m_on_state_change{ std::forward<F>(on_state_change) }, m_instrumentation{ instrumentation } {}
+
+
+template<class Instrumentation, class F, state_machine_state... States>
 template<class State, typename... Args>
-state_machine<F, States...>::enum_t state_machine<F, States...>::run(
-	typename state_machine<F, States...>::enum_t initial_state,
+basic_state_machine<Instrumentation, F, States...>::enum_t basic_state_machine<Instrumentation, F, States...>::run(
+	typename basic_state_machine<Instrumentation, F, States...>::enum_t initial_state,
 	Args&&... args
 ) {
-
 	ztu::for_each::indexed_type<States...>([&]<auto Index, typename T>() {
 		if constexpr (std::same_as<T, State>) {
-			m_state.template emplace<Index>(std::forward<Args>(args)...);
+			m_state.template emplace<Index + 1>(std::forward<Args>(args)...);
 			return true;
 		}
 		return false;
 	});
 
+	return run_loop(initial_state);
+}
+
+template<class Instrumentation, class F, state_machine_state... States>
+basic_state_machine<Instrumentation, F, States...>::enum_t basic_state_machine<Instrumentation, F, States...>::run_loop(enum_t initial_state) {
+	static_assert(transitions_declared(), "Every transition has to lead to one of the states");
+
+	static constexpr auto transitions = make_transition_table();
+	static constexpr auto run_states = make_run_table();
+
+	m_instrumentation.start(initial_state);
+
 	enum_t curr_state, next_state{ initial_state };
+	bool running;
 	do {
+		const auto curr_index = m_state.index();
 		const auto next_index = to_index(next_state);
 
-		detail::variant_tuple_move(
-			m_state, next_index
-		);
-
-		curr_state = next_state;
+		if (next_index == invalid_index) {
+			assert(false);
+			break;
+		}
 
-		ztu::indexed_visit([&]<auto Index>(auto& data) {
-			if constexpr (Index != invalid_index) {
-				std::apply([&](auto&... args) {
-					using state_t = ztu::at<Index - 1, States...>;
-					next_state = state_t::run(curr_state, args...);
-				}, data);
-			} else {
+		if (next_index != curr_index) {
+			const auto transition = transitions[curr_index][next_index];
+			if (transition == nullptr) {
+				// 'next_state' is missing in the 'transitions' of the current state
 				assert(false);
+				break;
 			}
-		}, m_state);
-		
-	} while (m_on_state_change(curr_state, next_state));
+			transition(m_state);
+		}
+
+		curr_state = next_state;
+		next_state = run_states[next_index](m_state, curr_state);
+
+		running = m_on_state_change(curr_state, next_state);
+		m_instrumentation.step(curr_state, next_state);
+
+	} while (running);
 
 	return next_state;
 }
 
-template<class F, class... States>
+template<class Instrumentation, class F, state_machine_state... States>
 template<typename... Args>
-state_machine<F, States...>::enum_t state_machine<F, States...>::run(state_machine<F, States...>::enum_t initial_state, Args&&... args) {
+basic_state_machine<Instrumentation, F, States...>::enum_t basic_state_machine<Instrumentation, F, States...>::run(basic_state_machine<Instrumentation, F, States...>::enum_t initial_state, Args&&... args) {
 	const auto initial_index = to_index(initial_state);
-	enum_t state = initial_state;
 	[&]<auto... Is>(std::index_sequence<Is...>) {
 		[[maybe_unused]] const auto ran = (
 			[&]<auto I>() {
@@ -179,7 +283,7 @@ state_machine<F, States...>::enum_t state_machine<F, States...>::run(state_machi
 					std::is_constructible_v<state_t, Args...>
 				) {
 					if (I == initial_index) {
-						state = run<state_t, Args...>(initial_state, std::forward<Args>(args)...);
+						m_state.template emplace<I>(std::forward<Args>(args)...);
 						return true;
 					}
 				}
@@ -188,5 +292,5 @@ state_machine<F, States...>::enum_t state_machine<F, States...>::run(state_machi
 		);
 		// assert(ran); // TODO find solution
 	}(std::make_index_sequence<std::variant_size_v<variant_t>>{});
-	return state;
+	return run_loop(initial_state);
 }
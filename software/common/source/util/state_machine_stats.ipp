@@ -0,0 +1,151 @@
+#ifndef INCLUDE_STATE_MACHINE_STATS_IMPLEMENTATION
+#error Never include this file directly include 'state_machine_stats.hpp'
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <util/byte_fields.hpp>
+
+constexpr ztu::usize state_stats::bucket(i64 micros) {
+	const auto millis = static_cast<u64>(std::max<i64>(micros, 0) / 1000);
+	return std::min<usize>(std::bit_width(millis), numBuckets - 1);
+}
+
+inline ztu::usize state_stats::encode(const summary &src, std::span<u8> dst) {
+	using ztu::byte_fields::put;
+
+	if (dst.size() < encodedSummarySize)
+		return 0;
+
+	auto it = dst.data();
+	it = put(it, src.histogram);
+	it = put(it, src.transitions);
+	it = put(it, src.visits);
+	it = put(it, src.totalMillis);
+	it = put(it, src.maxMillis);
+	it = put(it, src.currentMillis);
+	it = put(it, src.name);
+	it = put(it, src.state);
+	it = put(it, src.numStates);
+	it = put(it, static_cast<u8>(src.active));
+
+	return static_cast<usize>(it - dst.data());
+}
+
+inline bool state_stats::decode(std::span<const u8> src, summary &dst) {
+	using ztu::byte_fields::take;
+
+	if (src.size() != encodedSummarySize)
+		return false;
+
+	u8 active;
+	auto it = src.data();
+	it = take(it, dst.histogram);
+	it = take(it, dst.transitions);
+	it = take(it, dst.visits);
+	it = take(it, dst.totalMillis);
+	it = take(it, dst.maxMillis);
+	it = take(it, dst.currentMillis);
+	it = take(it, dst.name);
+	it = take(it, dst.state);
+	it = take(it, dst.numStates);
+	take(it, active);
+	dst.active = active != 0;
+
+	return true;
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+void state_machine_stats<Enum, NumStates, Clock>::start(Enum state) {
+	m_current = std::nullopt;
+	if (const auto i = index(state); i) {
+		enter(*i, Clock());
+	}
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+void state_machine_stats<Enum, NumStates, Clock>::step(Enum from, Enum to) {
+	m_steps++;
+
+	const auto src = index(from), dst = index(to);
+	if (not src or not dst)
+		return;
+
+	auto &record = m_states[*src];
+	record.transitions[*dst]++;
+
+	if (*src == *dst)
+		return;
+
+	const auto now = Clock();
+	if (m_current == src) {
+		const auto dwell = now - m_enteredAt;
+		record.histogram[state_stats::bucket(dwell)]++;
+		record.totalMicros += static_cast<u64>(std::max<i64>(dwell, 0));
+		record.maxMicros = std::max(record.maxMicros, dwell);
+	}
+
+	enter(*dst, now);
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+std::optional<state_stats::summary> state_machine_stats<Enum, NumStates, Clock>::summary(Enum state) const {
+	const auto i = index(state);
+	if (not i)
+		return std::nullopt;
+
+	const auto &record = m_states[*i];
+	const auto millis = [](u64 micros) {
+		return static_cast<u32>(std::min<u64>(micros / 1000, std::numeric_limits<u32>::max()));
+	};
+
+	state_stats::summary summary{};
+	summary.histogram = record.histogram;
+	std::copy(record.transitions.begin(), record.transitions.end(), summary.transitions.begin());
+	summary.visits = record.visits;
+	summary.totalMillis = millis(record.totalMicros);
+	summary.maxMillis = millis(static_cast<u64>(record.maxMicros));
+	summary.active = m_current == i;
+	summary.currentMillis = summary.active ? millis(static_cast<u64>(std::max<i64>(Clock() - m_enteredAt, 0))) : 0;
+	summary.state = static_cast<u8>(*i);
+	summary.numStates = static_cast<u8>(NumStates);
+
+	return summary;
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+u64 state_machine_stats<Enum, NumStates, Clock>::steps() const {
+	return m_steps;
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+void state_machine_stats<Enum, NumStates, Clock>::reset() {
+	m_states = {};
+	m_steps = 0;
+	if (m_current) {
+		enter(*m_current, Clock());
+	}
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+std::optional<ztu::usize> state_machine_stats<Enum, NumStates, Clock>::index(Enum state) {
+	const auto i = static_cast<usize>(state);
+	if (i < NumStates)
+		return i;
+	return std::nullopt;
+}
+
+template<typename Enum, std::size_t NumStates, auto Clock>
+	requires (NumStates <= state_stats::maxStates and ztu::supplier<decltype(Clock), i64>)
+void state_machine_stats<Enum, NumStates, Clock>::enter(usize index, i64 now) {
+	m_states[index].visits++;
+	m_current = index;
+	m_enteredAt = now;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <domain_logic/sign_animation.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Every animation type with each of its mix types and scalers,
+ * as rendered by 'animation_renderer' and checked by 'animation_golden_frames'.
+ * 'library_stop_motion' needs a frame library and is left to 'frame_library_player'.
+ */
+namespace animation_corpus {
+
+	struct entry {
+		std::string name;
+		sign_animation animation;
+	};
+
+	inline constexpr auto secondsPerColor = 2.0;
+
+	inline constexpr const char *mixNames[] = {
+		"LINEAR_INTERPOLATION", "FADE_IN_OUT", "PWM", "RAMP", "NO_MIXING"
+	};
+
+	inline constexpr const char *scalerNames[] = {
+		"PING_PONG", "SINUS", "RANDOM", "SMOOTH_RANDOM"
+	};
+
+	inline sign_sequencer sequence(sign_mix_type mixType) {
+		return {
+			.supplier = sign_suppliers::sequence(colors::red, colors::yellow, colors::turquoise, colors::pink),
+			.mixType = mixType
+		};
+	}
+
+	inline std::vector<entry> make() {
+		std::vector<entry> corpus;
+
+		// seeded by their name, so random animations render the same colors every time
+		const auto add = [&](std::string name, const sign_basic_animation &animator) {
+			sign_animation animation(animator, secondsPerColor);
+			animation.seed = 0x811c9dc5;
+			for (const auto c : name) {
+				animation.seed = (animation.seed ^ static_cast<u8>(c)) * 0x01000193;
+			}
+			corpus.push_back({ std::move(name), animation });
+		};
+
+		for (u8 m = 0; m != std::size(mixNames); m++) {
+			const auto mixType = static_cast<sign_mix_type>(m);
+			add(std::string("UNIFORM_COLOR ") + mixNames[m], sign_animations::uniform_color(sequence(mixType)));
+			add(std::string("MOVING_COLORS ") + mixNames[m], sign_animations::moving_colors(sequence(mixType), 64));
+		}
+
+		add("UNIFORM_COLOR RANDOM", sign_animations::uniform_color(sign_sequencer{
+			.supplier = sign_suppliers::random(),
+			.mixType = sign_mix_type::LINEAR_INTERPOLATION
+		}));
+
+		const sign_scaler scalers[] = {
+			sign_scalers::ping_pong(), sign_scalers::sinus(), sign_scalers::random(), sign_scalers::smooth_random()
+		};
+		for (usize s = 0; s != std::size(scalers); s++) {
+			add(
+				std::string("MOVING_PIXEL ") + scalerNames[s],
+				sign_animations::moving_pixel(sequence(sign_mix_type::LINEAR_INTERPOLATION), scalers[s], 1.0, 3)
+			);
+		}
+
+		// a bar bouncing between the ends of the frame, with all frames and with only a few of them
+		std::array<color, stopMotionPixels * stopMotionFrames> frames;
+		for (usize i = 0; i != frames.size(); i++) {
+			const auto frame = i / stopMotionPixels, pixel = i % stopMotionPixels;
+			frames[i] = pixel == frame or pixel == stopMotionPixels - 1 - frame ? colors::white : colors::blue;
+		}
+		add("STOP_MOTION", sign_animations::stop_motion(frames));
+		add("STOP_MOTION SHORT", sign_animations::stop_motion(std::span(frames).first(3 * stopMotionPixels)));
+
+		return corpus;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief The checks shared by the host tools, a failed one is reported on stderr
+ * and makes 'checks::result' fail the tool.
+ */
+namespace checks {
+	inline int failures = 0;
+
+	/**
+	 * @brief Prints how the checks went.
+	 * @return The exit code of the tool.
+	 */
+	inline int result() {
+		if (failures) {
+			std::printf("%d checks failed\n", failures);
+			return EXIT_FAILURE;
+		}
+
+		std::printf("all checks passed\n");
+		return EXIT_SUCCESS;
+	}
+}
+
+inline void expect(bool condition, const char *what) {
+	if (not condition) {
+		std::fprintf(stderr, "check failed: %s\n", what);
+		checks::failures++;
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <concepts/nvs_backend_concept.hpp>
+#include <util/uix.hpp>
+#include <concepts>
+#include <map>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Backend of the 'nvs_handler' that keeps the entries of a single namespace in a file.
+ *
+ * Mirrors the parts of nvs the handler relies on: typed items, reads that see uncommitted
+ * writes and a commit that makes them durable. The file is only rewritten on commit.
+ * The commit timer never fires by itself, 'fire_commit_timer' runs a scheduled commit.
+ */
+class file_nvs_backend {
+public:
+	// nvs rejects longer keys
+	static constexpr usize maxKeyLength = 15;
+
+	struct statistics {
+		usize writes;			// sets that changed an item, each one is a flash write on the sign
+		usize skippedWrites;	// sets with the value that was already stored
+		usize bytesWritten;
+		usize commits;			// commits that had writes to persist
+	};
+
+	file_nvs_backend() = default;
+
+	file_nvs_backend(const file_nvs_backend&) = delete;
+	file_nvs_backend& operator=(const file_nvs_backend&) = delete;
+
+	/**
+	 * @brief Loads the committed items from the file, a missing file is an empty namespace.
+	 *
+	 * @return std::error_code indicating the result of the operation. Zero on success, non-zero on error.
+	 */
+	[[nodiscard]] std::error_code open(const char *path);
+
+	template<std::integral T>
+	[[nodiscard]] std::error_code get_int(const char *key, T &dst) {
+		usize size = sizeof(T);
+		return read(key, int_type<T>(), &dst, size);
+	}
+
+	template<std::integral T>
+	[[nodiscard]] std::error_code set_int(const char *key, T src) {
+		return write(key, int_type<T>(), &src, sizeof(T));
+	}
+
+	[[nodiscard]] std::error_code get_str(const char *key, char *dst, usize &size);
+
+	[[nodiscard]] std::error_code set_str(const char *key, const char *src);
+
+	[[nodiscard]] std::error_code get_blob(const char *key, void *dst, usize &size);
+
+	[[nodiscard]] std::error_code set_blob(const char *key, const void *src, usize size);
+
+	[[nodiscard]] std::error_code commit();
+
+	bool schedule_commit(i64 delayMicros, void (*callback)(void*), void *arg);
+
+	void cancel_commit();
+
+	[[nodiscard]] bool commit_scheduled() const;
+
+	/**
+	 * @brief Runs the scheduled commit callback as if its timer expired.
+	 *
+	 * @return false if no commit was scheduled.
+	 */
+	bool fire_commit_timer();
+
+	/**
+	 * @brief Makes 'schedule_commit' fail like a timer that cannot be armed.
+	 */
+	void fail_scheduling(bool fail);
+
+	[[nodiscard]] const statistics& stats() const;
+
+	void reset_stats();
+
+private:
+	// same type ids as nvs
+	static constexpr u8 strType = 0x21;
+	static constexpr u8 blobType = 0x42;
+
+	template<std::integral T>
+	static constexpr u8 int_type() {
+		return static_cast<u8>(sizeof(T) | (std::is_signed_v<T> ? 0x10 : 0x00));
+	}
+
+	struct item {
+		u8 type{ 0 };
+		std::vector<u8> data{};
+	};
+
+	[[nodiscard]] std::error_code check_key(const char *key) const;
+
+	[[nodiscard]] std::error_code read(const char *key, u8 type, void *dst, usize &size) const;
+
+	[[nodiscard]] std::error_code write(const char *key, u8 type, const void *src, usize size);
+
+	std::string m_path{};
+	std::map<std::string, item, std::less<>> m_items{};
+	bool m_open{ false };
+	bool m_uncommitted{ false };
+
+	void (*m_commitCallback)(void*){ nullptr };
+	void *m_commitArg{ nullptr };
+	bool m_commitScheduled{ false };
+	bool m_failScheduling{ false };
+
+	statistics m_stats{};
+};
+
+static_assert(nvs_backend_concept<file_nvs_backend>);
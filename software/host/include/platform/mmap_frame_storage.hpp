@@ -0,0 +1,51 @@
+#pragma once
+
+#include <concepts/frame_storage_concept.hpp>
+#include <util/uix.hpp>
+#include <system_error>
+#include <span>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Frame library storage backed by a file, stands in for the flash partition of the sign.
+ *
+ * Writes go through the file descriptor, reads through a shared read only mapping,
+ * so playback touches the same kind of memory as on the sign.
+ */
+class mmap_frame_storage {
+public:
+	// same as the flash sectors of the sign
+	static constexpr usize blockSize = 4096;
+
+	mmap_frame_storage() = default;
+
+	mmap_frame_storage(const mmap_frame_storage&) = delete;
+	mmap_frame_storage& operator=(const mmap_frame_storage&) = delete;
+
+	/**
+	 * @brief Opens or creates the file and resizes it to the given capacity.
+	 */
+	[[nodiscard]] std::error_code open(const char *path, usize capacity);
+
+	[[nodiscard]] usize size() const;
+
+	[[nodiscard]] usize block_size() const;
+
+	[[nodiscard]] std::error_code erase(usize offset, usize size);
+
+	[[nodiscard]] std::error_code write(usize offset, std::span<const u8> data);
+
+	[[nodiscard]] std::error_code map(std::span<const u8> &region);
+
+	void unmap();
+
+	~mmap_frame_storage();
+
+private:
+	int m_fd{ -1 };
+	usize m_size{ 0 };
+	const u8 *m_mapped{ nullptr };
+};
+
+static_assert(frame_storage_concept<mmap_frame_storage>);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <span>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+
+// The bytes are taken from the engine directly, the distributions of the standard libraries
+// differ between hosts.
+inline void mt19937_random_fill(std::span<uint8_t> dst) {
+	static std::random_device rd;
+	static std::mt19937 rng(rd());
+
+	std::generate(dst.begin(), dst.end(), [&]() {
+		return static_cast<uint8_t>(rng() >> 24);
+	});
+}
@@ -0,0 +1,250 @@
+// Renders every animation of the corpus and compares the frames against the hashes
+// checked in as 'golden/animation_frames.txt'. Each animation keeps a hash of every frame
+// and one of every pixel over all frames, so a mismatch names the first tick and the
+// first pixel that differ. Random animations use the seeds of the corpus, the floating
+// point of the mixers has to round like the host's.
+//
+// The animations have to reach the sign unchanged, so each one also has to survive its
+// wire encoding with its seed, which firmware without seeds skips as trailing bytes.
+// The sign renders its strip in parts, which have to add up to the frames of the whole strip.
+//
+// After an intended change of the rendered colors, '--update' rewrites the file.
+//
+// usage: animation_golden_frames [--update] [golden file]
+
+#include <animation_corpus.hpp>
+#include <sign_animation_transcoding.hpp>
+#include <util/variant_visit.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	constexpr usize numTicks = 256;
+	constexpr usize stripLength = 60;		// longer than the sign, to check how animations repeat
+	constexpr usize hashesPerLine = 16;
+
+	struct frame_hashes {
+		std::vector<u32> ticks;
+		std::vector<u32> pixels;
+
+		bool operator==(const frame_hashes&) const = default;
+	};
+
+	constexpr u32 fnv1a_basis = 0x811c9dc5;
+
+	u32 fnv1a(u32 hash, std::span<const u8> bytes) {
+		for (const auto byte : bytes) {
+			hash = (hash ^ byte) * 0x01000193;
+		}
+		return hash;
+	}
+
+	frame_hashes render(const animation_corpus::entry &entry) {
+		frame_hashes hashes{
+			.ticks = std::vector<u32>(numTicks, fnv1a_basis),
+			.pixels = std::vector<u32>(stripLength, fnv1a_basis)
+		};
+
+		auto animator = entry.animation.animator;
+		ztu::visit([&](auto &animate) { animate.init(entry.animation.seed); }, animator);
+
+		std::vector<color> strip(stripLength);
+		for (usize tick = 0; tick != numTicks; tick++) {
+			ztu::visit([&](auto &animate) {
+				animate(strip, static_cast<u32>(tick * entry.animation.speed));
+			}, animator);
+
+			for (usize pixel = 0; pixel != stripLength; pixel++) {
+				const auto &[ r, g, b ] = strip[pixel];
+				const auto rgb = std::array{ r, g, b };
+				hashes.ticks[tick] = fnv1a(hashes.ticks[tick], rgb);
+				hashes.pixels[pixel] = fnv1a(hashes.pixels[pixel], rgb);
+			}
+		}
+
+		return hashes;
+	}
+
+	// Blocks of a 'case' line followed by 'ticks' and 'pixels' lines of hex hashes.
+	std::map<std::string, frame_hashes> read_golden(const char *path) {
+		std::map<std::string, frame_hashes> golden;
+		std::ifstream file(path);
+
+		std::string line;
+		frame_hashes *current = nullptr;
+		while (std::getline(file, line)) {
+			if (line.empty() or line.front() == '#')
+				continue;
+
+			std::istringstream words(line);
+			std::string keyword;
+			words >> keyword;
+
+			if (keyword == "case") {
+				std::string name;
+				std::getline(words >> std::ws, name);
+				current = &golden[name];
+				continue;
+			}
+
+			if (current == nullptr)
+				continue;
+
+			auto &hashes = keyword == "ticks" ? current->ticks : current->pixels;
+			u32 hash;
+			while (words >> std::hex >> hash) {
+				hashes.push_back(hash);
+			}
+		}
+
+		return golden;
+	}
+
+	void write_hashes(std::FILE *file, const char *keyword, std::span<const u32> hashes) {
+		for (usize i = 0; i < hashes.size(); i += hashesPerLine) {
+			std::fprintf(file, "%s", keyword);
+			for (usize j = i; j != std::min(i + hashesPerLine, hashes.size()); j++) {
+				std::fprintf(file, " %08x", hashes[j]);
+			}
+			std::fprintf(file, "\n");
+		}
+	}
+
+	bool write_golden(const char *path, const std::vector<animation_corpus::entry> &corpus) {
+		const auto file = std::fopen(path, "w");
+		if (file == nullptr) {
+			std::fprintf(stderr, "cannot write '%s'\n", path);
+			return false;
+		}
+
+		std::fprintf(file, "# written by 'animation_golden_frames --update'\n");
+		std::fprintf(file, "# %zu ticks of %zu pixels, fnv-1a of the rgb bytes of every frame and of every pixel\n", numTicks, stripLength);
+
+		for (const auto &entry : corpus) {
+			const auto hashes = render(entry);
+			std::fprintf(file, "\ncase %s\n", entry.name.c_str());
+			write_hashes(file, "ticks", hashes.ticks);
+			write_hashes(file, "pixels", hashes.pixels);
+		}
+
+		return std::fclose(file) == 0;
+	}
+
+	bool renders_in_parts(const animation_corpus::entry &entry, usize partPixels) {
+		auto whole = entry.animation.animator, parts = whole;
+		ztu::visit([&](auto &animate) { animate.init(entry.animation.seed); }, whole);
+		ztu::visit([&](auto &animate) { animate.init(entry.animation.seed); }, parts);
+
+		std::vector<color> expected(stripLength), strip(stripLength);
+		for (usize tick = 0; tick != numTicks; tick++) {
+			const auto t = static_cast<u32>(tick * entry.animation.speed);
+			ztu::visit([&](auto &animate) { animate(expected, t); }, whole);
+			ztu::visit([&](auto &animate) {
+				for (usize firstPixel = 0; firstPixel < stripLength; firstPixel += partPixels) {
+					const auto part = std::span(strip).subspan(firstPixel, std::min(partPixels, stripLength - firstPixel));
+					animate(part, t, firstPixel, stripLength);
+				}
+			}, parts);
+
+			if (strip != expected)
+				return false;
+		}
+
+		return true;
+	}
+
+	// without a seed the encoding is the one of firmware that predates seeds
+	bool survives_transcoding(const sign_animation &animation) {
+		std::array<u8, sign_animation_transcoding::max_encoded_size> buffer, unseededBuffer;
+
+		auto unseeded = animation;
+		unseeded.seed = 0;
+
+		const auto size = sign_animation_transcoding::serialize(animation, buffer);
+		const auto unseededSize = sign_animation_transcoding::serialize(unseeded, unseededBuffer);
+		if (not size or not unseededSize or *unseededSize >= *size)
+			return false;
+
+		sign_animation decoded, decodedUnseeded;
+		decoded.seed = decodedUnseeded.seed = 1;
+		return (
+			std::equal(unseededBuffer.begin(), unseededBuffer.begin() + *unseededSize, buffer.begin()) and
+			sign_animation_transcoding::deserialize(decoded, std::span(buffer).first(*size)) and decoded == animation and
+			sign_animation_transcoding::deserialize(decodedUnseeded, std::span(buffer).first(*unseededSize)) and decodedUnseeded == unseeded
+		);
+	}
+
+	template<typename T>
+	usize first_difference(const std::vector<T> &a, const std::vector<T> &b) {
+		return std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first - a.begin();
+	}
+}
+
+int main(int argc, char **argv) {
+	const auto update = argc > 1 and std::strcmp(argv[1], "--update") == 0;
+	const auto pathIndex = update ? 2 : 1;
+	const auto path = argc > pathIndex ? argv[pathIndex] : ANIMATION_GOLDEN_FRAMES;
+
+	const auto corpus = animation_corpus::make();
+
+	if (update) {
+		if (not write_golden(path, corpus))
+			return EXIT_FAILURE;
+		std::printf("wrote the frames of %zu animations to '%s'\n", corpus.size(), path);
+		return EXIT_SUCCESS;
+	}
+
+	const auto golden = read_golden(path);
+	if (golden.empty()) {
+		std::fprintf(stderr, "no golden frames in '%s'\n", path);
+		return EXIT_FAILURE;
+	}
+
+	usize matching = 0;
+	for (const auto &entry : corpus) {
+		if (not survives_transcoding(entry.animation)) {
+			std::printf("%-34s does not survive its wire encoding\n", entry.name.c_str());
+			continue;
+		}
+
+		// parts that cross the frames of stop motions and the ends of the moving pixel
+		constexpr usize partPixels[] = { 1, 7, 16 };
+		if (not std::ranges::all_of(partPixels, [&](const auto pixels) { return renders_in_parts(entry, pixels); })) {
+			std::printf("%-34s differs when rendered in parts\n", entry.name.c_str());
+			continue;
+		}
+
+		const auto it = golden.find(entry.name);
+		if (it == golden.end()) {
+			std::printf("%-34s no golden frames\n", entry.name.c_str());
+			continue;
+		}
+
+		const auto hashes = render(entry);
+		if (hashes == it->second) {
+			matching++;
+			continue;
+		}
+
+		const auto tick = first_difference(hashes.ticks, it->second.ticks);
+		const auto pixel = first_difference(hashes.pixels, it->second.pixels);
+		std::printf(
+			"%-34s differs from tick %zu (t = %zu) and pixel %zu on\n",
+			entry.name.c_str(), tick, tick * entry.animation.speed, pixel
+		);
+	}
+
+	std::printf("%zu of %zu animations match their golden frames\n", matching, corpus.size());
+
+	return matching == corpus.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,143 @@
+// Renders the animations of the sign the way its animation task does, one frame per tick
+// in parts of 'chunkPixels', into strips of several lengths. Reports the time per frame and
+// per pixel for every animation type, mix type and scaler, as the baseline for changes to
+// the renderers. The time per pixel should not grow with the length of the strip.
+//
+// With a directory, every animation is also written as a PPM image of its longest strip,
+// one row per tick, to inspect the rendered colors.
+//
+// usage: animation_renderer [ticks] [ppm directory]
+
+#include <animation_corpus.hpp>
+#include <util/variant_visit.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+	constexpr usize stripLengths[] = { 16, 60, 300, 1500 };		// 16 is the length of signs that do not set one
+	constexpr usize chunkPixels = 64;		// same as the animation task of the sign
+	constexpr auto ticksPerSecond = 30;
+	constexpr usize maxImageRows = 900;
+
+	struct timing {
+		double nanosPerFrame;
+		u32 checksum;		// keeps the compiler from dropping frames nobody looks at
+	};
+
+	// each part is copied into the strip, like the animation task hands it to the leds
+	template<typename Animate>
+	void render_frame(Animate &animate, std::span<color> strip, u32 t) {
+		std::array<color, chunkPixels> chunk;
+		for (usize firstPixel = 0; firstPixel < strip.size(); firstPixel += chunkPixels) {
+			const auto part = std::span(chunk).first(std::min(chunkPixels, strip.size() - firstPixel));
+			animate(part, t, firstPixel, strip.size());
+			std::ranges::copy(part, strip.begin() + firstPixel);
+		}
+	}
+
+	// best of several rounds, single frames are too short to be timed one by one
+	timing render(const sign_animation &animation, std::span<color> strip, usize ticks) {
+		timing result{ std::numeric_limits<double>::max(), 0 };
+
+		for (auto round = 0; round != 3; round++) {
+			auto animator = animation.animator;
+			ztu::visit([&](auto &animate) { animate.init(animation.seed); }, animator);
+
+			const auto begin = std::chrono::steady_clock::now();
+			ztu::visit([&](auto &animate) {
+				for (usize tick = 0; tick != ticks; tick++) {
+					render_frame(animate, strip, static_cast<u32>(tick * animation.speed));
+					result.checksum += strip[tick % strip.size()].r;
+				}
+			}, animator);
+			const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+			const auto nanos = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+			result.nanosPerFrame = std::min(result.nanosPerFrame, nanos / static_cast<double>(ticks));
+		}
+
+		return result;
+	}
+
+	bool write_ppm(const std::string &path, const sign_animation &animation, usize length, usize rows) {
+		const auto file = std::fopen(path.c_str(), "wb");
+		if (file == nullptr) {
+			std::fprintf(stderr, "cannot write '%s'\n", path.c_str());
+			return false;
+		}
+
+		std::fprintf(file, "P6\n%zu %zu\n255\n", length, rows);
+
+		auto animator = animation.animator;
+		ztu::visit([&](auto &animate) { animate.init(animation.seed); }, animator);
+
+		std::vector<color> strip(length);
+		for (usize tick = 0; tick != rows; tick++) {
+			ztu::visit([&](auto &animate) {
+				render_frame(animate, strip, static_cast<u32>(tick * animation.speed));
+			}, animator);
+			for (const auto &[ r, g, b ] : strip) {
+				const u8 rgb[] = { r, g, b };
+				std::fwrite(rgb, 1, sizeof(rgb), file);
+			}
+		}
+
+		return std::fclose(file) == 0;
+	}
+
+	std::string file_name(std::string name) {
+		std::ranges::replace(name, ' ', '_');
+		return name + ".ppm";
+	}
+}
+
+int main(int argc, char **argv) {
+	const usize ticks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : ticksPerSecond * 60;
+	const auto directory = argc > 2 ? argv[2] : nullptr;
+
+	if (ticks == 0) {
+		std::fprintf(stderr, "need at least one tick\n");
+		return EXIT_FAILURE;
+	}
+
+	const auto cases = animation_corpus::make();
+
+	std::printf("%zu ticks per strip, %d ticks per second\n", ticks, ticksPerSecond);
+	std::printf("%-34s %7s %12s %10s\n", "animation", "pixels", "ns/frame", "ns/pixel");
+
+	u32 checksum = 0;
+	std::vector<color> strip;
+	for (const auto &[ name, animation ] : cases) {
+		for (const auto length : stripLengths) {
+			strip.assign(length, colors::black);
+			const auto result = render(animation, strip, ticks);
+			checksum += result.checksum;
+			std::printf(
+				"%-34s %7zu %12.1f %10.2f\n",
+				name.c_str(), length, result.nanosPerFrame, result.nanosPerFrame / static_cast<double>(length)
+			);
+		}
+	}
+
+	std::printf("checksum %08x\n", checksum);
+
+	if (directory != nullptr) {
+		const auto length = *std::ranges::max_element(stripLengths);
+		const auto rows = std::min(ticks, maxImageRows);
+		for (const auto &[ name, animation ] : cases) {
+			if (not write_ppm(std::string(directory) + "/" + file_name(name), animation, length, rows))
+				return EXIT_FAILURE;
+		}
+		std::printf("wrote %zu images of %zu x %zu pixels to '%s'\n", cases.size(), length, rows, directory);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// Simulates the clock synchronization between plugin and signs over a jittery network
+// and reports how far the signs' estimate of the reference clock is off.
+//
+// usage: clock_sync_simulator [hours] [sync interval in ms] [seed]
+
+#include <util/clock_estimator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+	constexpr i64 second = 1'000'000;
+	constexpr usize windowSize = 16;	// same as the sign firmware
+	constexpr auto initialSyncs = 4;	// same as the plugin
+	constexpr auto ticksPerSecond = 30;
+
+	struct network_model {
+		double baseDelay;		// one way, in microseconds
+		double meanJitter;		// exponentially distributed
+		double spikeChance;		// chance of a one sided queueing delay
+		double maxSpike;
+	};
+
+	struct sign_model {
+		double offset;			// local minus reference at time zero, in microseconds
+		double skewPpm;
+
+		[[nodiscard]] i64 local(i64 reference) const {
+			return reference + static_cast<i64>(offset + static_cast<double>(reference) * skewPpm * 1e-6);
+		}
+	};
+
+	struct simulated_sign {
+		sign_model model;
+		clock_estimator<windowSize> estimator{};
+		std::vector<double> errors{};
+	};
+
+	class simulation {
+	public:
+		simulation(const network_model &network, u32 seed) : m_network{ network }, m_rng{ seed } {}
+
+		// Performs the ping, pong, sync exchange that starts at reference time t0.
+		void exchange(simulated_sign &sign, i64 t0) {
+			constexpr i64 processing = 300;
+
+			const auto arrival = t0 + oneWayDelay();
+			const auto t1 = sign.model.local(arrival);
+			const auto t2 = sign.model.local(arrival + processing);
+			const auto t3 = arrival + processing + oneWayDelay();
+
+			sign.estimator.addSample(clock_sample::from_exchange(t0, t1, t2, t3));
+		}
+
+		[[nodiscard]] i64 heartbeatJitter(i64 interval) {
+			return std::uniform_int_distribution<i64>(0, interval / 3)(m_rng);
+		}
+
+	private:
+		[[nodiscard]] i64 oneWayDelay() {
+			auto delay = m_network.baseDelay + std::exponential_distribution<double>(1.0 / m_network.meanJitter)(m_rng);
+			if (std::bernoulli_distribution(m_network.spikeChance)(m_rng)) {
+				delay += std::uniform_real_distribution<double>(0.0, m_network.maxSpike)(m_rng);
+			}
+			return static_cast<i64>(delay);
+		}
+
+		network_model m_network;
+		std::mt19937 m_rng;
+	};
+
+	struct statistics {
+		double mean, p99, max;
+	};
+
+	statistics summarize(std::vector<double> values) {
+		if (values.empty()) return {};
+		for (auto &value : values) value = std::abs(value);
+		std::sort(values.begin(), values.end());
+		double sum = 0.0;
+		for (const auto value : values) sum += value;
+		return {
+			.mean = sum / static_cast<double>(values.size()),
+			.p99 = values[values.size() * 99 / 100],
+			.max = values.back()
+		};
+	}
+
+	void run(const char *name, const network_model &network, double hours, i64 syncInterval, u32 seed) {
+
+		auto sim = simulation(network, seed);
+
+		auto signs = std::array{
+			simulated_sign{ .model{ .offset = 12.0 * second, .skewPpm = 40.0 } },
+			simulated_sign{ .model{ .offset = -3.0 * second, .skewPpm = -25.0 } }
+		};
+
+		const auto duration = static_cast<i64>(hours * 3600.0 * second);
+		const auto warmup = 2 * syncInterval;
+		constexpr auto measureInterval = second / 10;
+
+		std::vector<double> phaseErrors;
+
+		for (auto &sign : signs) {
+			for (int i = 0; i != initialSyncs; ++i) {
+				sim.exchange(sign, i * 10'000);
+			}
+		}
+
+		auto nextSync = syncInterval;
+		for (i64 t = 0; t < duration; t += measureInterval) {
+			while (t >= nextSync) {
+				for (auto &sign : signs) {
+					sim.exchange(sign, nextSync);
+				}
+				nextSync += syncInterval + sim.heartbeatJitter(syncInterval);
+			}
+
+			if (t < warmup)
+				continue;
+
+			std::array<double, signs.size()> errors;
+			for (usize i = 0; i != signs.size(); ++i) {
+				auto &sign = signs[i];
+				const auto estimate = sign.estimator.mapping().toReference(sign.model.local(t));
+				errors[i] = static_cast<double>(estimate - t);
+				sign.errors.push_back(errors[i]);
+			}
+			phaseErrors.push_back(errors[0] - errors[1]);
+		}
+
+		std::printf("%s\n", name);
+		for (usize i = 0; i != signs.size(); ++i) {
+			const auto &sign = signs[i];
+			const auto stats = summarize(sign.errors);
+			std::printf(
+				"  sign %zu (%+.0f ppm): skew correction %+.2f ppm, error mean %8.1f us, p99 %8.1f us, max %8.1f us\n",
+				i, sign.model.skewPpm, sign.estimator.mapping().skewPpb * 1e-3, stats.mean, stats.p99, stats.max
+			);
+		}
+
+		const auto phase = summarize(phaseErrors);
+		std::printf(
+			"  phase between signs: mean %.1f us, p99 %.1f us, max %.1f us (%.4f ticks at %d ticks/s)\n",
+			phase.mean, phase.p99, phase.max, phase.max * ticksPerSecond / static_cast<double>(second), ticksPerSecond
+		);
+
+		const auto unsyncedDrift = std::abs(signs[0].model.skewPpm - signs[1].model.skewPpm) * 1e-6 * static_cast<double>(duration);
+		std::printf("  drift without synchronization: %.1f ms\n\n", unsyncedDrift / 1000.0);
+	}
+}
+
+int main(int argc, char *argv[]) {
+	const auto hours = argc > 1 ? std::atof(argv[1]) : 6.0;
+	const auto syncInterval = argc > 2 ? std::atoll(argv[2]) * 1000 : 30 * second;
+	const auto seed = argc > 3 ? static_cast<u32>(std::atol(argv[3])) : 42u;
+
+	std::printf("simulating %.1f h, sync every %lld ms\n\n", hours, static_cast<long long>(syncInterval / 1000));
+
+	run("wired lan",       { .baseDelay = 300,  .meanJitter = 100,  .spikeChance = 0.01, .maxSpike = 5'000 },  hours, syncInterval, seed);
+	run("wifi",            { .baseDelay = 1500, .meanJitter = 800,  .spikeChance = 0.05, .maxSpike = 80'000 }, hours, syncInterval, seed);
+	run("congested wifi",  { .baseDelay = 3000, .meanJitter = 4000, .spikeChance = 0.20, .maxSpike = 200'000 }, hours, syncInterval, seed);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+// Streams pages of the config website into a sink that records the chunks, like the sign
+// does with 'httpd_resp_send_chunk'. Checks that every buffer size produces the same page,
+// that only the final chunk is empty, that values are escaped and that a failing sink
+// is not written to again.
+// Reports the chunks each buffer size needs.
+//
+// usage: config_page_renderer [--print]
+
+#include <website/html/form.hpp>
+#include <website/html/page.hpp>
+#include <website/html/input_types.hpp>
+#include <website/html/error_form.hpp>
+#include <website/html/networking_form.hpp>
+#include <expect.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+	struct recording_sink {
+		std::vector<std::string> chunks;
+		std::size_t failAfter = SIZE_MAX;
+		std::size_t callsAfterFailure = 0;
+		bool ended = false;
+
+		bool sendChunk(std::string_view chunk) {
+			if (chunks.size() >= failAfter) {
+				callsAfterFailure += chunks.size() > failAfter;
+				chunks.emplace_back();
+				return false;
+			}
+			ended = chunk.empty();
+			chunks.emplace_back(chunk);
+			return true;
+		}
+
+		[[nodiscard]] std::string page() const {
+			std::string page;
+			for (const auto &chunk : chunks) {
+				page += chunk;
+			}
+			return page;
+		}
+	};
+
+	// the networking page of the sign, with its kconfig strip limit
+	using networkingForm = networking_form<CONFIG_MAX_NUM_PIXELS>;
+
+	template<std::size_t BufferSize>
+	bool render(recording_sink &sink, const std::error_code &error) {
+		html::chunked_writer<recording_sink, BufferSize> writer(sink);
+
+		html::page::renderDefault<"Networking", "/script.js", "/style.css">(writer, [&](auto &writer) {
+			networkingForm::render<"Networking", "", "/secret/">(
+				writer, "192.168.2.222", "255.255.255.0", "192.168.2.1", "64000", "16"
+			);
+			renderErrorForm(writer, error);
+		});
+
+		return writer.finish();
+	}
+
+	template<std::size_t BufferSize>
+	std::string check(const std::error_code &error, const std::string &reference) {
+		recording_sink sink;
+		expect(render<BufferSize>(sink, error), "render succeeds");
+		expect(sink.ended and sink.chunks.back().empty(), "response is ended by an empty chunk");
+
+		std::size_t largest = 0;
+		for (std::size_t i = 0; i + 1 < sink.chunks.size(); i++) {
+			const auto &chunk = sink.chunks[i];
+			expect(not chunk.empty(), "only the last chunk is empty");
+			largest = std::max(largest, chunk.size());
+		}
+
+		const auto page = sink.page();
+		expect(reference.empty() or page == reference, "page does not depend on the buffer size");
+
+		std::printf(
+			"buffer %4zu: %5zu bytes in %3zu chunks, largest %4zu\n",
+			BufferSize, page.size(), sink.chunks.size() - 1, largest
+		);
+
+		recording_sink failing;
+		failing.failAfter = 1;
+		expect(not render<BufferSize>(failing, error), "failed send is reported");
+		expect(failing.callsAfterFailure == 0, "nothing is sent after a failed send");
+
+		return page;
+	}
+}
+
+int main(int argc, char **argv) {
+	const auto error = std::make_error_code(std::errc::connection_refused);
+
+	const auto page = check<512>(error, {});
+	check<16>(error, page);
+	check<64>(error, page);
+	check<128>(error, page);
+	check<1024>(error, page);
+	check<4096>(error, page);
+
+	expect(page.starts_with("<!doctype html>") and page.ends_with("</html>"), "page is complete");
+	expect(page.find("value='192.168.2.222'") != std::string::npos, "values are written");
+
+	// an error message with markup has to stay inside its attribute
+	struct quoting_category : std::error_category {
+		const char *name() const noexcept override { return "quoting"; }
+		std::string message(int) const override { return "it's <b>broken</b> & 'quoted'"; }
+	} quoting;
+
+	recording_sink sink;
+	expect(render<64>(sink, std::error_code(1, quoting)), "render with markup in error");
+	expect(
+		sink.page().find("value='it&#39;s &lt;b&gt;broken&lt;/b&gt; &amp; &#39;quoted&#39;'") != std::string::npos,
+		"error message is escaped"
+	);
+
+	// messages longer than the field are cut off
+	struct long_category : std::error_category {
+		const char *name() const noexcept override { return "long"; }
+		std::string message(int) const override { return std::string(1000, 'x'); }
+	} verbose;
+
+	sink = {};
+	expect(render<64>(sink, std::error_code(1, verbose)), "render with long error");
+	expect(sink.page().find(std::string(253, 'x') + "...'") != std::string::npos, "long error message is cut off");
+
+	if (argc > 1 and std::strcmp(argv[1], "--print") == 0) {
+		std::printf("%s\n", page.c_str());
+	}
+
+	return checks::result();
+}
@@ -0,0 +1,148 @@
+// Streams generated frames through the delta encoding of the live preview, the way the
+// sign sends them to the browser, and decodes them again on the receiving side.
+// Checks that every received frame matches the sent one, that malformed messages are
+// rejected without reading out of bounds and that frames published through a seqlock
+// are never torn. Reports the bytes per frame of each pattern next to key frames.
+//
+// usage: frame_delta_stream [pixels] [frames]
+
+#include <lighting/frame_delta.hpp>
+#include <util/seqlock.hpp>
+#include <expect.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	struct pattern {
+		const char *name;
+		void (*render)(std::vector<color> &frame, usize tick);
+	};
+
+	const pattern patterns[] = {
+		{ "static", [](std::vector<color> &frame, usize) {
+			std::fill(frame.begin(), frame.end(), colors::pink);
+		} },
+		{ "moving dot", [](std::vector<color> &frame, usize tick) {
+			std::fill(frame.begin(), frame.end(), colors::black);
+			frame[tick % frame.size()] = colors::white;
+		} },
+		{ "blinking every other", [](std::vector<color> &frame, usize tick) {
+			for (usize i = 0; i < frame.size(); i++) {
+				frame[i] = i % 2 == 0 and tick % 2 == 0 ? colors::red : colors::black;
+			}
+		} },
+		{ "sparkle", [](std::vector<color> &frame, usize tick) {
+			std::minstd_rand rng(static_cast<u32>(tick));
+			for (usize i = 0; i < frame.size() / 10; i++) {
+				frame[rng() % frame.size()] = { static_cast<u8>(rng()), static_cast<u8>(rng()), static_cast<u8>(rng()) };
+			}
+		} },
+		{ "scrolling gradient", [](std::vector<color> &frame, usize tick) {
+			for (usize i = 0; i < frame.size(); i++) {
+				const auto v = static_cast<u8>((i + tick) * 4);
+				frame[i] = { v, static_cast<u8>(255 - v), 64 };
+			}
+		} }
+	};
+
+	void stream(const pattern &p, usize numPixels, usize numFrames) {
+		std::vector<color> sent(numPixels, colors::black), previous, received(numPixels);
+		std::vector<u8> message(frame_delta::max_encoded_size(numPixels));
+
+		usize bytes = 0, keyFrames = 0;
+		bool matches = true;
+		for (usize tick = 0; tick < numFrames; tick++) {
+			p.render(sent, tick);
+
+			const auto size = frame_delta::encode(previous, sent, message);
+			bytes += size;
+			keyFrames += message[0] == static_cast<u8>(frame_delta::kind::KEY);
+
+			matches &= frame_delta::decode({ message.data(), size }, received);
+			matches &= received == sent;
+
+			previous = sent;
+		}
+		expect(matches, p.name);
+
+		std::printf(
+			"%-22s %8.1f bytes per frame, %5.1f%% of key frames, %zu key frames\n",
+			p.name,
+			static_cast<double>(bytes) / static_cast<double>(numFrames),
+			100.0 * static_cast<double>(bytes) / static_cast<double>(numFrames * message.size()),
+			keyFrames
+		);
+	}
+
+	void malformed(usize numPixels) {
+		std::mt19937 rng(1);
+		std::vector<color> frame(numPixels);
+		std::vector<u8> message;
+
+		usize accepted = 0;
+		for (usize i = 0; i < 100'000; i++) {
+			message.resize(rng() % (frame_delta::max_encoded_size(numPixels) + 16));
+			for (auto &b : message) {
+				b = static_cast<u8>(rng() % 4 == 0 ? rng() % 3 : rng());
+			}
+			if (message.size() >= frame_delta::header_size) {
+				message[0] = static_cast<u8>(rng() % 3);
+				message[2] = static_cast<u8>(numPixels);
+				message[3] = static_cast<u8>(numPixels >> 8);
+			}
+			accepted += frame_delta::decode(message, frame);
+		}
+
+		expect(not frame_delta::decode({}, frame), "empty message is rejected");
+		std::printf("%zu of 100000 random messages were valid\n", accepted);
+	}
+
+	// the preview reads the frame of the animation task through a seqlock, while it is being written
+	void snapshots() {
+		using frame_t = std::array<color, 64>;
+
+		ztu::seqlock<frame_t> frame;
+		std::atomic<bool> done{ false };
+
+		std::thread writer([&]() {
+			for (u32 i = 0; i < 200'000; i++) {
+				frame_t f;
+				f.fill({ static_cast<u8>(i), static_cast<u8>(i >> 8), static_cast<u8>(i >> 16) });
+				frame.store(f);
+			}
+			done = true;
+		});
+
+		usize reads = 0, torn = 0;
+		while (not done) {
+			const auto f = frame.load();
+			torn += std::any_of(f.begin(), f.end(), [&](const color &c) { return c != f.front(); });
+			reads++;
+		}
+		writer.join();
+
+		expect(torn == 0, "snapshots are never torn");
+		std::printf("%zu snapshots read while writing, %zu torn\n", reads, torn);
+	}
+}
+
+int main(int argc, char **argv) {
+	const usize numPixels = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300;
+	const usize numFrames = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+	std::printf("%zu pixels, key frames are %zu bytes\n", numPixels, frame_delta::max_encoded_size(numPixels));
+	for (const auto &p : patterns) {
+		stream(p, numPixels, numFrames);
+	}
+
+	malformed(numPixels);
+	snapshots();
+
+	return checks::result();
+}
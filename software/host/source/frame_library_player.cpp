@@ -0,0 +1,130 @@
+// Writes a generated frame library into a file in upload sized chunks, maps it
+// and plays every clip through the 'library_stop_motion' animation.
+// Reports whether the rendered frames match the uploaded ones and how long rendering takes.
+//
+// usage: frame_library_player [file] [clips] [frames per clip] [pixels]
+
+#include <platform/mmap_frame_storage.hpp>
+#include <lighting/frame_library.hpp>
+#include <lighting/animations/library_stop_motion.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+	constexpr usize chunkSize = 1024;
+	constexpr usize stripLength = 64;		// longer than the clips, to exercise repetition
+	constexpr u16 ticksPerFrame = 3;
+
+	color expected(usize clip, usize frame, usize pixel) {
+		return {
+			static_cast<u8>(clip * 37 + pixel),
+			static_cast<u8>(frame),
+			static_cast<u8>(frame >> 8 ^ pixel * 5)
+		};
+	}
+
+	std::vector<u8> generate(std::span<const frame_clip_info> clips) {
+		std::vector<u8> data;
+		for (usize c = 0; c < clips.size(); c++) {
+			for (usize f = 0; f < clips[c].numFrames; f++) {
+				for (usize p = 0; p < clips[c].numPixels; p++) {
+					const auto [ r, g, b ] = expected(c, f, p);
+					data.insert(data.end(), { r, g, b });
+				}
+			}
+		}
+		return data;
+	}
+
+	bool check(const char *what, const std::error_code &e) {
+		if (e) {
+			std::fprintf(stderr, "%s failed: %s\n", what, e.message().c_str());
+		}
+		return not e;
+	}
+}
+
+int main(int argc, char **argv) {
+	const auto path		= argc > 1 ? argv[1] : "frame_library.bin";
+	const auto numClips	= argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+	const auto numFrames	= argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 600;
+	const auto numPixels	= argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 16;
+
+	std::vector<frame_clip_info> clips(numClips, frame_clip_info{
+		.numFrames = static_cast<u32>(numFrames),
+		.numPixels = static_cast<u16>(numPixels)
+	});
+
+	const auto data = generate(clips);
+
+	mmap_frame_storage storage;
+	if (not check("open", storage.open(path, 0xF0000)))
+		return EXIT_FAILURE;
+
+	frame_library_writer writer(storage);
+	if (not check("begin", writer.begin(clips)))
+		return EXIT_FAILURE;
+
+	for (usize offset = 0; offset < data.size(); offset += chunkSize) {
+		const auto chunk = std::span{ data }.subspan(offset, std::min(chunkSize, data.size() - offset));
+		if (not check("write", writer.write(offset, chunk)))
+			return EXIT_FAILURE;
+	}
+
+	if (not check("finish", writer.finish()))
+		return EXIT_FAILURE;
+
+	std::span<const u8> region;
+	if (not check("map", storage.map(region)))
+		return EXIT_FAILURE;
+
+	const auto library = frame_library::open(region);
+	if (not library) {
+		std::fprintf(stderr, "mapped file does not contain a valid library\n");
+		return EXIT_FAILURE;
+	}
+	frame_library::activate(&*library);
+
+	std::printf("library: %zu clips, %zu bytes of frames in '%s'\n", library->size(), data.size(), path);
+
+	std::array<color, stripLength> strip;
+	usize mismatches = 0, renderedFrames = 0;
+	std::chrono::nanoseconds renderTime{};
+
+	for (usize c = 0; c < library->size(); c++) {
+		animation_detail::library_stop_motion animation(static_cast<u16>(c), ticksPerFrame);
+		animation.init(0);
+
+		for (u32 t = 0; t < numFrames * ticksPerFrame; t += ticksPerFrame) {
+			const auto begin = std::chrono::steady_clock::now();
+			animation(strip, t);
+			renderTime += std::chrono::steady_clock::now() - begin;
+			renderedFrames++;
+
+			const auto frame = t / ticksPerFrame;
+			for (usize p = 0; p < strip.size(); p++) {
+				mismatches += strip[p] != expected(c, frame, p % numPixels);
+			}
+		}
+	}
+
+	// clips that do not exist have to render black instead of failing
+	animation_detail::library_stop_motion missing(static_cast<u16>(library->size()), 1);
+	missing(strip, 0);
+	mismatches += std::ranges::count_if(strip, [](const color &x) { return x != colors::black; });
+
+	frame_library::activate(nullptr);
+
+	std::printf(
+		"rendered %zu frames of %zu pixels, %.1fns per frame, %zu mismatching pixels\n",
+		renderedFrames, stripLength,
+		static_cast<double>(renderTime.count()) / static_cast<double>(renderedFrames),
+		mismatches
+	);
+
+	return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
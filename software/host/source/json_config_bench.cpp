@@ -0,0 +1,324 @@
+// Parses generated plugin configs with large STOP_MOTION color arrays, the way the plugin
+// loads its 'config.json' while OBS starts. Reports the throughput of the tokenizer alone
+// and of the whole parse into the app config. Checks that the default config survives a
+// serialize and parse round trip and that truncated documents are rejected with an
+// exception instead of being read past their end.
+//
+// Color strings are decoded a word at a time, random strings are compared against a
+// character at a time reference decoder.
+//
+// Object keys and enumeration names are looked up through the perfect hash of the parser,
+// every scaler name has to survive a round trip.
+//
+// The binary snapshot the plugin keeps next to its config is timed against the parse and
+// must reproduce the parsed config, while damaged snapshots and those of other files are
+// rejected.
+//
+// usage: json_config_bench [colors per animation] [iterations]
+
+#include <config/app_config.hpp>
+#include <config/config_snapshot.hpp>
+#include <expect.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+	constexpr const char *states[] = {
+		"CONNECTED", "RECORDING", "RECORDING_PAUSED", "STREAMING",
+		"STREAMING_PAUSED", "IDLE", "PROCESSING", "SETUP"
+	};
+
+	// every state gets a stop motion animation, the colors make the config large in bytes
+	// and the timeout intervals make it large in tokens
+	std::string make_config(std::size_t numColors, std::size_t numIntervals) {
+		std::string text = "{\n\t\"animations\": {\n";
+		for (std::size_t s = 0; s != std::size(states); s++) {
+			text += "\t\t\"";
+			text += states[s];
+			text += "\": {\n\t\t\t\"_type\": \"STOP_MOTION\",\n\t\t\t\"frames\": \"";
+			for (std::size_t i = 0; i != numColors; i++) {
+				constexpr auto hex = "0123456789abcdef";
+				const auto v = (i * 7 + s * 13) % 4096;
+				text += i == 0 ? "" : " ";
+				text += hex[v >> 8];
+				text += hex[(v >> 4) & 0xf];
+				text += hex[v & 0xf];
+			}
+			text += "\"\n\t\t}";
+			text += s + 1 == std::size(states) ? "\n" : ",\n";
+		}
+		text +=
+			"\t},\n"
+			"\t\"frame_library\": \"\",\n"
+			"\t\"connection\": {\n"
+			"\t\t\"ip\": \"192.168.2.222\",\n"
+			"\t\t\"port\": 65025,\n"
+			"\t\t\"heartbeat_correction\": 0.3,\n"
+			"\t\t\"timeout_interval_ms\": [";
+		for (std::size_t i = 0; i != numIntervals; i++) {
+			text += i == 0 ? "\n" : ",\n";
+			text += "\t\t\t{ \"dt\": " + std::to_string((i + 1) * 10'000) + ", \"interval\": " + std::to_string(1000 + i) + " }";
+		}
+		text += "\n\t\t]\n\t}\n}\n";
+		return text;
+	}
+
+	app_config_t parse(const std::string &text) {
+		auto parser = json::safe::parser(text);
+		return parser.parse<default_app_config>();
+	}
+
+	std::string serialize(const app_config_t &config) {
+		std::ostringstream os;
+		auto serializer = json::safe::serializer(os);
+		serializer.serialize<default_app_config>(config);
+		return os.str();
+	}
+
+	std::size_t count_tokens(const std::string &text) {
+		using enum json::transcoding::tokens::type;
+
+		json::transcoding::json_tokenizer_t tokenizer(text);
+		json::transcoding::json_token_t token;
+		json::transcoding::source_location location;
+
+		std::size_t count = 0;
+		do {
+			tokenizer >> std::tie(token, location);
+			count++;
+		} while (token.type() != END);
+
+		return count;
+	}
+
+	// the fastest of a few rounds, so a busy machine does not hide differences
+	template<class F>
+	double megabytes_per_second(const std::string &text, std::size_t iterations, F &&f) {
+		constexpr std::size_t rounds = 5;
+		const auto perRound = std::max(iterations / rounds, std::size_t{ 1 });
+
+		auto fastest = std::numeric_limits<double>::max();
+		for (std::size_t round = 0; round != rounds; round++) {
+			const auto begin = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i != perRound; i++) {
+				f();
+			}
+			fastest = std::min(fastest, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+		}
+
+		return static_cast<double>(text.size() * perRound) / fastest / 1e6;
+	}
+
+	config_snapshot::source_key key_of(const std::string &text) {
+		return config_snapshot::key_of(text, std::filesystem::file_time_type{});
+	}
+
+	void bench(const char *name, const std::string &text, std::size_t iterations) {
+		const auto key = key_of(text);
+		const auto snapshot = config_snapshot::save(parse(text), key);
+
+		const auto tokenize = megabytes_per_second(text, iterations, [&]() { count_tokens(text); });
+		const auto whole = megabytes_per_second(text, iterations, [&]() { (void)parse(text); });
+		// in bytes of json, so both numbers compare the time it takes to get the config
+		const auto cached = megabytes_per_second(text, iterations, [&]() { (void)config_snapshot::load(snapshot, key); });
+		std::printf(
+			"%-14s %7zu bytes %6zu tokens, tokenizer %7.1f MB/s, parse %7.1f MB/s, snapshot %7zu bytes %8.1f MB/s\n",
+			name, text.size(), count_tokens(text), tokenize, whole, snapshot.size(), cached
+		);
+
+		const auto loaded = config_snapshot::load(snapshot, key);
+		expect(loaded and serialize(*loaded) == serialize(parse(text)), "snapshot reproduces the parsed config");
+	}
+
+	// the decoder the word at a time version replaced
+	std::optional<std::vector<color>> reference_colors(const std::string &text) {
+		std::vector<color> colors;
+		std::size_t numDigits = 0;
+		std::array<u8, 6> digits{};
+
+		const auto push = [&]() {
+			if (numDigits == 6) {
+				colors.push_back({ u8(16 * digits[0] + digits[1]), u8(16 * digits[2] + digits[3]), u8(16 * digits[4] + digits[5]) });
+			} else if (numDigits == 3) {
+				colors.push_back({ u8(17 * digits[0]), u8(17 * digits[1]), u8(17 * digits[2]) });
+			} else {
+				return false;
+			}
+			numDigits = 0;
+			return true;
+		};
+
+		for (const char c : text) {
+			const auto value = color_array_detail::hex_colors::hexValue(c);
+			if (value & 0x80) {
+				if (not (c == ' ' and push()))
+					return std::nullopt;
+			} else if (numDigits == 6) {
+				return std::nullopt;
+			} else {
+				digits[numDigits++] = value;
+			}
+		}
+
+		if (not push())
+			return std::nullopt;
+
+		return colors;
+	}
+
+	void color_strings(std::size_t numColors, std::size_t iterations) {
+		using converter = color_array_detail::string_color_array_converter;
+
+		std::mt19937 rng(42);
+		const auto random = [&](std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng); };
+
+		// mostly valid strings, with stray spaces and characters next to the accepted ranges sprinkled in
+		constexpr std::string_view valid = "0123456789abcdefABCDEF";
+		constexpr std::string_view unusual = "/:@`Gg \x80\xff";
+
+		std::size_t accepted = 0;
+		for (int i = 0; i != 20000; i++) {
+			std::string text;
+			const auto numGroups = 1 + random(12);
+			for (std::size_t g = 0; g != numGroups; g++) {
+				text += g == 0 ? "" : " ";
+				const auto length = random(8) == 0 ? random(8) : (random(2) ? 3 : 6);
+				for (std::size_t c = 0; c != length; c++) {
+					text += random(64) == 0 ? unusual[random(unusual.size())] : valid[random(valid.size())];
+				}
+			}
+
+			const auto expected = reference_colors(text);
+			const auto actual = converter::convert(text);
+			accepted += expected.has_value();
+			if (expected != actual) {
+				std::fprintf(stderr, "color string '%s' decoded differently\n", text.c_str());
+				expect(false, "color strings decode like the reference");
+				break;
+			}
+			if (actual) {
+				expect(converter::convert(*converter::revert(*actual)) == actual, "colors survive a revert");
+			}
+		}
+
+		std::printf("%zu of 20000 random color strings valid\n", accepted);
+
+		std::array<color, 3> colors;
+		for (const auto text : { "f00 00ff00", "f00 0f0 00f 123", "f00" }) {
+			expect(not color_array_detail::hex_colors::decode(text, colors), "colors are only decoded into a span of their size");
+		}
+
+		for (const auto &[name, groups] : { std::pair{ "6 digit colors", 0 }, { "3 digit colors", 1 }, { "mixed colors", 2 } }) {
+			std::string text;
+			for (std::size_t i = 0; i != numColors; i++) {
+				text += i == 0 ? "" : " ";
+				text += groups == 1 or (groups == 2 and i % 3 == 0) ? "f80" : "12ab9f";
+			}
+
+			const auto decoder = megabytes_per_second(text, iterations, [&]() { (void)converter::convert(text); });
+			const auto reference = megabytes_per_second(text, iterations, [&]() { (void)reference_colors(text); });
+			std::printf(
+				"%-14s %7zu bytes, decoder %7.1f MB/s, character at a time %7.1f MB/s\n",
+				name, text.size(), decoder, reference
+			);
+		}
+	}
+
+	void round_trip() {
+		const auto text = serialize(default_app_config());
+		expect(serialize(parse(text)) == text, "default config survives a round trip");
+	}
+
+	void key_dispatch() {
+		constexpr auto indexer = string_indexer<std::size(states)>(
+			"CONNECTED", "RECORDING", "RECORDING_PAUSED", "STREAMING",
+			"STREAMING_PAUSED", "IDLE", "PROCESSING", "SETUP"
+		);
+
+		for (std::size_t i = 0; i != std::size(states); i++) {
+			expect(indexer.indexOf(std::string_view(states[i])) == i, "every key maps to its index");
+		}
+		for (const auto key : { "", "IDL", "IDLEE", "idle", "CONNECTED " }) {
+			expect(not indexer.indexOf(std::string_view(key)), "unknown keys map to no index");
+		}
+
+		// the scaler is an enumeration wrapped in an adapter, which used to parse as its default
+		const auto text = serialize(default_app_config());
+		const auto pos = text.find("\"UNIFORM_COLOR\"");
+		for (const auto name : { "PING_PONG", "SINUS", "RANDOM", "SMOOTH_RANDOM" }) {
+			const auto scaler = std::string("\"scaler\": \"") + name + "\"";
+			auto changed = text;
+			changed.replace(pos, 15, "\"MOVING_PIXEL\", " + scaler);
+			expect(serialize(parse(changed)).find(scaler) != std::string::npos, "every scaler survives a round trip");
+		}
+	}
+
+	void snapshot_rejected() {
+		const auto text = serialize(default_app_config());
+		const auto key = key_of(text);
+		const auto snapshot = config_snapshot::save(parse(text), key);
+
+		auto otherKey = key;
+		otherKey.modified++;
+		expect(not config_snapshot::load(snapshot, otherKey), "snapshot of a modified file is rejected");
+		expect(not config_snapshot::load(snapshot, key_of(text + " ")), "snapshot of another file is rejected");
+
+		for (std::size_t length = 0; length < snapshot.size(); length++) {
+			if (config_snapshot::load(std::span(snapshot).first(length), key)) {
+				expect(false, "truncated snapshot is rejected");
+				break;
+			}
+		}
+
+		for (std::size_t i = 0; i < snapshot.size(); i++) {
+			auto damaged = snapshot;
+			damaged[i] ^= 0x10;
+			if (config_snapshot::load(damaged, key)) {
+				expect(false, "damaged snapshot is rejected");
+				break;
+			}
+		}
+	}
+
+	void truncated() {
+		const auto text = serialize(default_app_config());
+
+		std::size_t rejected = 0;
+		for (std::size_t length = 0; length < text.size(); length++) {
+			// a copy of exactly the prefix, so reading past it is caught by sanitizers
+			const auto prefix = text.substr(0, length);
+			try {
+				(void)parse(prefix);
+			} catch (const std::exception &) {
+				rejected++;
+			}
+		}
+
+		std::printf("%zu of %zu truncated documents rejected\n", rejected, text.size());
+	}
+}
+
+int main(int argc, char **argv) {
+	const std::size_t numColors = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+	const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+
+	bench("color arrays", make_config(numColors, 4), iterations);
+	bench("interval list", make_config(16, numColors / 4), iterations);
+
+	color_strings(numColors * 16, iterations);
+
+	round_trip();
+	key_dispatch();
+	snapshot_rejected();
+	truncated();
+
+	return checks::result();
+}
@@ -0,0 +1,170 @@
+// Runs the storage of the sign against a file backed nvs namespace.
+// Checks that defaults cause no writes, that bursts of changes are coalesced into a single
+// commit and that every kind of entry survives reopening the file.
+// Reports the flash writes each access pattern causes and how long it takes.
+//
+// usage: nvs_storage_bench [file] [changes per burst]
+
+#include <platform/file_nvs_backend.hpp>
+#include <domain_logic/sign_storage.hpp>
+#include <expect.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+	using storage_t = basic_sign_storage_t<file_nvs_backend>;
+	using bench_clock = std::chrono::steady_clock;
+
+	std::unique_ptr<storage_t> open(const char *path) {
+		auto storage = std::make_unique<storage_t>();
+		expect(storage->open(path), "open");
+		return storage;
+	}
+
+	sign_animation test_animation(usize i) {
+		return sign_animation{
+			sign_animations::moving_colors{
+				{
+					sign_suppliers::sequence{ colors::red, colors::blue },
+					color_mixing::type::LINEAR_INTERPOLATION
+				},
+				static_cast<u16>(1 + i % 256),
+				8
+			},
+			1.0
+		};
+	}
+
+	void report(const char *name, const file_nvs_backend::statistics &stats, bench_clock::duration time, usize operations) {
+		const auto micros = std::chrono::duration<double, std::micro>(time).count();
+		std::printf(
+			"%-22s %6zu writes %6zu skipped %8zu bytes %5zu commits %10.2f us/op\n",
+			name, stats.writes, stats.skippedWrites, stats.bytesWritten, stats.commits,
+			micros / static_cast<double>(operations)
+		);
+	}
+}
+
+int main(int argc, char **argv) {
+	const auto path		= argc > 1 ? argv[1] : "nvs_storage.bin";
+	const auto numChanges	= argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+
+	std::remove(path);
+
+	auto storage = open(path);
+	auto &backend = storage->get_backend();
+
+	{ // a fresh namespace only returns defaults and writes nothing
+		const auto begin = bench_clock::now();
+		bool readData = true, anyRead = false;
+		storage->get<storage_keys::IDLE_ANIMATION>(readData);
+		anyRead |= readData;
+		storage->get<storage_keys::SETUP_ANIMATION>(readData);
+		anyRead |= readData;
+		storage->get<storage_keys::PORT>(readData);
+		anyRead |= readData;
+		report("defaults", backend.stats(), bench_clock::now() - begin, 3);
+
+		expect(not anyRead, "defaults are reported as not read");
+		expect(backend.stats().writes == 0, "reading defaults does not write");
+		expect(not backend.commit_scheduled(), "reading defaults does not schedule a commit");
+	}
+
+	{ // a burst of changes, e.g. dragging a slider in the plugin
+		backend.reset_stats();
+		const auto begin = bench_clock::now();
+		for (usize i = 0; i < numChanges; i++) {
+			storage->set<storage_keys::IDLE_ANIMATION>(test_animation(i));
+		}
+		backend.fire_commit_timer();
+		report("coalesced burst", backend.stats(), bench_clock::now() - begin, numChanges);
+
+		expect(backend.stats().writes == 1, "a burst is written once");
+		expect(backend.stats().commits == 1, "a burst is committed once");
+	}
+
+	{ // the same burst if every change was saved immediately
+		backend.reset_stats();
+		const auto begin = bench_clock::now();
+		for (usize i = 0; i < numChanges; i++) {
+			storage->set<storage_keys::IDLE_ANIMATION>(test_animation(i + 1));
+			storage->save();
+		}
+		report("saved burst", backend.stats(), bench_clock::now() - begin, numChanges);
+
+		expect(backend.stats().commits == numChanges, "every save commits");
+	}
+
+	{ // unchanged values are not written at all
+		backend.reset_stats();
+		const auto begin = bench_clock::now();
+		for (usize i = 0; i < numChanges; i++) {
+			storage->set<storage_keys::IDLE_ANIMATION>(test_animation(numChanges));
+		}
+		report("unchanged", backend.stats(), bench_clock::now() - begin, numChanges);
+
+		expect(not backend.commit_scheduled(), "unchanged values do not schedule a commit");
+		expect(backend.stats().writes == 0, "unchanged values are not written");
+	}
+
+	{ // without a commit timer every change is saved right away
+		backend.reset_stats();
+		backend.fail_scheduling(true);
+		bool wroteData = false;
+		storage->set<storage_keys::IDLE_ANIMATION>(test_animation(numChanges + 1), wroteData);
+		backend.fail_scheduling(false);
+
+		expect(wroteData, "a change without commit timer is reported as written");
+		expect(backend.stats().commits == 1, "a change without commit timer is committed at once");
+		expect(not backend.commit_scheduled(), "a failed schedule leaves no commit pending");
+
+		storage->set<storage_keys::IDLE_ANIMATION>(test_animation(numChanges));
+		backend.fire_commit_timer();
+	}
+
+	std::array<u8, 64 + 32> secret;
+	for (usize i = 0; i < secret.size(); i++) {
+		secret[i] = static_cast<u8>(i * 7);
+	}
+
+	storage->set<storage_keys::SSID>({ "bench_network" });
+	storage->set<storage_keys::SECRET>(secret);
+	storage->set<storage_keys::PORT>(static_cast<u16>(8080));
+	storage->set<storage_keys::GATEWAY>(0xC0A80001);
+	storage->set<storage_keys::SETUP_DONE>(static_cast<u8>(0));
+	expect(not storage->save(), "save");
+
+	storage = open(path);
+
+	{ // everything is read back from the file
+		bool readData = false, allRead = true;
+		const auto check = [&](bool equal, const char *what) {
+			allRead &= readData;
+			expect(equal, what);
+		};
+		check(storage->get<storage_keys::IDLE_ANIMATION>(readData) == test_animation(numChanges), "animation survives reopening");
+		check(storage->get<storage_keys::SSID>(readData) == std::string_view{ "bench_network" }, "ssid survives reopening");
+		check(storage->get<storage_keys::SECRET>(readData) == secret, "secret survives reopening");
+		check(storage->get<storage_keys::PORT>(readData) == 8080, "port survives reopening");
+		check(storage->get<storage_keys::GATEWAY>(readData) == 0xC0A80001, "gateway survives reopening");
+		check(storage->get<storage_keys::SETUP_DONE>(readData) == 0, "setup flag survives reopening");
+		expect(allRead, "reopened values are reported as read");
+		expect(storage->get_backend().stats().writes == 0, "reading stored values does not write");
+	}
+
+	{ // closing the storage saves changes whose commit is still pending
+		storage->set<storage_keys::PORT>(static_cast<u16>(9090));
+		expect(storage->get_backend().commit_scheduled(), "a change schedules a commit");
+		storage.reset();
+
+		storage = open(path);
+		bool readData = false;
+		expect(storage->get<storage_keys::PORT>(readData) == 9090 and readData, "a pending change survives closing");
+	}
+
+	return checks::result();
+}
@@ -0,0 +1,209 @@
+#include <platform/file_nvs_backend.hpp>
+#include <error_codes/nvs_handler_error.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+
+// file layout, repeated for every item:
+//   u8 key length | key | u8 type | u32 size | data
+
+namespace {
+
+	template<typename T>
+	void put(std::ostream &out, const T &value) {
+		out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	bool take(std::istream &in, T &value) {
+		return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+}
+
+
+std::error_code file_nvs_backend::open(const char *path) {
+	m_path = path;
+	m_items.clear();
+	m_uncommitted = false;
+	m_open = false;
+
+	std::ifstream in(m_path, std::ios::binary);
+	if (not in.is_open()) {
+		m_open = true;
+		return {};
+	}
+
+	u8 keyLength;
+	while (take(in, keyLength)) {
+		std::string key(keyLength, '\0');
+		item entry;
+		u32 size;
+
+		if (
+			not in.read(key.data(), keyLength) or
+			not take(in, entry.type) or
+			not take(in, size)
+		) {
+			return std::make_error_code(std::errc::io_error);
+		}
+
+		entry.data.resize(size);
+		if (not in.read(reinterpret_cast<char*>(entry.data.data()), size))
+			return std::make_error_code(std::errc::io_error);
+
+		m_items.insert_or_assign(std::move(key), std::move(entry));
+	}
+
+	m_open = true;
+
+	return {};
+}
+
+std::error_code file_nvs_backend::get_str(const char *key, char *dst, usize &size) {
+	return read(key, strType, dst, size);
+}
+
+std::error_code file_nvs_backend::set_str(const char *key, const char *src) {
+	return write(key, strType, src, std::strlen(src) + 1);
+}
+
+std::error_code file_nvs_backend::get_blob(const char *key, void *dst, usize &size) {
+	return read(key, blobType, dst, size);
+}
+
+std::error_code file_nvs_backend::set_blob(const char *key, const void *src, usize size) {
+	return write(key, blobType, src, size);
+}
+
+std::error_code file_nvs_backend::commit() {
+	if (not m_open)
+		return nvs_handler_error::make_error_code(nvs_handler_error::codes::NOT_OPEN);
+
+	if (not m_uncommitted)
+		return {};
+
+	// written next to the file and renamed, so an interrupted commit leaves the last one intact
+	const auto tempPath = m_path + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		for (const auto &[ key, entry ] : m_items) {
+			put(out, static_cast<u8>(key.size()));
+			out.write(key.data(), static_cast<std::streamsize>(key.size()));
+			put(out, entry.type);
+			put(out, static_cast<u32>(entry.data.size()));
+			out.write(reinterpret_cast<const char*>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()));
+		}
+		if (not out.flush())
+			return std::make_error_code(std::errc::io_error);
+	}
+
+	if (std::rename(tempPath.c_str(), m_path.c_str()) != 0)
+		return { errno, std::generic_category() };
+
+	m_uncommitted = false;
+	m_stats.commits++;
+
+	return {};
+}
+
+bool file_nvs_backend::schedule_commit(i64, void (*callback)(void*), void *arg) {
+	if (m_failScheduling)
+		return false;
+
+	m_commitCallback = callback;
+	m_commitArg = arg;
+	m_commitScheduled = true;
+	return true;
+}
+
+void file_nvs_backend::cancel_commit() {
+	m_commitScheduled = false;
+}
+
+void file_nvs_backend::fail_scheduling(bool fail) {
+	m_failScheduling = fail;
+}
+
+bool file_nvs_backend::commit_scheduled() const {
+	return m_commitScheduled;
+}
+
+bool file_nvs_backend::fire_commit_timer() {
+	if (not m_commitScheduled)
+		return false;
+
+	m_commitScheduled = false;
+	m_commitCallback(m_commitArg);
+
+	return true;
+}
+
+const file_nvs_backend::statistics& file_nvs_backend::stats() const {
+	return m_stats;
+}
+
+void file_nvs_backend::reset_stats() {
+	m_stats = {};
+}
+
+std::error_code file_nvs_backend::check_key(const char *key) const {
+	using enum nvs_handler_error::codes;
+
+	if (not m_open)
+		return make_error_code(NOT_OPEN);
+
+	if (std::strlen(key) > maxKeyLength)
+		return make_error_code(INVALID_NAME);
+
+	return {};
+}
+
+std::error_code file_nvs_backend::read(const char *key, u8 type, void *dst, usize &size) const {
+	using enum nvs_handler_error::codes;
+
+	if (const auto e = check_key(key); e)
+		return e;
+
+	const auto it = m_items.find(key);
+	if (it == m_items.end())
+		return make_error_code(NOT_FOUND);
+
+	const auto &entry = it->second;
+	if (entry.type != type)
+		return make_error_code(TYPE_MISMATCH);
+
+	if (dst != nullptr) {
+		if (size < entry.data.size())
+			return make_error_code(INVALID_LENGTH);
+		std::copy(entry.data.begin(), entry.data.end(), static_cast<u8*>(dst));
+	}
+
+	size = entry.data.size();
+
+	return {};
+}
+
+std::error_code file_nvs_backend::write(const char *key, u8 type, const void *src, usize size) {
+	if (const auto e = check_key(key); e)
+		return e;
+
+	const auto bytes = static_cast<const u8*>(src);
+	auto &entry = m_items[key];
+
+	if (entry.type == type and std::equal(entry.data.begin(), entry.data.end(), bytes, bytes + size)) {
+		m_stats.skippedWrites++;
+		return {};
+	}
+
+	entry.type = type;
+	entry.data.assign(bytes, bytes + size);
+
+	m_uncommitted = true;
+	m_stats.writes++;
+	m_stats.bytesWritten += size;
+
+	return {};
+}
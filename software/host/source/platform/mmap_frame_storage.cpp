@@ -0,0 +1,113 @@
+#include <platform/mmap_frame_storage.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+static inline std::error_code last_error() {
+	return { errno, std::generic_category() };
+}
+
+// pwrite may write less than requested
+static std::error_code write_all(int fd, usize offset, std::span<const u8> data) {
+	while (not data.empty()) {
+		const auto written = ::pwrite(fd, data.data(), data.size(), static_cast<off_t>(offset));
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return last_error();
+		}
+		offset += static_cast<usize>(written);
+		data = data.subspan(static_cast<usize>(written));
+	}
+	return {};
+}
+
+
+std::error_code mmap_frame_storage::open(const char *path, usize capacity) {
+	unmap();
+	if (m_fd != -1) {
+		::close(m_fd);
+	}
+
+	m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+	if (m_fd == -1)
+		return last_error();
+
+	if (::ftruncate(m_fd, static_cast<off_t>(capacity)) == -1)
+		return last_error();
+
+	m_size = capacity;
+
+	return {};
+}
+
+usize mmap_frame_storage::size() const {
+	return m_size;
+}
+
+usize mmap_frame_storage::block_size() const {
+	return blockSize;
+}
+
+std::error_code mmap_frame_storage::erase(usize offset, usize size) {
+	if (offset > m_size or m_size - offset < size)
+		return std::make_error_code(std::errc::invalid_argument);
+
+	// mimics erased flash
+	std::array<u8, blockSize> erased;
+	erased.fill(0xff);
+
+	while (size > 0) {
+		const auto n = std::min(size, erased.size());
+		if (const auto e = write_all(m_fd, offset, { erased.data(), n }); e)
+			return e;
+		offset += n;
+		size -= n;
+	}
+
+	return {};
+}
+
+std::error_code mmap_frame_storage::write(usize offset, std::span<const u8> data) {
+	if (offset > m_size or m_size - offset < data.size())
+		return std::make_error_code(std::errc::invalid_argument);
+
+	return write_all(m_fd, offset, data);
+}
+
+std::error_code mmap_frame_storage::map(std::span<const u8> &region) {
+	if (m_fd == -1)
+		return std::make_error_code(std::errc::bad_file_descriptor);
+
+	if (m_mapped) {
+		region = { m_mapped, m_size };
+		return {};
+	}
+
+	const auto mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+	if (mapped == MAP_FAILED)
+		return last_error();
+
+	m_mapped = static_cast<const u8*>(mapped);
+	region = { m_mapped, m_size };
+
+	return {};
+}
+
+void mmap_frame_storage::unmap() {
+	if (m_mapped) {
+		::munmap(const_cast<u8*>(m_mapped), m_size);
+		m_mapped = nullptr;
+	}
+}
+
+mmap_frame_storage::~mmap_frame_storage() {
+	unmap();
+	if (m_fd != -1) {
+		::close(m_fd);
+	}
+}
@@ -0,0 +1,163 @@
+// Records timings and counts events the way the tasks of the sign do, while another
+// thread keeps reading them like the '/metrics' page. Checks that no increment is lost,
+// that summaries stay consistent with the recorded values and that every field of
+// a snapshot has its own name. Snapshots and state stats have to reach the plugin with
+// the same values, whatever the padding of the structs on either end.
+// Reports the cost of recording next to a plain store.
+//
+// usage: sign_metrics_bench [recordings]
+
+#include <domain_logic/sign_metrics.hpp>
+#include <util/state_machine_stats.hpp>
+#include <util/metrics.hpp>
+#include <expect.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+	double nanos_per(std::chrono::steady_clock::duration d, usize n) {
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) / static_cast<double>(n);
+	}
+
+	// several tasks count connection events at once
+	void counters(u32 perThread) {
+		ztu::metric_counter counter;
+		std::vector<std::thread> threads;
+		for (usize i = 0; i < 4; i++) {
+			threads.emplace_back([&]() {
+				for (u32 n = 0; n < perThread; n++) {
+					counter.add();
+				}
+			});
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		expect(counter.value() == 4 * perThread, "no increment is lost");
+	}
+
+	// the animation task records every tick while the webserver reads
+	void timings(u32 recordings) {
+		ztu::metric_timing timing;
+		std::atomic<bool> done{ false };
+
+		std::thread reader([&]() {
+			usize reads = 0, inconsistent = 0;
+			while (not done) {
+				const auto s = timing.summary();
+				// fields are loaded one by one, but every value ever recorded lies in [100, 999]
+				inconsistent += s.count != 0 and (s.max > 999 or s.last > 999 or s.average > 999);
+				reads++;
+			}
+			expect(inconsistent == 0, "summaries only contain recorded values");
+			std::printf("%zu summaries read while recording\n", reads);
+		});
+
+		const auto begin = std::chrono::steady_clock::now();
+		for (u32 i = 0; i < recordings; i++) {
+			timing.record(100 + i % 900);
+		}
+		const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+		done = true;
+		reader.join();
+
+		const auto s = timing.summary();
+		expect(s.count == recordings, "every recording is counted");
+		expect(s.max == 999, "maximum is kept");
+		expect(s.average >= 100 and s.average <= 999, "average stays in range");
+
+		volatile u32 sink;
+		const auto plainBegin = std::chrono::steady_clock::now();
+		for (u32 i = 0; i < recordings; i++) {
+			sink = 100 + i % 900;
+		}
+		const auto plainElapsed = std::chrono::steady_clock::now() - plainBegin;
+		(void)sink;
+
+		std::printf(
+			"record %.2f ns, plain store %.2f ns\n",
+			nanos_per(elapsed, recordings), nanos_per(plainElapsed, recordings)
+		);
+	}
+
+	// the '/metrics' page and the plugin both walk the field table
+	void fields() {
+		sign_metrics metrics{};
+		u32 value = 1;
+		for (const auto &field : sign_metrics_fields::fields) {
+			metrics.*field.member = value++;
+		}
+
+		std::array<u32, sign_metrics_fields::fields.size()> words;
+		std::memcpy(words.data(), &metrics, sizeof(metrics));
+		std::sort(words.begin(), words.end());
+		expect(std::adjacent_find(words.begin(), words.end()) == words.end() and words.front() == 1, "every field is named once");
+
+		for (const auto &a : sign_metrics_fields::fields) {
+			for (const auto &b : sign_metrics_fields::fields) {
+				expect(&a == &b or std::strcmp(a.name, b.name) != 0, "names are unique");
+			}
+		}
+	}
+
+	// the body has a fixed layout of little endian words, in the order of the field table
+	void wire() {
+		sign_metrics metrics{}, decoded{};
+		u32 value = 1;
+		for (const auto &field : sign_metrics_fields::fields) {
+			metrics.*field.member = value++;
+		}
+
+		std::array<u8, sign_metrics_fields::encodedSize> body;
+		expect(sign_metrics_fields::encode(metrics, body) == 4 * sign_metrics_fields::fields.size(), "metrics take a word each");
+		expect(body[0] == 1 and body[4] == 2 and body[4 * 19] == 20 and body[4 * 19 + 1] == 0, "metrics are little endian words");
+		expect(sign_metrics_fields::decode(body, decoded), "metrics are decoded");
+		expect(std::memcmp(&metrics, &decoded, sizeof(metrics)) == 0, "metrics survive their encoding");
+
+		state_stats::summary summary{}, decodedSummary{};
+		for (usize i = 0; i < state_stats::numBuckets; i++) {
+			summary.histogram[i] = static_cast<u32>(i + 1);
+			summary.transitions[i] = static_cast<u32>(100 + i);
+		}
+		summary.visits = 7;
+		summary.totalMillis = 123456;
+		summary.maxMillis = 4000;
+		summary.currentMillis = 12;
+		std::strcpy(summary.name.data(), "STREAMING");
+		summary.state = 3;
+		summary.numStates = 9;
+		summary.active = true;
+
+		std::array<u8, state_stats::encodedSummarySize> statsBody;
+		expect(state_stats::encode(summary, statsBody) == statsBody.size(), "state stats fill their body");
+		expect(state_stats::encode(summary, std::span(statsBody).first(10)) == 0, "state stats need the whole body");
+		expect(state_stats::decode(statsBody, decodedSummary), "state stats are decoded");
+		expect(
+			decodedSummary.histogram == summary.histogram and decodedSummary.transitions == summary.transitions and
+			decodedSummary.visits == 7 and decodedSummary.totalMillis == 123456 and decodedSummary.maxMillis == 4000 and
+			decodedSummary.currentMillis == 12 and decodedSummary.name == summary.name and
+			decodedSummary.state == 3 and decodedSummary.numStates == 9 and decodedSummary.active,
+			"state stats survive their encoding"
+		);
+	}
+}
+
+int main(int argc, char **argv) {
+	const u32 recordings = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 10'000'000;
+
+	counters(recordings / 4);
+	timings(recordings);
+	fields();
+	wire();
+
+	return checks::result();
+}
@@ -0,0 +1,243 @@
+// Drives a state machine with the shape of the main task of the sign, same states,
+// transitions and argument lists with stand-ins for the platform types,
+// and reports how long a transition takes and how many of them are instantiated.
+// A second run records state stats, to show their overhead and what they contain.
+//
+// usage: state_machine_bench [transitions]
+
+#include <util/state_machine.hpp>
+#include <util/state_machine_stats.hpp>
+#include <util/uix.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <system_error>
+
+using namespace ztu::uix;
+
+namespace {
+
+	enum class task_states {
+		CHOOSE_TASK,
+
+		START_SETUP_SERVER,
+		WAIT_FOR_SETUP_COMPLETE,
+		STOP_SETUP_SERVER,
+		CONFIG_ERROR,
+
+		CONNECT_TO_WIFI,
+		PREPARE_CONNECTION,
+		CONNECT_TO_PLUGIN,
+		VALIDATE_CONNECTION,
+		RECEIVE_MESSAGE,
+		SETUP_ERROR
+	};
+	using enum task_states;
+
+	constexpr std::size_t numTaskStates = static_cast<std::size_t>(SETUP_ERROR) + 1;
+
+	constexpr std::array<const char*, numTaskStates> taskStateNames{
+		"choose_task", "start_setup_server", "wait_for_setup_complete", "stop_setup_server",
+		"config_error", "connect_to_wifi", "prepare_connection", "connect_to_plugin",
+		"validate_connection", "receive_message", "setup_error"
+	};
+
+	using task_stats_t = state_machine_stats<task_states, numTaskStates, []() -> i64 {
+		using namespace std::chrono;
+		return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	}>;
+
+	// stand-ins that own something, so moving them is not free
+	struct access_point { std::string ssid{ "sign" }; };
+	struct client { std::string ssid{ "network" }; };
+	struct acceptor { int fd{ -1 }; };
+	struct sha_engine { std::array<u8, 128> key{}; };
+	struct aes_engine { std::array<u8, 240> schedule{}; };
+	struct connection { int fd{ -1 }; std::array<u8, 64> buffer{}; };
+	enum class handshake_state { CREATE_CHALLENGE, SEND_CHALLENGE, RECEIVE_OK };
+	enum class receive_state { INIT_RECEIVE, RECEIVE_HEADER, HANDLE_MESSAGE };
+
+	usize counter = 0;
+
+	// runs through setup once every 64 connections and drops the connection every 16 messages
+	task_states after(task_states state) {
+		counter++;
+		switch (state) {
+			case CHOOSE_TASK: return counter % 64 == 0 ? START_SETUP_SERVER : CONNECT_TO_WIFI;
+			case START_SETUP_SERVER: return WAIT_FOR_SETUP_COMPLETE;
+			case WAIT_FOR_SETUP_COMPLETE: return counter % 4 == 0 ? STOP_SETUP_SERVER : WAIT_FOR_SETUP_COMPLETE;
+			case STOP_SETUP_SERVER: return CHOOSE_TASK;
+			case CONNECT_TO_WIFI: return PREPARE_CONNECTION;
+			case PREPARE_CONNECTION: return CONNECT_TO_PLUGIN;
+			case CONNECT_TO_PLUGIN: return VALIDATE_CONNECTION;
+			case VALIDATE_CONNECTION: return counter % 3 == 0 ? RECEIVE_MESSAGE : VALIDATE_CONNECTION;
+			case RECEIVE_MESSAGE:
+				if (counter % 128 == 0) return SETUP_ERROR;
+				return counter % 16 == 0 ? CONNECT_TO_PLUGIN : RECEIVE_MESSAGE;
+			default: return CHOOSE_TASK;
+		}
+	}
+
+	struct choose_task {
+		static constexpr auto states = std::array{ CHOOSE_TASK, SETUP_ERROR, CONFIG_ERROR };
+		static constexpr auto transitions = std::array{ CONFIG_ERROR, CONNECT_TO_WIFI, START_SETUP_SERVER, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&) {
+			return after(state);
+		}
+	};
+
+	struct start_setup_server {
+		static constexpr auto states = std::array{ START_SETUP_SERVER };
+		static constexpr auto transitions = std::array{ CONFIG_ERROR, START_SETUP_SERVER, WAIT_FOR_SETUP_COMPLETE, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, access_point&, int&) {
+			return after(state);
+		}
+	};
+
+	struct wait_for_setup_complete {
+		static constexpr auto states = std::array{ WAIT_FOR_SETUP_COMPLETE };
+		static constexpr auto transitions = std::array{ WAIT_FOR_SETUP_COMPLETE, STOP_SETUP_SERVER, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, access_point&) {
+			return after(state);
+		}
+	};
+
+	struct stop_setup_server {
+		static constexpr auto states = std::array{ STOP_SETUP_SERVER };
+		static constexpr auto transitions = std::array{ CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, access_point&) {
+			return after(state);
+		}
+	};
+
+	struct connect_to_wifi {
+		static constexpr auto states = std::array{ CONNECT_TO_WIFI };
+		static constexpr auto transitions = std::array{ CONNECT_TO_WIFI, PREPARE_CONNECTION, SETUP_ERROR, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, client&, int&) {
+			return after(state);
+		}
+	};
+
+	struct prepare_connection {
+		static constexpr auto states = std::array{ PREPARE_CONNECTION };
+		static constexpr auto transitions = std::array{ CONNECT_TO_WIFI, CONNECT_TO_PLUGIN, SETUP_ERROR, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, client&, acceptor&, sha_engine&, aes_engine&) {
+			return after(state);
+		}
+	};
+
+	struct connect_to_plugin {
+		static constexpr auto states = std::array{ CONNECT_TO_PLUGIN };
+		static constexpr auto transitions = std::array{ CONNECT_TO_PLUGIN, VALIDATE_CONNECTION, SETUP_ERROR, CHOOSE_TASK };
+		static task_states run(task_states state, std::error_code&, client&, acceptor&, sha_engine&, aes_engine&, connection&) {
+			return after(state);
+		}
+	};
+
+	struct validate_connection {
+		static constexpr auto states = std::array{ VALIDATE_CONNECTION };
+		static constexpr auto transitions = std::array{ CONNECT_TO_PLUGIN, VALIDATE_CONNECTION, RECEIVE_MESSAGE, SETUP_ERROR, CHOOSE_TASK };
+		static task_states run(
+			task_states state, std::error_code&, client&, acceptor&, sha_engine&, aes_engine&, connection&,
+			handshake_state&, std::array<u8, 64>&, std::array<u8, 64>&, std::span<u8>&
+		) {
+			return after(state);
+		}
+	};
+
+	struct receive_message {
+		static constexpr auto states = std::array{ RECEIVE_MESSAGE };
+		static constexpr auto transitions = std::array{ CONNECT_TO_PLUGIN, RECEIVE_MESSAGE, SETUP_ERROR, CHOOSE_TASK };
+		static task_states run(
+			task_states state, std::error_code&, client&, acceptor&, sha_engine&, aes_engine&, connection&,
+			receive_state&, std::array<u8, 256>&, std::span<u8>&, i64&
+		) {
+			return after(state);
+		}
+	};
+}
+
+template<class Instrumentation>
+double run_machine(usize numSteps, Instrumentation instrumentation, usize &changes) {
+	usize remaining = numSteps;
+	auto on_state_change = [&](task_states from, task_states &to) {
+		changes += from != to;
+		return --remaining != 0;
+	};
+
+	basic_state_machine<
+		Instrumentation,
+		decltype(on_state_change),
+		choose_task,
+		start_setup_server,
+		wait_for_setup_complete,
+		stop_setup_server,
+		connect_to_wifi,
+		prepare_connection,
+		validate_connection,
+		connect_to_plugin,
+		receive_message
+	> machine(std::move(on_state_change), instrumentation);
+
+	const auto begin = std::chrono::steady_clock::now();
+	machine.run(CHOOSE_TASK);
+	const auto time = std::chrono::steady_clock::now() - begin;
+
+	return std::chrono::duration<double, std::nano>(time).count() / static_cast<double>(numSteps);
+}
+
+int main(int argc, char **argv) {
+	const auto numSteps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+	using machine_t = state_machine<
+		bool(*)(task_states, task_states&),
+		choose_task,
+		start_setup_server,
+		wait_for_setup_complete,
+		stop_setup_server,
+		connect_to_wifi,
+		prepare_connection,
+		validate_connection,
+		connect_to_plugin,
+		receive_message
+	>;
+
+	usize changes = 0;
+	const auto plainNanos = run_machine(numSteps, no_instrumentation{}, changes);
+	std::printf("%llu steps, %zu state changes, %.2f ns per step\n", numSteps, changes, plainNanos);
+	std::printf("%zu instantiated transitions\n", machine_t::num_transitions());
+
+	auto failed = counter != numSteps;
+
+	static task_stats_t stats;
+	counter = changes = 0;
+	const auto instrumentedNanos = run_machine<task_stats_t&>(numSteps, stats, changes);
+	std::printf("%.2f ns per step with stats\n\n", instrumentedNanos);
+
+	std::printf("%-24s %9s %10s %8s %8s  dwell histogram (<1ms, <2ms, <4ms, ...)\n", "state", "visits", "steps", "total ms", "max ms");
+
+	u64 steps = 0, visits = 0;
+	for (usize i = 0; i < numTaskStates; i++) {
+		const auto summary = *stats.summary(static_cast<task_states>(i));
+		const auto stateSteps = std::accumulate(summary.transitions.begin(), summary.transitions.end(), u64{ 0 });
+		steps += stateSteps;
+		visits += summary.visits;
+
+		std::printf(
+			"%-24s %9u %10llu %8u %8u ",
+			taskStateNames[i], summary.visits, static_cast<unsigned long long>(stateSteps), summary.totalMillis, summary.maxMillis
+		);
+		for (const auto count : summary.histogram) {
+			std::printf(" %u", count);
+		}
+		std::printf("\n");
+	}
+
+	// every step is counted once and every change enters a state, as does the start
+	failed |= steps != numSteps or stats.steps() != numSteps or visits != changes + 1;
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2,9 +2,14 @@
 
 
 #include <config/app_config.hpp>
+#include <config/config_snapshot.hpp>
+#include <file_watcher.hpp>
 #include <domain_logic/sign_transceiver.hpp>
 #include <hmac_sha_512_handshake.hpp>
 
+#include <deque>
+#include <functional>
+
 class app {
 public:
 	app() = default;
@@ -13,12 +18,44 @@ public:
 
 	void changeState(const sign_state &newState);
 
+	void setParams(const sign_animation_params &newParams);
+
+	[[nodiscard]] sign_animation_params currentParams() const;
+
 	~app();
 
 private:
 
 	void loadConfig(const std::string_view &configFileName);
 
+	[[nodiscard]] static std::optional<app_config_t> loadConfigSnapshot(
+		const std::filesystem::path &filename, const config_snapshot::source_key &key
+	);
+
+	/**
+	 * @return The config from its snapshot or json or 'std::nullopt' if the json cannot be parsed.
+	 */
+	[[nodiscard]] static std::optional<app_config_t> readConfig(const std::filesystem::path &filename);
+
+	static void saveConfigSnapshot(
+		const std::filesystem::path &filename, const config_snapshot::source_key &key, const app_config_t &snapshotConfig
+	);
+
+	/**
+	 * @brief Called by the config watcher, sends the animations that changed in the config file to the sign.
+	 * The connection settings and the frame library only apply after a restart.
+	 */
+	void reloadConfig();
+
+	template<typename F>
+	static void forEachStateAnimation(F &&f);
+
+	/**
+	 * @brief Adds the 'animation_seed' of the config, signs with the same seed show the same random colors.
+	 * Like the animations, the seed may only be read while holding 'animationMutex'.
+	 */
+	[[nodiscard]] sign_animation seeded(const sign_basic_animation &animation) const;
+
 	[[nodiscard]] std::error_code initEncryptionEngines();
 
 	void handleConnection();
@@ -29,15 +66,52 @@ private:
 
 	void sendDecoyCommands();
 
+	[[nodiscard]] std::error_code synchronizeClock();
+
+	[[nodiscard]] std::error_code receiveMessage(sign_message &message);
+
+	[[nodiscard]] std::error_code uploadFrameLibrary();
+
+	/**
+	 * @brief Logs how long the sign spent in each state of its main task.
+	 */
+	[[nodiscard]] std::error_code logStateStats();
+
+	/**
+	 * @brief Logs the runtime metrics of the sign, the same numbers its '/metrics' page shows during setup.
+	 */
+	[[nodiscard]] std::error_code logMetrics();
+
+	template<sign_message_type Type, sign_message_type ReplyType, typename Reply, typename... Args>
+	[[nodiscard]] std::error_code request(Reply &reply, const Args&... args);
+
+	[[nodiscard]] static i64 referenceTime();
+
+	/**
+	 * @brief Sends the message right away, only the connection thread does so.
+	 * Other threads use 'postMessage', so their messages take the place of a heartbeat.
+	 */
 	template<sign_message_type Type, typename... Args>
 	void sendMessage(Args&&... args);
 
+	/**
+	 * @brief Queues the message for the connection thread, so callers on the OBS threads never wait
+	 * for a clock synchronization or request that holds the connection, and the heartbeat interval
+	 * starts over once it is sent.
+	 */
+	template<sign_message_type Type, typename... Args>
+	void postMessage(Args&&... args);
+
 	void disconnect();
 
 private:
 	app_config_t config;
+	std::filesystem::path configFilename;
+	file_watcher configWatcher;
+	std::mutex animationMutex;
 
 	std::atomic<sign_state> state{ sign_state::IDLE };
+	std::atomic<sign_animation_params> params{};
 
 	std::array<uint8_t, 64 + 32> secret;
 	socket_connection connection{};
@@ -48,5 +122,6 @@ private:
 	std::thread connectionThread;
 	std::mutex intervalMutex, connectionMutex;
 	std::condition_variable intervalDisruptor;
+	std::deque<std::function<void()>> outbox;		// guarded by 'intervalMutex'
 	std::atomic_bool connected{ false }, reconnect{ true };
 };
\ No newline at end of file
@@ -58,11 +58,17 @@ namespace app_default_config {
 		>{}
 	>{};
 
+	constexpr auto default_sign_library_stop_motion = holds<"LIBRARY_STOP_MOTION",
+		set<"clip", 0_U>{},
+		set<"ticksPerFrame", 1_U>{}
+	>{};
+
 	constexpr auto default_sign_basic_animation = json_sign_basic_animation<"MOVING_COLORS"_S,
 		default_sign_uniform_color,
 		default_sign_moving_colors,
 		default_sign_moving_pixel,
-		default_sign_stop_motion
+		default_sign_stop_motion,
+		default_sign_library_stop_motion
 	>{};
 
 	constexpr auto default_sign_animation = json_sign_animation<
@@ -90,7 +96,8 @@ namespace app_default_config {
 			>{},
 			default_sign_moving_colors,
 			default_sign_moving_pixel,
-			default_sign_stop_motion
+			default_sign_stop_motion,
+			default_sign_library_stop_motion
 		>{}
 	);
 
@@ -105,6 +112,8 @@ namespace app_default_config {
 			set<"PROCESSING",		default_uniform_color_animation<"f0f 0f0"_S>>{},
 			set<"SETUP",			default_uniform_color_animation<"ff0"_S>>{}
 		>{}>{},
+		set<"frame_library", ""_S>{},
+		set<"animation_seed", 0_U>{},
 		set<"connection", object<
 			set<"ip",		"192.168.2.222"_S>{},
 			set<"port",		65025_U>{},
@@ -128,7 +137,8 @@ namespace app_default_config {
 				  >{}
 			>{}>{},
 			set<"heartbeat_interval",	10'000_U>{},
-			set<"heartbeat_correction",	0.3_N>{}
+			set<"heartbeat_correction",	0.3_N>{},
+			set<"clock_sync_interval",	30'000_U>{}
 		>{}>{}
 	 >{};
 }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <config/app_config.hpp>
+#include <util/uix.hpp>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/**
+ * Binary copy of the parsed config, stored next to 'config.json' so the plugin can skip
+ * parsing the json and converting its animations while OBS starts.
+ *
+ * A snapshot is only used by a plugin with the same config schema and defaults,
+ * and only for the json file it was made from.
+ */
+namespace config_snapshot {
+
+	/**
+	 * @brief Identifies the json file a snapshot was made from.
+	 */
+	struct source_key {
+		u64 size;
+		i64 modified;
+		u64 hash;
+
+		[[nodiscard]] bool operator==(const source_key &) const = default;
+	};
+
+	[[nodiscard]] source_key key_of(std::string_view json, std::filesystem::file_time_type modified);
+
+	[[nodiscard]] std::vector<u8> save(const app_config_t &config, const source_key &key);
+
+	/**
+	 * @return The config or 'std::nullopt' if the snapshot is damaged, outdated or made from another file.
+	 */
+	[[nodiscard]] std::optional<app_config_t> load(std::span<const u8> snapshot, const source_key &key);
+}
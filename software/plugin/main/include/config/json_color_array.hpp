@@ -5,73 +5,245 @@
 #include <lighting/color.hpp>
 #include <vector>
 #include <util/for_each.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+using namespace ztu::uix;
 
 namespace color_array_detail {
 	using namespace json::safe;
 	using namespace default_values;
 
-	struct string_color_array_converter {
-		using x_t = string_t;
-		using y_t = std::vector<color>;
+	/**
+	 * Decoding of color strings like "f00 ff8800 0f0" eight characters at a time.
+	 * Every word is classified and converted to nibbles with a few integer operations,
+	 * which needs no instruction set extension and runs on every platform OBS supports.
+	 */
+	namespace hex_colors {
 
-		static std::optional<y_t> convert(const x_t &x) {
+		inline constexpr u64 bytewise(const u8 byte) {
+			return 0x0101010101010101ull * byte;
+		}
 
-			std::vector<color> colors;
-			colors.reserve(x.length() / 4);
+		// Bit 7 of a byte is set if the byte lies strictly between Low and High, never for bytes above 127.
+		template<u8 Low, u8 High>
+		inline constexpr u64 between(const u64 word) {
+			static_assert(High <= 128);
+			const auto low7 = word & bytewise(0x7f);
+			return (bytewise(127 + High) - low7) & ~word & (low7 + bytewise(127 - Low)) & bytewise(0x80);
+		}
 
-			u8 numHexChars = 0;
-			std::array<u8, 6> buffer{};
+		// Bit 7 of a byte is set if the byte equals Byte.
+		template<u8 Byte>
+		inline constexpr u64 equal(const u64 word) {
+			const auto diff = word ^ bytewise(Byte);
+			return ~(((diff & bytewise(0x7f)) + bytewise(0x7f)) | diff | bytewise(0x7f));
+		}
 
-			const auto pushColor = [&]() {
-				switch (numHexChars) {
-				case 6:
-					colors.emplace_back(
-						static_cast<u8>(16 * buffer[0] + buffer[1]),
-						static_cast<u8>(16 * buffer[2] + buffer[3]),
-						static_cast<u8>(16 * buffer[4] + buffer[5])
-					);
-					break;
-				case 3:
-					colors.emplace_back(
-						static_cast<u8>(17 * buffer[0]),
-						static_cast<u8>(17 * buffer[1]),
-						static_cast<u8>(17 * buffer[2])
-					);
-					break;
-				default:
-					return false;
-				}
+		// Bit i of the result is bit 7 of byte i.
+		inline constexpr u8 gather(const u64 mask) {
+			return static_cast<u8>(((mask >> 7) * 0x0102040810204080ull) >> 56);
+		}
+
+		inline u64 load(const char *chars) {
+			u64 word;
+			std::memcpy(&word, chars, sizeof(word));
+			if constexpr (std::endian::native == std::endian::big) {
+				word = std::byteswap(word);
+			}
+			return word;
+		}
 
-				std::fill(buffer.begin(), buffer.end(), 0);
-				numHexChars = 0;
+		struct classified_word {
+			u64 chars;
+			u64 nibbles;	// byte i holds the value of character i if it is a hex digit
+			u64 hex;		// bit 7 of byte i is set if character i is a hex digit
+		};
 
-				return true;
+		inline classified_word classify(const char *chars) {
+			const auto word = load(chars);
+			const auto digits = between<'0' - 1, '9' + 1>(word);
+			const auto letters = between<'a' - 1, 'f' + 1>(word | bytewise(0x20));
+			return {
+				.chars = word,
+				.nibbles = (word & bytewise(0x0f)) + (letters >> 7) * 9,
+				.hex = digits | letters
 			};
+		}
+
+		// six digit group in the bytes 0 to 5
+		inline constexpr color longColor(const u64 nibbles) {
+			const auto channels = ((nibbles << 4) | (nibbles >> 8)) & 0x00ff00ff00ff00ffull;
+			return { static_cast<u8>(channels), static_cast<u8>(channels >> 16), static_cast<u8>(channels >> 32) };
+		}
 
-			for (const char c : x) {
-				u8 byte = 0x80;
-				if ('0' <= c && c <= '9') {
-					byte = c - '0';
-				} else if ('a' <= c && c <= 'f') {
-					byte = 10 + c - 'a';
-				} else if ('A' <= c && c <= 'F') {
-					byte = 10 + c - 'A';
+		// three digit group in the bytes 'Offset' to 'Offset' + 2
+		template<int Offset>
+		inline constexpr color shortColor(const u64 nibbles) {
+			const auto channels = (nibbles | (nibbles << 4)) >> (8 * Offset);
+			return { static_cast<u8>(channels), static_cast<u8>(channels >> 8), static_cast<u8>(channels >> 16) };
+		}
+
+		inline constexpr u8 hexValue(const char c) {
+			if ('0' <= c && c <= '9') {
+				return c - '0';
+			} else if ('a' <= c && c <= 'f') {
+				return 10 + c - 'a';
+			} else if ('A' <= c && c <= 'F') {
+				return 10 + c - 'A';
+			}
+			return 0x80;
+		}
+
+		inline constexpr bool decodeGroup(const std::string_view group, color &dst) {
+			std::array<u8, 6> nibbles{};
+			if (group.size() != 3 and group.size() != 6)
+				return false;
+
+			for (usize i = 0; i != group.size(); i++) {
+				if ((nibbles[i] = hexValue(group[i])) & 0x80)
+					return false;
+			}
+
+			if (group.size() == 6) {
+				dst = {
+					static_cast<u8>(16 * nibbles[0] + nibbles[1]),
+					static_cast<u8>(16 * nibbles[2] + nibbles[3]),
+					static_cast<u8>(16 * nibbles[4] + nibbles[5])
+				};
+			} else {
+				dst = {
+					static_cast<u8>(17 * nibbles[0]),
+					static_cast<u8>(17 * nibbles[1]),
+					static_cast<u8>(17 * nibbles[2])
+				};
+			}
+
+			return true;
+		}
+
+		/**
+		 * @return The number of colors in a string that 'decode' accepts.
+		 */
+		inline usize count(const std::string_view text) {
+			usize spaces = 0, pos = 0;
+			while (pos + 8 <= text.size()) {
+				// one counter per byte, summed up before any of them can overflow
+				u64 counters = 0;
+				for (auto i = 0; i != 255 and pos + 8 <= text.size(); i++, pos += 8) {
+					counters += equal<' '>(load(text.data() + pos)) >> 7;
 				}
+				const auto pairs = (counters & 0x00ff00ff00ff00ffull) + ((counters >> 8) & 0x00ff00ff00ff00ffull);
+				spaces += (pairs * 0x0001000100010001ull) >> 48;
+			}
+			return spaces + std::ranges::count(text.substr(pos), ' ') + 1;
+		}
 
-				if (byte & 0x80) {
-					if (not (c == ' ' and pushColor())) {
-						return std::nullopt;
+		// If all groups have the same length, every group starts at a known position. The words
+		// are then decoded without a branch and validated at once, which lets iterations overlap,
+		// and the spaces are compared in place instead of being searched.
+		// Both return the number of decoded colors, or zero if the text is not made of such groups.
+
+		inline usize decodeLongColors(const std::string_view text, const std::span<color> colors) {
+			constexpr auto hexDigits = 0x0000ffffffffffffull, spaces = 0x00ff000000000000ull;
+
+			u64 mismatches = 0;
+			usize i = 0;
+			for (; 7 * i + 8 <= text.size(); i++) {
+				const auto word = classify(text.data() + 7 * i);
+				mismatches |= ((word.hex ^ bytewise(0x80)) & hexDigits) | ((word.chars ^ bytewise(' ')) & spaces);
+				colors[i] = longColor(word.nibbles);
+			}
+
+			return mismatches ? 0 : i;
+		}
+
+		inline usize decodeShortColors(const std::string_view text, const std::span<color> colors) {
+			constexpr auto hexDigits = 0x00ffffff00ffffffull, spaces = 0xff000000ff000000ull;
+
+			u64 mismatches = 0;
+			usize i = 0;
+			for (; 8 * i + 8 <= text.size(); i++) {
+				const auto word = classify(text.data() + 8 * i);
+				mismatches |= ((word.hex ^ bytewise(0x80)) & hexDigits) | ((word.chars ^ bytewise(' ')) & spaces);
+				colors[2 * i] = shortColor<0>(word.nibbles);
+				colors[2 * i + 1] = shortColor<4>(word.nibbles);
+			}
+
+			return mismatches ? 0 : 2 * i;
+		}
+
+		/**
+		 * @brief Decodes groups of 3 or 6 hex digits separated by single spaces into exactly 'count(text)' colors.
+		 *
+		 * @return false if the text contains anything else, including leading, trailing or double spaces,
+		 * or if the number of colors does not match.
+		 */
+		inline bool decode(const std::string_view text, const std::span<color> colors) {
+			if (colors.empty())
+				return false;
+
+			usize decoded = 0, pos = 0;
+			if (text.size() == 7 * colors.size() - 1) {
+				decoded = decodeLongColors(text, colors);
+				pos = 7 * decoded;
+			} else if (text.size() == 4 * colors.size() - 1) {
+				decoded = decodeShortColors(text, colors);
+				pos = 4 * decoded;
+			}
+
+			auto dst = colors.begin() + static_cast<std::ptrdiff_t>(decoded);
+
+			// Mixed group lengths, every group read here ends with a space, so the last one is left for the tail.
+			while (pos + 8 <= text.size() and colors.end() - dst >= 2) {
+				const auto word = classify(text.data() + pos);
+				const auto space = equal<' '>(word.chars);
+				if ((word.hex | space) != bytewise(0x80))
+					return false;
+
+				const auto spaces = gather(space);
+				if ((spaces & 0x0f) == 0x08) {
+					*dst++ = shortColor<0>(word.nibbles);
+					if ((spaces & 0xf0) == 0x80) {
+						*dst++ = shortColor<4>(word.nibbles);
+						pos += 8;
+					} else {
+						pos += 4;
 					}
-				} else if (numHexChars == 6) {
-					return std::nullopt;
+				} else if ((spaces & 0x7f) == 0x40) {
+					*dst++ = longColor(word.nibbles);
+					pos += 7;
 				} else {
-					buffer[numHexChars++] = byte;
+					return false;
 				}
 			}
 
+			auto tail = text.substr(pos);
+			while (true) {
+				const auto end = tail.find(' ');
+				if (dst == colors.end() or not decodeGroup(tail.substr(0, end), *dst++))
+					return false;
+				if (end == std::string_view::npos)
+					break;
+				tail.remove_prefix(end + 1);
+			}
+
+			return dst == colors.end();
+		}
+	}
+
+	struct string_color_array_converter {
+		using x_t = string_t;
+		using y_t = std::vector<color>;
+
+		static std::optional<y_t> convert(const x_t &x) {
 			std::optional<y_t> y;
 
-			if (pushColor()) {
+			std::vector<color> colors(hex_colors::count(x));
+			if (hex_colors::decode(x, colors)) {
 				y.emplace(std::move(colors));
 			}
 
@@ -92,7 +264,7 @@ namespace color_array_detail {
 						auto &digit = digits[Index];
 						digit.first = channel / 16;
 						digit.second = channel - 16 * digit.first;
-						shortNotation &= digit.second == 0;
+						shortNotation &= digit.first == digit.second;
 						return false;
 					},
 					r, g, b
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <platform/safe_json.hpp>
+#include <util/schema.hpp>
+#include <ranges>
+
+// Generates json converters from the 'ztu::schema' descriptions in the common code.
+// The json defaults only have to use the same keys, missing or misspelled keys fail to compile.
+
+namespace json_schema_detail {
+	using namespace json::safe;
+	using namespace default_values;
+
+	template<ztu::string_literal Name>
+	inline constexpr auto key = [] {
+		string_literal<Name.max_size + 1> jsonKey{};
+		std::copy_n(Name.begin(), Name.max_size, jsonKey.value.begin());
+		return jsonKey;
+	}();
+
+	template<class Field>
+	inline bool convertField(const auto &x, auto &y) {
+		using accessor = Field::accessor;
+		const auto &value = x.template get<key<Field::name>>();
+		return accessor::set(y, static_cast<typename accessor::value_type>(value));
+	}
+
+	template<class Field>
+	inline void revertField(const auto &y, auto &x) {
+		using accessor = Field::accessor;
+		auto &value = x.template get<key<Field::name>>();
+		using value_t = std::remove_cvref_t<decltype(value)>;
+
+		const auto &field = accessor::get(y);
+		if constexpr (std::ranges::range<std::remove_cvref_t<decltype(field)>>) {
+			value = value_t(field.begin(), field.end());
+		} else {
+			value = static_cast<value_t>(field);
+		}
+	}
+
+	template<class Fields>
+	inline bool convertFields(const auto &x, auto &y) {
+		return not ztu::schema::for_each_indexed<Fields>([&]<auto, class Field>() {
+			return not convertField<Field>(x, y);
+		});
+	}
+
+	template<class Fields>
+	inline void revertFields(const auto &y, auto &x) {
+		ztu::schema::for_each_indexed<Fields>([&]<auto, class Field>() {
+			revertField<Field>(y, x);
+			return false;
+		});
+	}
+
+	template<json_default_object DefaultObject_t, ztu::schema::described_object T>
+	struct object_schema_converter {
+		using x_t = DefaultObject_t::type;
+		using y_t = T;
+		using fields = ztu::schema::of<T>::fields;
+
+		static std::optional<y_t> convert(const x_t &x) {
+			std::optional<y_t> y{ std::in_place };
+			if (not convertFields<fields>(x, *y)) {
+				y = std::nullopt;
+			}
+			return y;
+		}
+
+		static std::optional<x_t> revert(const y_t &y) {
+			std::optional<x_t> x{ std::in_place };
+			revertFields<fields>(y, *x);
+			return x;
+		}
+	};
+
+	template<json_default_variant DefaultVariant_t, ztu::schema::described_variant T>
+	struct variant_schema_converter {
+		using x_t = DefaultVariant_t::type;
+		using y_t = T;
+		using alternatives = ztu::schema::of<T>::alternatives;
+
+		static std::optional<y_t> convert(const x_t &x) {
+			std::optional<y_t> y;
+			ztu::schema::for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+				const auto value = x.template get_if<key<Alternative::name>>();
+				if (value == nullptr)
+					return false;
+				y.emplace(std::in_place_index<Index>);
+				if (not convertFields<typename Alternative::fields>(*value, std::get<Index>(*y))) {
+					y = std::nullopt;
+				}
+				return true;
+			});
+			return y;
+		}
+
+		static std::optional<x_t> revert(const y_t &y) {
+			std::optional<x_t> x;
+			ztu::schema::for_each_indexed<alternatives>([&]<auto Index, class Alternative>() {
+				if (y.index() != Index)
+					return false;
+				constexpr auto name = key<Alternative::name>;
+				x.emplace(in_place_name<name>);
+				revertFields<typename Alternative::fields>(std::get<Index>(y), x->template get<name>());
+				return true;
+			});
+			return x;
+		}
+	};
+}
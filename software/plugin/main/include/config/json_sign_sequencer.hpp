@@ -2,6 +2,7 @@
 
 #include <platform/safe_json.hpp>
 #include <util/uix.hpp>
+#include "json_schema.hpp"
 #include "json_sign_supplier.hpp"
 #include "json_sign_mix_type.hpp"
 
@@ -11,24 +12,7 @@ namespace json_sign_sequencer_detail {
 
 
 	template<json_default_object DefaultObject_t>
-	struct json_sign_sequencer_converter {
-		using x_t = DefaultObject_t::type;
-		using y_t = sign_sequencer;
-
-		static std::optional<y_t> convert(const x_t &x) {
-			return y_t{
-				x.template get<"supplier">(),
-				static_cast<sign_mix_type>(x.template get<"mixType">())
-			};
-		};
-
-		static std::optional<x_t> revert(const y_t &y) {
-			return x_t{
-				y.supplier,
-				static_cast<u16>(y.mixType)
-			};
-		};
-	};
+	using json_sign_sequencer_converter = json_schema_detail::object_schema_converter<DefaultObject_t, sign_sequencer>;
 
 	template<json_default_object DefaultObject_t>
 	using json_sign_sequencer_adapter = adapter<DefaultObject_t, sign_sequencer, json_sign_sequencer_converter<DefaultObject_t>>;
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <platform/inotify_file_watcher.hpp>
+
+using file_watcher = inotify_file_watcher;
+
+#else
+
+#include <platform/polling_file_watcher.hpp>
+
+using file_watcher = polling_file_watcher;
+
+#endif
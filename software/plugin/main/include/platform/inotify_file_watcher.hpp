@@ -0,0 +1,34 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+class inotify_file_watcher {
+public:
+	using callback_t = std::function<void()>;
+
+	inotify_file_watcher() = default;
+
+	/**
+	 * @brief Calls 'onChange' on the thread of the watcher after 'filename' got written or replaced.
+	 *
+	 * The directory is watched instead of the file, editors that save by renaming
+	 * a temporary file over the original would otherwise end the watch.
+	 * A burst of events, like the several steps of a save, results in a single call.
+	 */
+	[[nodiscard]] std::error_code watch(const std::filesystem::path &filename, callback_t onChange);
+
+	void stop();
+
+	~inotify_file_watcher();
+
+private:
+	void run(std::string name, callback_t onChange);
+
+	int notifyFd{ -1 };
+	int stopFd{ -1 };
+	std::thread thread;
+};
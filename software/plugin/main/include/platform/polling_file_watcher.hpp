@@ -0,0 +1,35 @@
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+/**
+ * @brief Fallback for platforms without inotify, compares the modification time and size of the file twice a second.
+ */
+class polling_file_watcher {
+public:
+	using callback_t = std::function<void()>;
+
+	polling_file_watcher() = default;
+
+	/**
+	 * @brief Calls 'onChange' on the thread of the watcher after 'filename' got written or replaced.
+	 */
+	[[nodiscard]] std::error_code watch(const std::filesystem::path &filename, callback_t onChange);
+
+	void stop();
+
+	~polling_file_watcher();
+
+private:
+	void run(std::filesystem::path filename, callback_t onChange);
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable stopSignal;
+	bool stopping{ false };
+};
@@ -17,10 +17,11 @@
 #include <limits>
 #include <fstream>
 #include <ostream>
-#include <format>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
+#include <bit>
+#include <charconv>
 #include <stdexcept>
 
 #include <iostream>
@@ -266,12 +267,15 @@ namespace string_literals {
 
 namespace json::transcoding {
 
+	// 'beginsWith' gets the first character as 'unsigned char' or -1 at the end of the input
+	// and has to be constexpr, the tokenizer builds its dispatch table from it.
+	// 'read' consumes the token from the front of the input, it returns 'std::nullopt' if the token is malformed.
 	template<class T, typename Enum>
 	concept token = (
 		std::same_as<Enum, typename T::enum_t> &&
-		requires(const T::value_t value, std::vector<char> buffer, std::istream is, std::ostream os) {
-			{ T::beginsWith(is)		} -> std::same_as<bool>;
-			{ T::read(is, buffer)	} -> std::same_as<typename T::value_t>; // std::optional<...>
+		requires(const T::value_t value, std::string_view input, int c, std::ostream os) {
+			{ T::beginsWith(c)		} -> std::same_as<bool>;
+			{ T::read(input)		} -> std::same_as<std::optional<typename T::value_t>>;
 			{ T::write(os, value)	} -> std::same_as<void>;
 			{ T::name()				} -> std::same_as<std::string_view>;
 			{ T::type()				} -> std::same_as<typename T::enum_t>;
@@ -314,8 +318,7 @@ namespace json::transcoding {
 				using base_t = json_token_base<Type, Name, uint8_t>;
 				using typename base_t::value_t;
 
-				inline static bool beginsWith(std::istream &is) {
-					const auto c = is.peek();
+				inline constexpr static bool beginsWith(int c) {
 					return constexpr_for::values<Spellings...>(
 						[&]<auto Spelling>() {
 							return c == Spelling[0];
@@ -323,23 +326,19 @@ namespace json::transcoding {
 					);
 				}
 
-				inline static value_t read(std::istream &is, std::vector<char> &) {
-					value_t index = 255;
-					const auto foundSpelling = constexpr_for::indexed_values<Spellings...>(
+				inline static std::optional<value_t> read(std::string_view &input) {
+					std::optional<value_t> index;
+					constexpr_for::indexed_values<Spellings...>(
 						[&]<auto Index, auto Spelling>() {
-							for (const auto &c: Spelling) {
-								if (is.peek() != c) {
-									return false;
-								}
-								is.get();
+							const auto spelling = std::string_view(Spelling.c_str(), Spelling.size());
+							if (not input.starts_with(spelling)) {
+								return false;
 							}
+							input.remove_prefix(spelling.size());
 							index = Index;
 							return true;
 						}
 					);
-					if (not foundSpelling) {
-						throw std::runtime_error("wrong spelling");
-					}
 					return index;
 				}
 
@@ -362,23 +361,23 @@ namespace json::transcoding {
 				using base_t = json_token_base<Type, Name, std::string_view>;
 				using typename base_t::value_t;
 
-				inline static bool beginsWith(std::istream &is) {
-					return is.peek() == BeginChar;
+				inline constexpr static bool beginsWith(int c) {
+					return c == BeginChar;
 				}
 
-				inline static value_t read(std::istream &is, std::vector<char> &buffer) {
-					[[maybe_unused]] const auto first = is.get();
-					assert(first == BeginChar);
-					assert(buffer.empty());
-					char c;
-					while ((c = static_cast<char>(is.get())) != EndChar) {
-						if (c == '\n') [[unlikely]] {
-							is.setstate(std::ios_base::failbit);
-							break;
-						}
-						buffer.push_back(c);
-					};
-					return { buffer.data(), buffer.data() + buffer.size() };
+				// The value is a view into the input, nothing gets copied.
+				inline static std::optional<value_t> read(std::string_view &input) {
+					assert(input.front() == BeginChar);
+					const auto end = input.find(EndChar, 1);
+					if (end == std::string_view::npos) [[unlikely]] {
+						return std::nullopt;
+					}
+					const auto value = input.substr(1, end - 1);
+					if (value.find('\n') != std::string_view::npos) [[unlikely]] {
+						return std::nullopt;
+					}
+					input.remove_prefix(end + 1);
+					return value;
 				}
 
 				inline static void write(std::ostream &os, const value_t &value) {
@@ -391,14 +390,21 @@ namespace json::transcoding {
 				using base_t = json_token_base<Type, Name, double>;
 				using typename base_t::value_t;
 
-				inline static bool beginsWith(std::istream &is) {
-					const auto c = is.peek();
-					return std::isdigit(c) or c == '-' or c == '+';
+				inline constexpr static bool beginsWith(int c) {
+					return ('0' <= c and c <= '9') or c == '-' or c == '+';
 				}
 
-				inline static value_t read(std::istream &is, std::vector<char> &) {
+				inline static std::optional<value_t> read(std::string_view &input) {
+					// 'from_chars' does not accept the leading plus that streams did
+					if (input.front() == '+') {
+						input.remove_prefix(1);
+					}
 					value_t d;
-					is >> d;
+					const auto [ end, ec ] = std::from_chars(input.data(), input.data() + input.size(), d);
+					if (ec != std::errc{}) {
+						return std::nullopt;
+					}
+					input.remove_prefix(end - input.data());
 					return d;
 				}
 
@@ -412,12 +418,12 @@ namespace json::transcoding {
 				using base_t = json_token_base<Type, Name>;
 				using typename base_t::value_t;
 
-				inline static bool beginsWith(std::istream &is) {
-					return is.eof();
+				inline constexpr static bool beginsWith(int c) {
+					return c == -1;
 				}
 
-				value_t static read(std::istream &, std::vector<char> &) {
-					return {};
+				inline static std::optional<value_t> read(std::string_view &) {
+					return value_t{};
 				}
 
 				inline static void write(std::ostream &os, const value_t &) {
@@ -448,6 +454,16 @@ namespace json::transcoding {
 		inline friend std::ostream &operator<<(std::ostream &os, const source_location &location);
 	};
 
+	// the messages are built by hand, so the parser does not depend on <format>
+	inline std::runtime_error errorAt(std::string message, const source_location &location) {
+		message += " at position (";
+		message += std::to_string(location.row);
+		message += ", ";
+		message += std::to_string(location.column);
+		message += ')';
+		return std::runtime_error(message);
+	}
+
 	std::ostream &operator<<(std::ostream &os, const source_location &location) {
 		return os << '(' << location.row << ", " << location.column << ')';
 	}
@@ -521,17 +537,25 @@ namespace json::transcoding {
 	>;
 
 
+	/**
+	 * @brief Splits a json document held in memory into tokens.
+	 *
+	 * The first character of a token selects its reader from a table, so every token is read
+	 * without probing the other token types. String tokens are views into the source,
+	 * which has to outlive them.
+	 */
 	template<typename Enum, token <Enum>... Tokens>
+		requires (sizeof...(Tokens) < 255)
 	class tokenizer {
 	public:
 		using token_t = token_instance<Enum, Tokens...>;
 
 		inline tokenizer() = default;
 
-		inline tokenizer(std::istream &is) : m_is{&is} {}
+		inline tokenizer(std::string_view source) : m_input{source} {}
 
-		inline void setIs(std::istream &is) {
-			m_is = &is;
+		inline void setSource(std::string_view source) {
+			m_input = source;
 			m_location = {1, 1};
 		}
 
@@ -539,85 +563,105 @@ namespace json::transcoding {
 
 			auto &[token, location] = dst;
 
-			while (not m_is->eof() and std::isspace(m_is->peek())) {
+			while (not m_input.empty() and std::isspace(static_cast<unsigned char>(m_input.front()))) {
 				accept();
 			}
 
-			// The guaranteed lifetime of the previous string token ends here
-			m_buffer.clear();
-
 			location = m_location;
-			const auto beforePos = m_is->tellg();
 
-			const auto foundToken = constexpr_for::types<Tokens...>([&]<class Token>() {
-				if (Token::beginsWith(*m_is)) {
-					token.template set<Token::type()>(
-						Token::read(*m_is, m_buffer)
-					);
-					return true;
-				}
-				return false;
-			});
+			const auto c = m_input.empty() ? -1 : static_cast<int>(static_cast<unsigned char>(m_input.front()));
+			const auto index = dispatch[c + 1];
 
-			const auto afterPos = m_is->tellg();
-			if (afterPos == -1 && not m_is->eof()) {
-				throw std::runtime_error(
-					std::format(
-						"Error while parsing {} token starting at position ({}, {})",
-						token_t::nameOf(token.type()),
-						m_location.row,
-						m_location.column
-					)
-				);
+			if (index == noToken) {
+				throw errorAt(std::string("Unexpected character '") + static_cast<char>(c) + '\'', m_location);
 			}
 
-			// assuming there are no linebreaks within a token
-			m_location.column += afterPos - beforePos;
-
-			if (not foundToken) {
-				using namespace std::string_literals;
-				throw std::runtime_error(
-					std::format(
-						"Unexpected character '{}' at position ({}, {})",
-						static_cast<char>(m_is->peek()),
-						m_location.row,
-						m_location.column
-					)
+			const auto before = m_input.size();
+			if (not readers[index](m_input, token)) {
+				throw errorAt(
+					"Error while parsing " + std::string(token_t::nameOf(static_cast<Enum>(index))) + " token starting",
+					m_location
 				);
 			}
 
+			// assuming there are no linebreaks within a token
+			m_location.column += before - m_input.size();
+
 			return *this;
 		}
 
 		inline char ignore(std::span<const char> options) {
-			while (true) {
-				const auto c = m_is->peek();
-				if (not std::isspace(c)) {
-					for (const auto &option: options) {
-						if (c == option) {
-							accept();
-							return c;
-						}
-					}
-				}
+			while (not m_input.empty()) {
+				const auto c = m_input.front();
 				accept();
+				if (std::find(options.begin(), options.end(), c) != options.end()) {
+					return c;
+				}
 			}
+			throw errorAt("Unexpected end of input", m_location);
 		}
 
 		inline void accept() {
 			++m_location.column;
-			if (m_is->get() == '\n') {
+			if (m_input.front() == '\n') {
 				++m_location.row;
 				m_location.column = 1;
 			}
+			m_input.remove_prefix(1);
 		}
 
 	private:
+		using reader_t = bool (*)(std::string_view &, token_t &);
+
+		template<class Token>
+		inline static bool read(std::string_view &input, token_t &token) {
+			auto value = Token::read(input);
+			if (not value) {
+				return false;
+			}
+			token.template set<Token::type()>(std::move(*value));
+			return true;
+		}
+
+		inline constexpr static auto noToken = static_cast<uint8_t>(sizeof...(Tokens));
+
+		// indexed by the first character plus one, the end of the input is -1
+		inline constexpr static auto dispatch = []() {
+			std::array<uint8_t, 257> table{};
+			for (int c = -1; c != 256; ++c) {
+				uint8_t index = noToken;
+				constexpr_for::indexed_types<Tokens...>([&]<auto Index, class Token>() {
+					if (Token::beginsWith(c)) {
+						index = Index;
+						return true;
+					}
+					return false;
+				});
+				table[c + 1] = index;
+			}
+			return table;
+		}();
+
+		inline constexpr static std::array<reader_t, sizeof...(Tokens)> readers{ &read<Tokens>... };
+
 		source_location m_location{1, 1};
-		std::istream *m_is;
-		std::vector<char> m_buffer;
+		std::string_view m_input;
 	};
 
+	using json_tokenizer_t = tokenizer<tokens::type,
+		tokens::end,
+		tokens::left_brace,
+		tokens::right_brace,
+		tokens::comma,
+		tokens::colon,
+		tokens::string,
+		tokens::number,
+		tokens::boolean,
+		tokens::left_bracket,
+		tokens::right_bracket,
+		tokens::null
+	>;
+
 
 	enum class detokenizer_instructions {
 		space, tab, indent, outdent, clear_indent, newline
@@ -702,7 +746,7 @@ namespace json::transcoding {
 					break;
 				}
 				default: {
-					throw std::runtime_error(std::format("Unsupported tkn '{}'", int(instr)));
+					throw std::runtime_error("Unsupported tkn '" + std::to_string(int(instr)) + '\'');
 				}
 			}
 			return *this;
@@ -720,13 +764,7 @@ namespace json::transcoding {
 			});
 
 			if (not foundToken) {
-				using namespace std::string_literals;
-				throw std::runtime_error(
-					std::format(
-						"Unknown token '{}'",
-						token_t::nameOf(type)
-					)
-				);
+				throw std::runtime_error("Unknown token '" + std::string(token_t::nameOf(type)) + '\'');
 			}
 
 			return *this;
@@ -745,12 +783,12 @@ namespace json::transcoding {
 
 		inline parser() : tokens() {};
 
-		inline parser(std::istream &is) : tokens(is) {
+		inline parser(std::string_view source) : tokens(source) {
 			accept();
 		};
 
-		inline void setIs(std::istream &is) {
-			tokens.setIs(is);
+		inline void setSource(std::string_view source) {
+			tokens.setSource(source);
 			accept();
 		}
 
@@ -761,15 +799,10 @@ namespace json::transcoding {
 
 		inline token_t accept(Enum type) {
 			if (token.type() != type) {
-				using namespace std::string_literals;
-				throw std::runtime_error(
-					std::format(
-						"Expected token '{}' but got token '{}' at position ({}, {})",
-						token_t::nameOf(type),
-						token_t::nameOf(token.type()),
-						location.row,
-						location.column
-					)
+				throw errorAt(
+					"Expected token '" + std::string(token_t::nameOf(type)) +
+					"' but got token '" + std::string(token_t::nameOf(token.type())) + '\'',
+					location
 				);
 			}
 			auto oldToken = std::move(token);
@@ -837,28 +870,24 @@ namespace json {
 #ifndef STRING_INDEXER
 #define STRING_INDEXER
 
+/**
+ * Maps a fixed set of keys to their indices with a perfect hash built at compile time.
+ * Every key gets a slot of its own, so a lookup costs one hash and one comparison
+ * independent of the number of keys.
+ */
 template<size_t NumKeys>
 class string_indexer {
 private:
-	struct index_type {
-		unsigned int hash;
-		size_t index;
-
-		constexpr inline auto operator<=>(const index_type &other) const {
-			return hash <=> other.hash;
-		}
-
-		constexpr inline auto operator==(const index_type &other) const {
-			return hash == other.hash;
-		}
+	static_assert(NumKeys < 255, "slots store indices as bytes");
 
-		constexpr inline auto operator<=>(const unsigned otherHash) const {
-			return hash <=> otherHash;
-		}
-	};
+	// between two and four slots per key, which makes a collision free multiplier quick to find
+	static constexpr auto slotBits = std::bit_width(NumKeys) + 1;
+	static constexpr size_t numSlots = size_t{ 1 } << slotBits;
 
 	[[nodiscard]] inline constexpr static unsigned hash(std::span<const char> str);
 
+	[[nodiscard]] inline constexpr static size_t slotOf(unsigned hashed, unsigned multiplier);
+
 public:
 	template<typename... Ts>
 		requires (sizeof...(Ts) == NumKeys)
@@ -869,7 +898,9 @@ public:
 	[[nodiscard]] inline constexpr std::optional<std::string_view> nameOf(size_t index) const;
 
 private:
-	std::array<index_type, NumKeys> m_lookup{};
+	unsigned m_multiplier{};
+	std::array<std::uint8_t, numSlots> m_slots{};		// index of the key plus one, zero for empty slots
+	std::array<unsigned, NumKeys> m_hashes{};
 	std::array<std::string_view, NumKeys> m_keys{};
 };
 
@@ -887,6 +918,11 @@ template<size_t NumKeys>
 	return hashed;
 }
 
+template<size_t NumKeys>
+[[nodiscard]] inline constexpr size_t string_indexer<NumKeys>::slotOf(unsigned hashed, unsigned multiplier) {
+	return static_cast<size_t>(static_cast<std::uint32_t>(hashed * multiplier) >> (32 - slotBits));
+}
+
 template<size_t NumKeys>
 template<typename... Ts> requires (sizeof...(Ts) == NumKeys)
 consteval string_indexer<NumKeys>::string_indexer(const Ts&... keys) noexcept {
@@ -897,25 +933,36 @@ consteval string_indexer<NumKeys>::string_indexer(const Ts&... keys) noexcept {
 		// all strings need to be truncated before constructing the view.
 		const auto begin = std::begin(key), end = std::end(key);
 		m_keys[Index] = { begin, std::find(begin, end, '\0') };
-		m_lookup[Index] = { hash(m_keys[Index] ), Index };
+		m_hashes[Index] = hash(m_keys[Index]);
 		return false;
 	}, keys...);
 
-	std::sort(m_lookup.begin(), m_lookup.end());
-
-	auto it = m_lookup.begin();
-	while ((it = std::adjacent_find(it, m_lookup.end())) != m_lookup.end()) {
-		const auto match = it->hash;
-		for (auto itA = it + 1; itA != m_lookup.end() && itA->hash == match; itA++) {
-			const auto &keyA = m_keys[itA->index];
-			for (auto itB = it; itB != itA; itB++) {
-				const auto &keyB = m_keys[itB->index];
-				if (keyA == keyB) {
-					throw std::logic_error("Duplicate keys");
-				}
+	for (size_t a = 0; a != NumKeys; a++) {
+		for (size_t b = a + 1; b != NumKeys; b++) {
+			if (m_keys[a] == m_keys[b]) {
+				throw std::logic_error("Duplicate keys");
 			}
 		}
 	}
+
+	// odd multipliers along the golden ratio sequence, until one spreads all keys over distinct slots
+	for (unsigned attempt = 0; attempt != (1u << 16); attempt++) {
+		m_multiplier = (0x9e3779b9u * (attempt + 1)) | 1u;
+		m_slots.fill(0);
+
+		auto perfect = true;
+		for (size_t index = 0; index != NumKeys and perfect; index++) {
+			auto &slot = m_slots[slotOf(m_hashes[index], m_multiplier)];
+			perfect = slot == 0;
+			slot = static_cast<std::uint8_t>(index + 1);
+		}
+
+		if (perfect) {
+			return;
+		}
+	}
+
+	throw std::logic_error("No perfect hash for keys");
 }
 
 template<size_t NumKeys>
@@ -923,19 +970,16 @@ template<size_t NumKeys>
 	const auto sv = std::string_view(str.begin(), std::find(str.begin(), str.end(), '\0')); // TODO don't do this, just don't
 
 	const auto hashed = hash(sv);
-	const auto it = std::lower_bound(m_lookup.begin(), m_lookup.end(), hashed);
+	const auto slot = m_slots[slotOf(hashed, m_multiplier)];
 
-	if (it == m_lookup.end() or hashed != it->hash)
+	if (slot == 0)
 		return std::nullopt;
 
-	do [[unlikely]] {
-		const auto candidateIndex = it->index;
-		if (m_keys[candidateIndex] == sv) [[likely]] {
-			return candidateIndex;
-		}
-	} while (it < m_lookup.end() && it->hash == hashed);
+	const auto candidateIndex = size_t{ slot } - 1;
+	if (m_hashes[candidateIndex] != hashed or m_keys[candidateIndex] != sv)
+		return std::nullopt;
 
-	return std::nullopt;
+	return candidateIndex;
 }
 
 template<size_t NumKeys>
@@ -1714,9 +1758,12 @@ namespace json::safe {
 		tokens::null
 	>;
 
+	/**
+	 * @brief Parses a json document held in memory, the source has to outlive the parser.
+	 */
 	class parser : public base_json_parser_t {
 	public:
-		inline parser(std::istream &is);
+		inline parser(std::string_view source);
 
 		template<json_default_type auto DefaultType>
 		inline decltype(DefaultType)::type parse();
@@ -1749,8 +1796,8 @@ namespace json::safe {
 		inline void skipValue();
 	};
 
-	parser::parser(std::istream &is)
-		: base_json_parser_t(is) {}
+	parser::parser(std::string_view source)
+		: base_json_parser_t(source) {}
 
 
 	inline void parser::skipPrimitive() {
@@ -1852,7 +1899,6 @@ namespace json::safe {
 		using object_t = typename default_object_t::type;
 
 		const auto key = accept(STRING).get<STRING>();
-		// Lifetime of key ends with next accept so indexOf needs to be done here
 		const auto index_opt = object_t::indexOf(key);
 
 		accept(COLON);
@@ -2000,6 +2046,14 @@ namespace json::safe {
 
 		constexpr auto baseType = typeOfDefault(BaseDefaultType);
 
+		// Adapters can wrap other adapters, like an enumeration converted to a runtime type,
+		// the innermost one holds the json value.
+		if constexpr (baseType == ADAPTER) {
+			if constexpr (typeOfDefault(BaseDefaultType.defaultValue) == ADAPTER) {
+				return BaseDefaultType.convert(parse<BaseDefaultType.defaultValue>());
+			}
+		}
+
 		constexpr auto defaultType = []() {
 			if constexpr (baseType == ADAPTER) {
 				return BaseDefaultType.defaultValue;
@@ -17,6 +17,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
 #include <fstream>
+#include <algorithm>
 #include <obs-module.h>
 #include <obs-frontend-api.h>
 #include "platform/log.hpp"
@@ -30,6 +31,67 @@ OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
 
 app *app_instance;
 
+// Hotkeys that modulate the running animation of the sign, each press changes the parameters by one step.
+struct params_hotkey {
+	const char *name;
+	const char *description;
+	sign_animation_params (*adjust)(sign_animation_params);
+	obs_hotkey_id id{ OBS_INVALID_HOTKEY_ID };
+};
+
+static constexpr auto brightnessStep = 32;
+static constexpr auto hueStep = 16;
+static constexpr auto minSpeed = sign_animation_params::unitSpeed / 8;
+static constexpr auto maxSpeed = sign_animation_params::unitSpeed * 8;
+
+static params_hotkey paramsHotkeys[] = {
+	{ "sign_brightness_up", "SignBrightnessUp", [](sign_animation_params params) {
+		params.brightness = static_cast<u8>(std::min<int>(params.brightness + brightnessStep, U8_MAX));
+		return params;
+	} },
+	{ "sign_brightness_down", "SignBrightnessDown", [](sign_animation_params params) {
+		params.brightness = static_cast<u8>(std::max<int>(params.brightness - brightnessStep, 0));
+		return params;
+	} },
+	{ "sign_speed_up", "SignSpeedUp", [](sign_animation_params params) {
+		params.speed = static_cast<u16>(std::min<int>(params.speed * 2, maxSpeed));
+		return params;
+	} },
+	{ "sign_speed_down", "SignSpeedDown", [](sign_animation_params params) {
+		params.speed = static_cast<u16>(std::max<int>(params.speed / 2, minSpeed));
+		return params;
+	} },
+	{ "sign_hue_shift", "SignHueShift", [](sign_animation_params params) {
+		params.hueShift = static_cast<u8>(params.hueShift + hueStep);
+		return params;
+	} },
+	{ "sign_params_reset", "SignParamsReset", [](sign_animation_params) {
+		return sign_animation_params{};
+	} }
+};
+
+static void onParamsHotkey(void *data, obs_hotkey_id, obs_hotkey_t *, bool pressed) {
+	if (not pressed)
+		return;
+	const auto &hotkey = *static_cast<const params_hotkey*>(data);
+	app_instance->setParams(hotkey.adjust(app_instance->currentParams()));
+}
+
+// the key bindings are stored with the scene collection
+static void onSave(obs_data_t *saveData, bool saving, void *) {
+	for (const auto &hotkey : paramsHotkeys) {
+		if (saving) {
+			obs_data_array_t *keys = obs_hotkey_save(hotkey.id);
+			obs_data_set_array(saveData, hotkey.name, keys);
+			obs_data_array_release(keys);
+		} else {
+			obs_data_array_t *keys = obs_data_get_array(saveData, hotkey.name);
+			obs_hotkey_load(hotkey.id, keys);
+			obs_data_array_release(keys);
+		}
+	}
+}
+
 static void onEvent(enum obs_frontend_event event, void *){
 	switch (event) {
 	case OBS_FRONTEND_EVENT_RECORDING_STARTED:
@@ -66,12 +128,21 @@ bool obs_module_load() {
 
 	obs_frontend_add_event_callback(onEvent, nullptr);
 
+	for (auto &hotkey : paramsHotkeys) {
+		hotkey.id = obs_hotkey_register_frontend(hotkey.name, obs_module_text(hotkey.description), onParamsHotkey, &hotkey);
+	}
+	obs_frontend_add_save_callback(onSave, nullptr);
+
 	logger_info("done");
 	
 	return true;
 }
 
 void obs_module_unload() {
+	obs_frontend_remove_save_callback(onSave, nullptr);
+	for (const auto &hotkey : paramsHotkeys) {
+		obs_hotkey_unregister(hotkey.id);
+	}
 	delete app_instance;
 	logger_info("plugin unloaded");
 }
@@ -4,11 +4,14 @@
 #include <util/for_each.hpp>
 #include <platform/log.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
 
 
-#include <iostream>
 
 std::error_code app::start() {
 
@@ -19,6 +22,12 @@ std::error_code app::start() {
 
 	connectionThread = std::thread([this] { handleConnection(); } );
 
+	if (not configFilename.empty()) {
+		if (const auto error = configWatcher.watch(configFilename, [this] { reloadConfig(); }); error) {
+			logger_error_code("CONFIG_WATCH_ERROR", error);
+		}
+	}
+
 	return { 0, std::system_category() };
 }
 
@@ -31,7 +40,7 @@ void app::loadConfig(const std::string_view &configFileName) {
 
 	namespace fs = std::filesystem;
 
-	const auto configFilename = fs::path(path);
+	configFilename = fs::path(path);
 
 	auto configDir = configFilename;
 	configDir.remove_filename();
@@ -41,13 +50,11 @@ void app::loadConfig(const std::string_view &configFileName) {
 
 	auto configInitialized = false;
 	if (fs::exists(configFilename)) {
-		try {
-			auto is = std::ifstream(configFilename);
-			auto parser = json::safe::parser(is);
-			config = parser.parse<default_app_config>();
+		if (auto loaded = readConfig(configFilename); loaded) {
+			config = std::move(*loaded);
 			configInitialized = true;
-		} catch (const std::exception &e) {
-			logger_warn("Error while parsing '%s': %s.\n Proceeding with default config", configFilename.c_str(), e.what());
+		} else {
+			logger_warn("Proceeding with default config");
 			config = default_app_config();
 		}
 	}
@@ -70,6 +77,135 @@ void app::loadConfig(const std::string_view &configFileName) {
 	bfree(path);
 }
 
+std::optional<app_config_t> app::readConfig(const std::filesystem::path &filename) {
+	namespace fs = std::filesystem;
+
+	try {
+		// read at once, the parser keeps views into the text
+		auto is = std::ifstream(filename, std::ios::binary);
+		const auto text = std::string(std::istreambuf_iterator<char>(is), {});
+		const auto key = config_snapshot::key_of(text, fs::last_write_time(filename));
+
+		auto snapshotFilename = filename;
+		snapshotFilename.replace_extension(".snapshot");
+
+		if (auto snapshot = loadConfigSnapshot(snapshotFilename, key); snapshot)
+			return snapshot;
+
+		auto parser = json::safe::parser(text);
+		auto parsed = parser.parse<default_app_config>();
+		saveConfigSnapshot(snapshotFilename, key, parsed);
+
+		return parsed;
+	} catch (const std::exception &e) {
+		logger_warn("Error while parsing '%s': %s.", filename.c_str(), e.what());
+		return std::nullopt;
+	}
+}
+
+std::optional<app_config_t> app::loadConfigSnapshot(const std::filesystem::path &filename, const config_snapshot::source_key &key) {
+	auto is = std::ifstream(filename, std::ios::binary);
+	if (not is)
+		return std::nullopt;
+
+	const auto snapshot = std::vector<u8>(std::istreambuf_iterator<char>(is), {});
+	auto loaded = config_snapshot::load(snapshot, key);
+	if (not loaded)
+		logger_info("Config snapshot '%s' is outdated, parsing config", filename.c_str());
+
+	return loaded;
+}
+
+void app::saveConfigSnapshot(
+	const std::filesystem::path &filename, const config_snapshot::source_key &key, const app_config_t &snapshotConfig
+) {
+	const auto snapshot = config_snapshot::save(snapshotConfig, key);
+
+	// written next to it and renamed, so a crash never leaves a half written snapshot
+	auto tempFilename = filename;
+	tempFilename += ".tmp";
+
+	auto os = std::ofstream(tempFilename, std::ios::binary | std::ios::trunc);
+	os.write(reinterpret_cast<const char*>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+	os.close();
+
+	std::error_code error;
+	if (os)
+		std::filesystem::rename(tempFilename, filename, error);
+	if (not os or error) {
+		logger_warn("Could not write config snapshot '%s'", filename.c_str());
+		std::filesystem::remove(tempFilename, error);
+	}
+}
+
+template<typename F>
+void app::forEachStateAnimation(F &&f) {
+	using namespace string_literals;
+	using enum sign_state;
+
+	ztu::for_each::value<
+		std::pair{ CONNECTED, "CONNECTED"_sl },
+		std::pair{ RECORDING, "RECORDING"_sl },
+		std::pair{ RECORDING_PAUSED, "RECORDING_PAUSED"_sl },
+		std::pair{ STREAMING, "STREAMING"_sl },
+		std::pair{ STREAMING_PAUSED, "STREAMING_PAUSED"_sl },
+		std::pair{ IDLE, "IDLE"_sl },
+		std::pair{ PROCESSING, "PROCESSING"_sl },
+		std::pair{ SETUP, "SETUP"_sl }
+	>(std::forward<F>(f));
+}
+
+sign_animation app::seeded(const sign_basic_animation &animation) const {
+	sign_animation seededAnimation(animation);
+	seededAnimation.seed = static_cast<u32>(config.get<"animation_seed">());
+	return seededAnimation;
+}
+
+void app::reloadConfig() {
+	auto loaded = readConfig(configFilename);
+	if (not loaded) {
+		logger_warn("Keeping the current config");
+		return;
+	}
+
+	// Animations have no comparison, their encodings for the sign are compared instead.
+	const auto sameAnimation = [](const sign_basic_animation &a, const sign_basic_animation &b) {
+		std::array<u8, sign_animation_transcoding::max_encoded_size> bufferA, bufferB;
+		const auto sizeA = sign_animation_transcoding::serialize(a, bufferA);
+		const auto sizeB = sign_animation_transcoding::serialize(b, bufferB);
+		return sizeA and sizeB and std::equal(
+			bufferA.begin(), bufferA.begin() + *sizeA,
+			bufferB.begin(), bufferB.begin() + *sizeB
+		);
+	};
+
+	std::lock_guard<std::mutex> guard(animationMutex);
+
+	auto &animations = config.get<"animations">();
+	const auto &reloadedAnimations = loaded->get<"animations">();
+	const auto applyAt = referenceTime();
+	auto numChanged = 0;
+
+	// a new seed changes the random colors of every animation
+	auto &seed = config.get<"animation_seed">();
+	const auto seedChanged = seed != loaded->get<"animation_seed">();
+	seed = loaded->get<"animation_seed">();
+
+	forEachStateAnimation([&]<auto state_name>() {
+		auto &animation = animations.template get<state_name.second>();
+		const auto &reloadedAnimation = reloadedAnimations.template get<state_name.second>();
+		if (seedChanged or not sameAnimation(animation, reloadedAnimation)) {
+			animation = reloadedAnimation;
+			// does nothing while disconnected, the next connection sends all animations anyway
+			postMessage<sign_message_type::SET_ANIMATION>(state_name.first, seeded(animation), applyAt);
+			numChanged++;
+		}
+		return false;
+	});
+
+	logger_info("Reloaded '%s', %d animations changed", configFilename.c_str(), numChanged);
+}
+
 std::error_code app::initEncryptionEngines() {
 
 	const auto &connConfig = config.get<"connection">();
@@ -103,25 +239,6 @@ void app::handleConnection() {
 	using clock = chrono::high_resolution_clock;
 	using millis = chrono::milliseconds;
 
-	{
-		const auto &animations = config.get<"animations">();
-		const auto &connected = animations.get<"RECORDING">();
-
-		std::array<u8, sizeof(sign_animation)> buffer;
-
-		auto it = buffer.begin();
-		sign_animation_transcoding::serialize(connected, it);
-		const auto usedBytes = std::span{ buffer.begin(), it };
-
-		logger_info("used %ld bytes", usedBytes.size());
-
-		for (const auto byte : usedBytes) {
-			std::cout << int(byte) << " ";
-		}
-		std::cout << std::endl;
-	}
-
-
 	const auto &connConfig = config.get<"connection">();
 	const auto &sleepIntervals = connConfig.get<"timeout_interval_ms">();
 
@@ -184,6 +301,12 @@ void app::handleConnection() {
 
 		sendDecoyCommands();
 
+		{
+			// the next connection sends the current state anyway
+			std::lock_guard<std::mutex> guard(intervalMutex);
+			outbox.clear();
+		}
+
 		logger_info("connection lost");
 
 	} while (reconnect);
@@ -197,29 +320,50 @@ std::error_code app::validateConnection() {
 void app::onConnect() {
 	connected = true;
 
-	const auto &animations = config.get<"animations">();
+	// A few exchanges give the sign a usable offset before the first timestamped message.
+	constexpr auto initialClockSyncs = 4;
+	for (int i = 0; i != initialClockSyncs and connected; ++i) {
+		if (const auto error = synchronizeClock(); error) {
+			logger_error_code("CLOCK_SYNC_ERROR", error);
+		}
+	}
 
-	using namespace string_literals;
-	using enum sign_state;
+	// Sent before 'sendDecoyCommands' starts the heartbeats, so there is no interval to restart yet.
+	const auto applyAt = referenceTime();
 
-	ztu::for_each::value<
-		std::pair{ CONNECTED, "CONNECTED"_sl },
-		std::pair{ RECORDING, "RECORDING"_sl },
-		std::pair{ RECORDING_PAUSED, "RECORDING_PAUSED"_sl },
-		std::pair{ STREAMING, "STREAMING"_sl },
-		std::pair{ STREAMING_PAUSED, "STREAMING_PAUSED"_sl },
-		std::pair{ IDLE, "IDLE"_sl },
-		std::pair{ PROCESSING, "PROCESSING"_sl },
-		std::pair{ SETUP, "SETUP"_sl }
-	>([&]<auto state_name>() {
-		sendMessage<sign_message_type::SET_ANIMATION>(
-			state_name.first,
-			animations.template get<state_name.second>()
-		);
-		return false;
-	});
+	{
+		// a reload of the config must not interleave older animations with its own
+		std::lock_guard<std::mutex> guard(animationMutex);
+
+		const auto &animations = config.get<"animations">();
+
+		forEachStateAnimation([&]<auto state_name>() {
+			sendMessage<sign_message_type::SET_ANIMATION>(
+				state_name.first,
+				seeded(animations.template get<state_name.second>()),
+				applyAt
+			);
+			return false;
+		});
+	}
 
-	sendMessage<sign_message_type::CHANGE_STATE>(state);
+	if (const sign_animation_params currentParams = params; currentParams != sign_animation_params{}) {
+		sendMessage<sign_message_type::SET_PARAMS>(currentParams);
+	}
+
+	sendMessage<sign_message_type::CHANGE_STATE>(state, applyAt);
+
+	if (const auto error = uploadFrameLibrary(); error) {
+		logger_error_code("FRAME_LIBRARY_UPLOAD_ERROR", error);
+	}
+
+	if (const auto error = logStateStats(); error) {
+		logger_error_code("STATE_STATS_ERROR", error);
+	}
+
+	if (const auto error = logMetrics(); error) {
+		logger_error_code("METRICS_ERROR", error);
+	}
 }
 
 void app::sendDecoyCommands() {
@@ -229,6 +373,11 @@ void app::sendDecoyCommands() {
 
 	static long deviationMs = 0;
 
+	const auto clockSyncInterval = std::chrono::milliseconds(
+		config.get<"connection">().get<"clock_sync_interval">()
+	);
+	auto nextClockSync = std::chrono::steady_clock::now() + clockSyncInterval;
+
 	while (connected) {
 
 		static std::random_device rd;
@@ -258,12 +407,28 @@ void app::sendDecoyCommands() {
 
 		logger_info("waiting heartbeat for interval");
 		std::unique_lock<std::mutex> lock(intervalMutex);
-		const auto timeout = intervalDisruptor.wait_until(lock, target) == std::cv_status::timeout;
+		const auto timeout = not intervalDisruptor.wait_until(lock, target, [&]() {
+			return not outbox.empty() or not connected;
+		});
+		auto pending = std::move(outbox);
+		outbox.clear();
 		lock.unlock();
 		logger_info("done waiting for interval");
 
+		for (const auto &send : pending) {
+			send();
+		}
+
 		if (timeout) {
-			sendMessage<sign_message_type::HEARTBEAT>();
+			// Clock synchronization doubles as heartbeat.
+			if (std::chrono::steady_clock::now() >= nextClockSync) {
+				if (const auto error = synchronizeClock(); error) {
+					logger_error_code("CLOCK_SYNC_ERROR", error);
+				}
+				nextClockSync = std::chrono::steady_clock::now() + clockSyncInterval;
+			} else {
+				sendMessage<sign_message_type::HEARTBEAT>();
+			}
 		} else {
 			// A real command got sent which changes the uniform distribution of packages.
 			// Calculate deviation to converge against normal distribution with following packages.
@@ -275,9 +440,249 @@ void app::sendDecoyCommands() {
 	}
 }
 
+std::error_code app::synchronizeClock() {
+	using enum sign_message_type;
+
+	std::lock_guard<std::mutex> guard(connectionMutex);
+
+	if (not connected)
+		return {};
+
+	// The exchange shares the transceiver buffers and the socket with
+	// all other messages and would desynchronize the stream if interrupted.
+	const auto error = [&]() -> std::error_code {
+		std::error_code error;
+		std::span<u8> packet;
+
+		const auto t0 = referenceTime();
+		if ((error = transceiver.encrypt_message<TIME_PING>(packet, t0)))
+			return error;
+
+		if ((error = connection.send(packet)))
+			return error;
+
+		sign_message reply;
+		if ((error = receiveMessage(reply)))
+			return error;
+
+		const auto t3 = referenceTime();
+
+		if (reply.type() != TIME_PONG)
+			return aes_transceiver_error::make_error_code(aes_transceiver_error::codes::UNEXPECTED_MESSAGE);
+
+		const auto &[ referenceEcho, t1, t2 ] = reply.get<TIME_PONG>();
+		if (referenceEcho != t0)
+			return aes_transceiver_error::make_error_code(aes_transceiver_error::codes::UNEXPECTED_MESSAGE);
+
+		const auto sample = clock_sample::from_exchange(t0, t1, t2, t3);
+		if ((error = transceiver.encrypt_message<TIME_SYNC>(packet, sample)))
+			return error;
+
+		return connection.send(packet);
+	}();
+
+	if (error) {
+		connection.disconnect();
+		connected = false;
+	}
+
+	return error;
+}
+
+std::error_code app::receiveMessage(sign_message &message) {
+	std::error_code error;
+
+	if ((error = connection.receive(transceiver.header_packet_buffer())))
+		return error;
+
+	sign_header header;
+	std::span<u8> bodyPacket;
+	if ((error = transceiver.decrypt_header(header, bodyPacket)))
+		return error;
+
+	if ((error = connection.receive(bodyPacket)))
+		return error;
+
+	return transceiver.decrypt_body(header, message);
+}
+
+std::error_code app::uploadFrameLibrary() {
+	using enum frame_upload::status;
+	using enum frame_library_error::codes;
+	using frame_library_error::make_error_code;
+
+	const auto &path = config.get<"frame_library">();
+	if (path.empty())
+		return {};
+
+	auto file = std::ifstream(path, std::ios::binary);
+	const auto image = std::vector<u8>(std::istreambuf_iterator<char>(file), {});
+
+	const auto library = frame_library::open(image);
+	if (not library) {
+		logger_warn("'%s' does not contain a frame library", path.c_str());
+		return make_error_code(INVALID_LIBRARY);
+	}
+
+	if (library->size() > frame_upload::maxClips)
+		return make_error_code(LIBRARY_TOO_LARGE);
+
+	frame_upload::clip_list clips;
+	for (usize i = 0; i != library->size(); ++i) {
+		const auto clip = library->clip(i);
+		if (not clip)
+			return make_error_code(INVALID_CLIP);
+		clips.m_clips[i] = { clip->numFrames, clip->numPixels };
+	}
+	clips.numClips = static_cast<u16>(library->size());
+
+	// FNV-1a of the whole image, uploading the same file again resumes or skips the upload.
+	const auto uploadId = std::accumulate(image.begin(), image.end(), u32{ 2166136261 }, [](u32 hash, u8 byte) {
+		return (hash ^ byte) * u32{ 16777619 };
+	});
+
+	std::error_code error;
+	frame_upload::reply reply;
+
+	if ((error = request<sign_message_type::UPLOAD_BEGIN, sign_message_type::UPLOAD_STATUS>(reply, uploadId, clips)))
+		return error;
+
+	if (reply.state == COMPLETE) {
+		logger_info("Frame library '%s' is already installed", path.c_str());
+		return {};
+	}
+
+	const auto data = library->data();
+	logger_info("Uploading frame library '%s' starting at %u of %zu bytes", path.c_str(), reply.offset, data.size());
+
+	// The sign rejects chunks that fail verification, retrying a few times covers transmission errors.
+	constexpr auto maxRejections = 8;
+	auto rejections = 0;
+
+	std::array<u8, frame_upload::chunkHeaderSize + frame_upload::chunkSize> signedBuffer;
+
+	while (reply.offset < data.size()) {
+		if (reply.uploadId != uploadId or reply.state == FAILED)
+			return make_error_code(UPLOAD_REJECTED);
+
+		if (reply.state == REJECTED and ++rejections > maxRejections)
+			return make_error_code(UPLOAD_REJECTED);
+
+		frame_upload::chunk chunk{
+			.uploadId = uploadId,
+			.offset = reply.offset,
+			.data = data.subspan(reply.offset, std::min(frame_upload::chunkSize, data.size() - reply.offset))
+		};
+
+		const auto signedBytes = frame_upload::encodeChunk(chunk, signedBuffer);
+		if ((error = frame_upload::authenticate(sha_engine, signedBytes, chunk.mac)))
+			return error;
+
+		if ((error = request<sign_message_type::UPLOAD_CHUNK, sign_message_type::UPLOAD_STATUS>(reply, chunk)))
+			return error;
+	}
+
+	if ((error = request<sign_message_type::UPLOAD_COMMIT, sign_message_type::UPLOAD_STATUS>(reply, uploadId)))
+		return error;
+
+	if (reply.uploadId != uploadId or reply.state != COMPLETE)
+		return make_error_code(UPLOAD_REJECTED);
+
+	logger_info("Frame library '%s' installed", path.c_str());
+
+	return {};
+}
+
+std::error_code app::logStateStats() {
+	std::error_code error;
+
+	state_stats::summary summary;
+	u8 numStates = 1; // known after the first reply
+	for (u8 state = 0; state < numStates; state++) {
+		if ((error = request<sign_message_type::STATE_STATS_REQUEST, sign_message_type::STATE_STATS>(summary, state)))
+			return error;
+
+		numStates = summary.numStates;
+
+		if (summary.visits == 0)
+			continue;
+
+		const auto &name = summary.name;
+		const auto completed = summary.visits - summary.active;
+		logger_info(
+			"sign state %-24.*s visits %5u, %8u ms total, %7u ms max, %7u ms average%s",
+			static_cast<int>(std::find(name.begin(), name.end(), '\0') - name.begin()), name.data(),
+			summary.visits, summary.totalMillis, summary.maxMillis,
+			completed ? summary.totalMillis / completed : 0,
+			summary.active ? " (active)" : ""
+		);
+	}
+
+	return error;
+}
+
+std::error_code app::logMetrics() {
+	sign_metrics metrics;
+	if (const auto error = request<sign_message_type::GET_METRICS, sign_message_type::METRICS>(metrics); error)
+		return error;
+
+	for (const auto &field : sign_metrics_fields::fields) {
+		logger_info("sign metric %-28s %10u", field.name, metrics.*field.member);
+	}
+
+	return {};
+}
+
+template<sign_message_type Type, sign_message_type ReplyType, typename Reply, typename... Args>
+std::error_code app::request(Reply &reply, const Args&... args) {
+	std::lock_guard<std::mutex> guard(connectionMutex);
+
+	if (not connected)
+		return std::make_error_code(std::errc::not_connected);
+
+	// Same as the clock synchronization, request and reply must not be interleaved with other messages.
+	const auto error = [&]() -> std::error_code {
+		std::error_code error;
+		std::span<u8> packet;
+
+		if ((error = transceiver.encrypt_message<Type>(packet, args...)))
+			return error;
+
+		if ((error = connection.send(packet)))
+			return error;
+
+		sign_message message;
+		if ((error = receiveMessage(message)))
+			return error;
+
+		if (message.type() != ReplyType)
+			return aes_transceiver_error::make_error_code(aes_transceiver_error::codes::UNEXPECTED_MESSAGE);
+
+		std::tie(reply) = message.get<ReplyType>();
+
+		return {};
+	}();
+
+	if (error) {
+		connection.disconnect();
+		connected = false;
+	}
+
+	return error;
+}
+
+i64 app::referenceTime() {
+	// The system clock is usually NTP disciplined, so signs connected
+	// to plugins on different machines still share a time base.
+	const auto now = std::chrono::system_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
 void app::disconnect() {
 	logger_error("disconnecting");
 
+	configWatcher.stop();
+
 	// locking a mutex is not necessary
 	reconnect = false;
 	connected = false;
@@ -296,15 +701,28 @@ app::~app() {
 
 void app::changeState(const sign_state &newState) {
 	if (newState != state) {
-		sendMessage<sign_message_type::CHANGE_STATE>(newState);
+		postMessage<sign_message_type::CHANGE_STATE>(newState, referenceTime());
 	}
 	state = newState;
 }
 
+void app::setParams(const sign_animation_params &newParams) {
+	// Parameters only modulate the running animation, so they can
+	// be sent at a high rate without restarting it on the sign.
+	if (newParams != params) {
+		postMessage<sign_message_type::SET_PARAMS>(newParams);
+	}
+	params = newParams;
+}
+
+sign_animation_params app::currentParams() const {
+	return params;
+}
+
 
 template<sign_message_type Type, typename... Args>
 void app::sendMessage(Args&&... args) {
-	std::unique_lock<std::mutex> lock(connectionMutex);
+	std::lock_guard<std::mutex> guard(connectionMutex);
 	if (connected) {
 		std::error_code error;
 		std::span<u8> message_packet;
@@ -318,10 +736,23 @@ void app::sendMessage(Args&&... args) {
 				connection.disconnect();
 				connected = false;
 			}
-		} else {
+		} else if constexpr (Type != sign_message_type::SET_PARAMS) {
+			// parameters follow held hotkeys, a line per message would flood the log
 			logger_info("Successfully sent packet of type %d", static_cast<int>(Type));
 		}
 	}
-	lock.unlock();
-	intervalDisruptor.notify_one(); // reset heartbeat interval
+}
+
+template<sign_message_type Type, typename... Args>
+void app::postMessage(Args&&... args) {
+	if (not connected)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(intervalMutex);
+		outbox.emplace_back([this, ...args = std::forward<Args>(args)]() {
+			sendMessage<Type>(args...);
+		});
+	}
+	intervalDisruptor.notify_one();
 }
@@ -0,0 +1,283 @@
+#include <config/config_snapshot.hpp>
+
+#include <sign_animation_transcoding.hpp>
+#include <util/bit_stream.hpp>
+
+#include <typeinfo>
+
+// Layout, integers are little endian:
+//   u32     magic "OSSC"
+//   u16     format version
+//   u8      version of the animation transcoding
+//   u64     schema hash, see 'schema_hash'
+//   u64     json size
+//   i64     json modification time
+//   u64     json hash
+//   u32     payload size
+//   u64     payload hash
+//   ...     payload
+//
+// The payload holds the config in the order of its default description. Booleans are
+// a byte, numbers a f64, strings and arrays are prefixed by their length and variants by
+// their index as varints. Animations use the transcoding of the sign, which validates
+// them, other adapted values are stored as their json value or raw if they are arithmetic.
+
+namespace config_snapshot {
+
+	using namespace json::safe::default_values;
+	using namespace json::safe::default_values::concepts;
+
+	static constexpr u32 magic = 0x4353534f;
+	static constexpr u16 format_version = 1;
+	static constexpr usize header_size = 4 + 2 + 1 + 8 + 8 + 8 + 8 + 4 + 8;
+
+	static u64 fnv1a(std::span<const u8> bytes) {
+		u64 hash = 14695981039346656037ull;
+		for (const auto byte : bytes) {
+			hash = (hash ^ byte) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	static u64 fnv1a(std::string_view text) {
+		return fnv1a({ reinterpret_cast<const u8*>(text.data()), text.size() });
+	}
+
+	// The mangled type of the default config spells out every key, type and default value.
+	static u64 schema_hash() {
+		static const auto hash = fnv1a(std::string_view(typeid(default_app_config).name()));
+		return hash;
+	}
+
+	// Lengths are bounded by the payload, so a bad snapshot cannot request huge allocations.
+	struct payload_reader {
+		ztu::bit_reader reader;
+		usize size;
+
+		[[nodiscard]] std::optional<usize> length() {
+			const auto n = reader.read_varint();
+			if (not reader.ok() or n > size)
+				return std::nullopt;
+			return static_cast<usize>(n);
+		}
+	};
+
+
+	template<json_default_type auto Default>
+	static void write(ztu::bit_writer &dst, const typename decltype(Default)::type &value);
+
+	template<json_default_object auto DefaultObject>
+	static void writeEntries(ztu::bit_writer &dst, const typename decltype(DefaultObject)::type &object) {
+		object.apply([&](const auto &... entries) {
+			constexpr_for::indexed_arguments([&]<size_t Index, typename Entry>(const Entry &entry) {
+				constexpr auto defaultMember = DefaultObject.template get<Index>();
+				write<defaultMember>(dst, entry.value);
+				return false;
+			}, entries...);
+		});
+	}
+
+	template<json_default_type auto Default>
+	static void write(ztu::bit_writer &dst, const typename decltype(Default)::type &value) {
+		using default_t = decltype(Default);
+		using value_t = typename default_t::type;
+
+		constexpr auto type = typeOfDefault(Default);
+
+		if constexpr (type == BOOLEAN) {
+			dst.write_byte(value);
+		} else if constexpr (type == NUMBER) {
+			dst.write_le(value);
+		} else if constexpr (type == STRING) {
+			dst.write_varint(value.size());
+			dst.write_bytes({ reinterpret_cast<const u8*>(value.data()), value.size() });
+		} else if constexpr (type == ARRAY) {
+			dst.write_varint(value.size());
+			for (const auto &element : value) {
+				write<default_t::defaultElement>(dst, element);
+			}
+		} else if constexpr (type == OBJECT) {
+			writeEntries<Default>(dst, value);
+		} else if constexpr (type == VARIANT) {
+			dst.write_varint(value.index());
+			value.visit([&]<typename Entry>(const Entry &entry) {
+				constexpr auto defaultAlternative = default_t::template get<Entry::index>();
+				writeEntries<defaultAlternative>(dst, entry.value);
+			});
+		} else if constexpr (type == ADAPTER and std::same_as<value_t, sign_basic_animation>) {
+			std::array<u8, sign_animation_transcoding::max_encoded_size> buffer;
+			// an empty animation fails to load, which makes the plugin parse the json instead
+			const auto size = sign_animation_transcoding::serialize(value, buffer).value_or(0);
+			dst.write_varint(size);
+			dst.write_bytes({ buffer.data(), size });
+		} else if constexpr (type == ADAPTER and std::is_arithmetic_v<value_t>) {
+			dst.write_le(value);
+		} else if constexpr (type == ADAPTER) {
+			write<Default.defaultValue>(dst, Default.revert(value));
+		} else {
+			Default.__unknown_type;
+		}
+	}
+
+
+	template<json_default_type auto Default>
+	static bool read(payload_reader &src, typename decltype(Default)::type &value);
+
+	template<json_default_object auto DefaultObject>
+	static bool readEntries(payload_reader &src, typename decltype(DefaultObject)::type &object) {
+		bool ok = true;
+		object.apply([&](auto &... entries) {
+			constexpr_for::indexed_arguments([&]<size_t Index, typename Entry>(Entry &entry) {
+				constexpr auto defaultMember = DefaultObject.template get<Index>();
+				ok = read<defaultMember>(src, entry.value);
+				return not ok;
+			}, entries...);
+		});
+		return ok;
+	}
+
+	template<json_default_type auto Default>
+	static bool read(payload_reader &src, typename decltype(Default)::type &value) {
+		using default_t = decltype(Default);
+		using value_t = typename default_t::type;
+
+		constexpr auto type = typeOfDefault(Default);
+
+		auto &reader = src.reader;
+
+		if constexpr (type == BOOLEAN) {
+			const auto byte = reader.read_byte();
+			if (byte > 1)
+				return false;
+			value = byte;
+		} else if constexpr (type == NUMBER) {
+			value = reader.read_le<double>();
+		} else if constexpr (type == STRING) {
+			const auto size = src.length();
+			if (not size)
+				return false;
+			value.resize(*size);
+			reader.read_bytes({ reinterpret_cast<u8*>(value.data()), value.size() });
+		} else if constexpr (type == ARRAY) {
+			const auto size = src.length();
+			if (not size)
+				return false;
+			value.clear();
+			value.reserve(*size);
+			for (usize i = 0; i != *size; ++i) {
+				if (not read<default_t::defaultElement>(src, value.emplace_back()))
+					return false;
+			}
+		} else if constexpr (type == OBJECT) {
+			if (not readEntries<Default>(src, value))
+				return false;
+		} else if constexpr (type == VARIANT) {
+			const auto index = reader.read_varint();
+			if (index >= value_t::size())
+				return false;
+			value = value_t(in_place_dynamic_index{ static_cast<size_t>(index) });
+			bool ok = false;
+			value.visit([&]<typename Entry>(Entry &entry) {
+				constexpr auto defaultAlternative = default_t::template get<Entry::index>();
+				ok = readEntries<defaultAlternative>(src, entry.value);
+			});
+			if (not ok)
+				return false;
+		} else if constexpr (type == ADAPTER and std::same_as<value_t, sign_basic_animation>) {
+			const auto size = src.length();
+			if (not size or *size > sign_animation_transcoding::max_encoded_size)
+				return false;
+			std::array<u8, sign_animation_transcoding::max_encoded_size> buffer;
+			const auto encoded = std::span(buffer).first(*size);
+			reader.read_bytes(encoded);
+			sign_animation animation;
+			if (not sign_animation_transcoding::deserialize(animation, encoded))
+				return false;
+			value = animation.animator;
+		} else if constexpr (type == ADAPTER and std::is_arithmetic_v<value_t>) {
+			value = reader.read_le<value_t>();
+		} else if constexpr (type == ADAPTER) {
+			typename default_t::json_t jsonValue;
+			if (not read<Default.defaultValue>(src, jsonValue))
+				return false;
+			value = Default.convert(jsonValue);
+		} else {
+			Default.__unknown_type;
+		}
+
+		return reader.ok();
+	}
+
+
+	source_key key_of(std::string_view json, std::filesystem::file_time_type modified) {
+		return {
+			.size = json.size(),
+			.modified = static_cast<i64>(modified.time_since_epoch().count()),
+			.hash = fnv1a(json)
+		};
+	}
+
+	std::vector<u8> save(const app_config_t &config, const source_key &key) {
+		// grows until the config fits, large color arrays need more than the first guess
+		std::vector<u8> snapshot(header_size + 4096);
+		usize payloadSize;
+		while (true) {
+			auto writer = ztu::bit_writer(std::span(snapshot).subspan(header_size));
+			write<default_app_config>(writer, config);
+			if (writer.ok()) {
+				payloadSize = writer.size();
+				break;
+			}
+			snapshot.resize(header_size + 2 * (snapshot.size() - header_size));
+		}
+		snapshot.resize(header_size + payloadSize);
+
+		auto header = ztu::bit_writer(std::span(snapshot).first(header_size));
+		header.write_le(magic);
+		header.write_le(format_version);
+		header.write_byte(sign_animation_transcoding::version);
+		header.write_le(schema_hash());
+		header.write_le(key.size);
+		header.write_le(key.modified);
+		header.write_le(key.hash);
+		header.write_le(static_cast<u32>(payloadSize));
+		header.write_le(fnv1a(std::span(snapshot).subspan(header_size)));
+
+		return snapshot;
+	}
+
+	std::optional<app_config_t> load(std::span<const u8> snapshot, const source_key &key) {
+		if (snapshot.size() < header_size)
+			return std::nullopt;
+
+		auto header = ztu::bit_reader(snapshot.first(header_size));
+		if (
+			header.read_le<u32>() != magic or
+			header.read_le<u16>() != format_version or
+			header.read_byte() != sign_animation_transcoding::version or
+			header.read_le<u64>() != schema_hash()
+		) {
+			return std::nullopt;
+		}
+
+		source_key snapshotKey;
+		snapshotKey.size = header.read_le<u64>();
+		snapshotKey.modified = header.read_le<i64>();
+		snapshotKey.hash = header.read_le<u64>();
+		if (snapshotKey != key)
+			return std::nullopt;
+
+		const auto payload = snapshot.subspan(header_size);
+		const auto payloadSize = header.read_le<u32>();
+		const auto payloadHash = header.read_le<u64>();
+		if (payload.size() != payloadSize or fnv1a(payload) != payloadHash)
+			return std::nullopt;
+
+		auto src = payload_reader{ ztu::bit_reader(payload), payload.size() };
+		app_config_t config;
+		if (not read<default_app_config>(src, config) or not src.reader.exhausted())
+			return std::nullopt;
+
+		return config;
+	}
+}
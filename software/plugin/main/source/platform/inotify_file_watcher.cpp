@@ -0,0 +1,107 @@
+#include <platform/inotify_file_watcher.hpp>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+std::error_code inotify_file_watcher::watch(const std::filesystem::path &filename, callback_t onChange) {
+	stop();
+
+	const auto lastError = []() {
+		return std::error_code(errno, std::system_category());
+	};
+
+	if ((notifyFd = inotify_init1(IN_CLOEXEC)) < 0)
+		return lastError();
+
+	if ((stopFd = eventfd(0, EFD_CLOEXEC)) < 0) {
+		const auto error = lastError();
+		stop();
+		return error;
+	}
+
+	auto directory = filename.parent_path();
+	if (directory.empty())
+		directory = ".";
+
+	if (inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		const auto error = lastError();
+		stop();
+		return error;
+	}
+
+	thread = std::thread([this, name = filename.filename().string(), onChange = std::move(onChange)]() mutable {
+		run(std::move(name), std::move(onChange));
+	});
+
+	return {};
+}
+
+void inotify_file_watcher::run(std::string name, callback_t onChange) {
+	// editors save in several steps, the file is only reported once it stayed untouched this long
+	constexpr auto settleMillis = 100;
+
+	alignas(inotify_event) std::array<char, 4096> buffer;
+	auto pending = false;
+
+	while (true) {
+		std::array<pollfd, 2> fds{{
+			{ .fd = notifyFd, .events = POLLIN, .revents = 0 },
+			{ .fd = stopFd, .events = POLLIN, .revents = 0 }
+		}};
+
+		const auto ready = poll(fds.data(), fds.size(), pending ? settleMillis : -1);
+		if (ready < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		if (fds[1].revents)
+			return;
+
+		if (ready == 0) {
+			pending = false;
+			onChange();
+			continue;
+		}
+
+		const auto length = read(notifyFd, buffer.data(), buffer.size());
+		if (length < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+
+		for (ssize_t offset = 0; offset < length;) {
+			const auto event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+			if (event->len and name == event->name)
+				pending = true;
+			offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+		}
+	}
+}
+
+void inotify_file_watcher::stop() {
+	if (thread.joinable()) {
+		const std::uint64_t wake = 1;
+		(void)write(stopFd, &wake, sizeof(wake));
+		thread.join();
+	}
+
+	for (auto fd : { &notifyFd, &stopFd }) {
+		if (*fd >= 0) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+}
+
+inotify_file_watcher::~inotify_file_watcher() {
+	stop();
+}
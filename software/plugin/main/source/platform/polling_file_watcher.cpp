@@ -0,0 +1,54 @@
+#include <platform/polling_file_watcher.hpp>
+
+#include <chrono>
+#include <utility>
+
+std::error_code polling_file_watcher::watch(const std::filesystem::path &filename, callback_t onChange) {
+	stop();
+
+	stopping = false;
+	thread = std::thread([this, filename, onChange = std::move(onChange)]() mutable {
+		run(std::move(filename), std::move(onChange));
+	});
+
+	return {};
+}
+
+void polling_file_watcher::run(std::filesystem::path filename, callback_t onChange) {
+	namespace fs = std::filesystem;
+
+	constexpr auto interval = std::chrono::milliseconds(500);
+
+	const auto stamp = [&]() {
+		// a missing file compares as a change once it is back
+		std::error_code error;
+		return std::pair{ fs::last_write_time(filename, error), fs::file_size(filename, error) };
+	};
+
+	auto last = stamp();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (not stopSignal.wait_for(lock, interval, [this] { return stopping; })) {
+		if (const auto current = stamp(); current != last) {
+			last = current;
+			lock.unlock();
+			onChange();
+			lock.lock();
+		}
+	}
+}
+
+void polling_file_watcher::stop() {
+	if (thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> guard(mutex);
+			stopping = true;
+		}
+		stopSignal.notify_one();
+		thread.join();
+	}
+}
+
+polling_file_watcher::~polling_file_watcher() {
+	stop();
+}
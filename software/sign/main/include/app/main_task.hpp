@@ -7,6 +7,8 @@
 
 #include <hmac_sha_512_handshake.hpp>
 #include <domain_logic/sign_transceiver.hpp>
+#include <util/state_machine_stats.hpp>
+#include <esp_timer.h>
 
 
 void main_task(void *);
@@ -51,6 +53,13 @@ constexpr const char* main_task_state_name(main_task_states state) {
 	}
 }
 
+inline constexpr std::size_t num_main_task_states = static_cast<std::size_t>(main_task_states::SETUP_ERROR) + 1;
+
+using main_task_stats_t = state_machine_stats<main_task_states, num_main_task_states, esp_timer_get_time>;
+
+
+// The transitions of a state list every value its 'run' may return. All of them contain
+// CHOOSE_TASK, as pressing the setup button redirects there from any state.
 
 struct choose_task {
 	static constexpr auto states = std::array{
@@ -58,6 +67,12 @@ struct choose_task {
 		main_task_states::SETUP_ERROR,
 		main_task_states::CONFIG_ERROR
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONFIG_ERROR,
+		main_task_states::CONNECT_TO_WIFI,
+		main_task_states::START_SETUP_SERVER,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states state,
 		std::error_code &error
@@ -71,6 +86,12 @@ struct start_setup_server {
 	static constexpr auto states = std::array{
 		main_task_states::START_SETUP_SERVER
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONFIG_ERROR,
+		main_task_states::START_SETUP_SERVER,
+		main_task_states::WAIT_FOR_SETUP_COMPLETE,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code &error,
@@ -83,6 +104,11 @@ struct wait_for_setup_complete {
 	static constexpr auto states = std::array{
 		main_task_states::WAIT_FOR_SETUP_COMPLETE
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::WAIT_FOR_SETUP_COMPLETE,
+		main_task_states::STOP_SETUP_SERVER,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code &error,
@@ -94,6 +120,9 @@ struct stop_setup_server {
 	static constexpr auto states = std::array{
 		main_task_states::STOP_SETUP_SERVER
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code &error,
@@ -108,6 +137,12 @@ struct connect_to_wifi {
 	static constexpr auto states = std::array{
 		main_task_states::CONNECT_TO_WIFI
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONNECT_TO_WIFI,
+		main_task_states::PREPARE_CONNECTION,
+		main_task_states::SETUP_ERROR,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code &error,
@@ -120,6 +155,12 @@ struct prepare_connection {
 	static constexpr auto states = std::array{
 		main_task_states::PREPARE_CONNECTION
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONNECT_TO_WIFI,
+		main_task_states::CONNECT_TO_PLUGIN,
+		main_task_states::SETUP_ERROR,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code& error,
@@ -134,6 +175,12 @@ struct connect_to_plugin {
 	static constexpr auto states = std::array{
 		main_task_states::CONNECT_TO_PLUGIN
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONNECT_TO_PLUGIN,
+		main_task_states::VALIDATE_CONNECTION,
+		main_task_states::SETUP_ERROR,
+		main_task_states::CHOOSE_TASK
+	};
 	static main_task_states run(
 		main_task_states,
 		std::error_code& error,
@@ -149,6 +196,13 @@ struct validate_connection {
 	static constexpr auto states = std::array{
 		main_task_states::VALIDATE_CONNECTION
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONNECT_TO_PLUGIN,
+		main_task_states::VALIDATE_CONNECTION,
+		main_task_states::RECEIVE_MESSAGE,
+		main_task_states::SETUP_ERROR,
+		main_task_states::CHOOSE_TASK
+	};
 	enum class internal_state {
 		CREATE_CHALLENGE,
 		SEND_CHALLENGE,
@@ -177,11 +231,18 @@ struct reveive_message {
 	static constexpr auto states = std::array{
 		main_task_states::RECEIVE_MESSAGE
 	};
+	static constexpr auto transitions = std::array{
+		main_task_states::CONNECT_TO_PLUGIN,
+		main_task_states::RECEIVE_MESSAGE,
+		main_task_states::SETUP_ERROR,
+		main_task_states::CHOOSE_TASK
+	};
 	enum class internal_state {
 		INIT_RECEIVE,
 		RECEIVE_HEADER,
 		RECEIVE_BODY,
-		HANDLE_MESSAGE
+		HANDLE_MESSAGE,
+		SEND_REPLY
 	};
 	static main_task_states run(
 		main_task_states,
@@ -195,6 +256,7 @@ struct reveive_message {
 		sign_transceiver& transceiver,
 		sign_header& header,
 		sign_message& message,
-		std::span<u8>& io_bytes
+		std::span<u8>& io_bytes,
+		i64& receive_time
 	);
 };
@@ -2,18 +2,43 @@
 
 #include "sign_animation_controller.hpp"
 #include "sign_storage.hpp"
+#include <platform/esp_nvs_backend.hpp>
+#include <platform/synchronized_clock.hpp>
+#include <platform/esp_partition_frame_storage.hpp>
+#include <lighting/frame_library.hpp>
+#include <domain_logic/frame_upload.hpp>
+#include <domain_logic/sign_metrics.hpp>
 #include <atomic>
 #include <system_error>
 
+using sign_storage_t = basic_sign_storage_t<esp_nvs_backend>;
+
 struct sign_t {
 	// handle for accessing flash memory
 	sign_storage_t storage;
+	// flash partition holding the frame library
+	esp_partition_frame_storage frame_storage;
+	// clips of the frame library, points into the mapped partition
+	frame_library frames;
+	// progress of the frame library upload, survives reconnects
+	frame_upload_receiver<esp_partition_frame_storage> frame_upload;
+	// clock shared with the plugin
+	synchronized_clock clock;
 	// animation controller for LED strip
 	sign_animation_controller_t animation_controller;
 	// flag to change between setup and sign mode
 	std::atomic_flag switch_task;
 	// last major error
 	std::error_code error;
+	// counted by the main task while connecting to the plugin
+	sign_connection_metrics connection_metrics;
+	// set once the main task runs, for its stack high water mark
+	TaskHandle_t main_task_handle;
 };
 
 extern sign_t sign;
+
+/**
+ * @brief Collects the current metrics of the sign, may be called from any task.
+ */
+[[nodiscard]] sign_metrics collect_metrics();
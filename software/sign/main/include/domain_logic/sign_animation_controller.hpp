@@ -10,14 +10,29 @@ class sign_animation_controller_t {
 public:
 	void init(sign_state initialState);
 
-	void setState(sign_state newState);
+	// An applyAt of zero applies the change immediately, otherwise it is the
+	// reference time in microseconds at which the new animation starts.
+	void setState(sign_state newState, i64 applyAt = 0);
 
-	void setAnimation(sign_state state, const sign_animation& newAnimation);
+	void setAnimation(sign_state state, const sign_animation& newAnimation, i64 applyAt = 0);
+
+	void setParams(const sign_animation_params& newParams);
+
+	// Frames for the live preview of the config website, only rendered into while enabled.
+	void setPreviewEnabled(bool enabled);
+
+	[[nodiscard]] sign_animation_handler_t::preview_frame previewFrame(u32 &version) const;
+
+	[[nodiscard]] sign_animation_handler_t::render_stats renderStats() const;
 
 private:
-	void updateAnimation();
+	void updateAnimation(i64 applyAt);
+
+	// The animations live in the storage cache, which only reads a slot from flash once it is needed.
+	static sign_animation loadAnimation(sign_state state);
+
+	static void storeAnimation(sign_state state, const sign_animation& animation);
 
 	sign_animation_handler_t animationHandler;
-	std::array<sign_animation, static_cast<size_t>(sign_state::LAST)> animations;
 	sign_state currentState;
 };
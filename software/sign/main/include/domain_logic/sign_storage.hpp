@@ -1,7 +1,9 @@
 #pragma once
 
-#include <platform/nvs_handler.hpp>
+#include <nvs_handler.hpp>
 #include <domain_logic/sign_animation.hpp>
+#include <domain_logic/sign_state.hpp>
+#include <sign_animation_transcoding.hpp>
 
 enum class storage_keys : u8 {
 	SSID, PASSWORD,
@@ -14,10 +16,60 @@ enum class storage_keys : u8 {
 
 	SECRET,
 
-	IDLE_ANIMATION, SETUP_ANIMATION
+	IDLE_ANIMATION, SETUP_ANIMATION,
+
+	CONNECTED_ANIMATION,
+	RECORDING_ANIMATION, RECORDING_PAUSED_ANIMATION,
+	STREAMING_ANIMATION, STREAMING_PAUSED_ANIMATION,
+	PROCESSING_ANIMATION,
+
+	FRAME_LIBRARY_ID,
+
+	NUM_PIXELS
+};
+
+/**
+ * @brief Storage key of the animation of every sign_state.
+ */
+inline constexpr auto animation_storage_keys = std::array{
+	storage_keys::CONNECTED_ANIMATION,
+	storage_keys::RECORDING_ANIMATION,
+	storage_keys::RECORDING_PAUSED_ANIMATION,
+	storage_keys::STREAMING_ANIMATION,
+	storage_keys::STREAMING_PAUSED_ANIMATION,
+	storage_keys::IDLE_ANIMATION,
+	storage_keys::PROCESSING_ANIMATION,
+	storage_keys::SETUP_ANIMATION
 };
+static_assert(animation_storage_keys.size() == static_cast<size_t>(sign_state::LAST));
+
+// Same defaults as the plugin uses, so a fresh sign already shows the right colors.
+template<color... Colors>
+inline sign_animation default_uniform_color_animation() {
+	return sign_animation{
+		sign_animations::uniform_color{
+			{
+				sign_suppliers::sequence{ Colors... },
+				color_mixing::type::LINEAR_INTERPOLATION
+			}
+		},
+		1.0f
+	};
+}
+
+template<auto GetValue>
+using sign_animation_storage_t = default_types::transcoded_t<
+	sign_animation,
+	sign_animation_transcoding::max_encoded_size,
+	sign_animation_transcoding::serialize,
+	sign_animation_transcoding::deserialize,
+	GetValue
+>;
+
+template<nvs_backend_concept backend_t>
+using basic_sign_storage_t = nvs_handler<
+	backend_t,
 
-using sign_storage_t = nvs_handler<
 	nvs_entry<storage_keys::SSID			, default_types::string_t<CONFIG_SSID_MAX_LEN, [](){
 		return ztu::string_literal<CONFIG_SSID_MAX_LEN + 1>{ "test_ssid" };
 	}>>{},
@@ -36,7 +88,7 @@ using sign_storage_t = nvs_handler<
 
 	nvs_entry<storage_keys::SECRET			, default_types::array_t<uint8_t, 64 + 32, []() -> std::array<u8, 64 + 32> { return {}; }>>{},
 
-	nvs_entry<storage_keys::IDLE_ANIMATION	, default_types::object_t<sign_animation,
+	nvs_entry<storage_keys::IDLE_ANIMATION	, sign_animation_storage_t<
 		[]() -> sign_animation{
 			return sign_animation{
 				sign_animations::moving_colors{
@@ -55,8 +107,7 @@ using sign_storage_t = nvs_handler<
 			};
 		}
 	>>{},
-	nvs_entry<storage_keys::SETUP_ANIMATION, default_types::object_t<
-		sign_animation,
+	nvs_entry<storage_keys::SETUP_ANIMATION, sign_animation_storage_t<
 		[]() -> sign_animation {
 			return sign_animation{
 				sign_animations::moving_colors{
@@ -74,5 +125,31 @@ using sign_storage_t = nvs_handler<
 				2.0f
 			};
 		}
-	>>{}
+	>>{},
+
+	// New entries have to be appended, the nvs keys are derived from the position.
+	nvs_entry<storage_keys::CONNECTED_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::white>(); }
+	>>{},
+	nvs_entry<storage_keys::RECORDING_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::red>(); }
+	>>{},
+	nvs_entry<storage_keys::RECORDING_PAUSED_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::red, colors::yellow>(); }
+	>>{},
+	nvs_entry<storage_keys::STREAMING_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::pink>(); }
+	>>{},
+	nvs_entry<storage_keys::STREAMING_PAUSED_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::pink, colors::blue>(); }
+	>>{},
+	nvs_entry<storage_keys::PROCESSING_ANIMATION, sign_animation_storage_t<
+		[]() { return default_uniform_color_animation<colors::pink, colors::green>(); }
+	>>{},
+
+	// upload id of the installed frame library, lets the plugin skip uploading it again
+	nvs_entry<storage_keys::FRAME_LIBRARY_ID, default_types::u32_t<[]() -> u32 { return 0; }>>{},
+
+	// number of LEDs on the strip
+	nvs_entry<storage_keys::NUM_PIXELS, default_types::u16_t<[]() -> u16 { return CONFIG_DEFAULT_NUM_PIXELS; }>>{}
 >;
@@ -3,7 +3,7 @@
 #include <util/uix.hpp>
 #include <lighting/color.hpp>
 
-#include <array>
+#include <span>
 #include <vector>
 
 #include <driver/rmt.h>
@@ -11,28 +11,42 @@
 #include <driver/gpio.h>
 
 
-class rmt_color_converter {
-public:
-	inline rmt_color_converter &operator=(const color& c);
-private:
-	std::array<rmt_item32_t, 3 * 8> rmtPattern;
-};
-
+/**
+ * @brief Drives a strip of WS2815 LEDs through the RMT peripheral.
+ *
+ * The colors are kept as the GRB bytes the LEDs expect, the driver translates them into
+ * RMT items while sending, so a strip needs 6 bytes per LED for its two frames
+ * instead of an item per bit.
+ */
 class WS2815_handler {
 public:
 	inline WS2815_handler(gpio_num_t dataPin, usize numPixels, rmt_channel_t rmtChannel = RMT_CHANNEL_0);
 
-	// array interface
-	inline rmt_color_converter* begin();
-	inline rmt_color_converter* end();
-	inline usize size();
-	inline rmt_color_converter &operator[](usize index);
+	[[nodiscard]] inline usize size() const;
+
+	/**
+	 * @brief Sets the colors of the pixels from 'firstPixel' on for the next update.
+	 * The two frames take turns, so every pixel has to be written again before each update.
+	 */
+	inline void write(usize firstPixel, std::span<const color> colors);
 
-	// update colors
+	/**
+	 * @brief Starts sending the colors written since the last update, returns without waiting for the strip.
+	 * The next update waits until this one is sent.
+	 */
 	inline bool operator()();
 
+	inline ~WS2815_handler();
+
 private:
-	std::vector<rmt_item32_t> rmtPattern;
+	static inline void translate(
+		const void *src, rmt_item32_t *dst, size_t srcSize, size_t wantedItems,
+		size_t *translatedSize, size_t *itemCount
+	);
+
+	// one frame is written while the other one is sent
+	std::vector<u8> grbFrames;
+	u8 *writeFrame, *sendFrame;
 	rmt_channel_t rmtChannel;
 	usize numPixels;
 };
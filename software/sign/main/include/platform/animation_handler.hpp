@@ -1,7 +1,13 @@
 #pragma once
 
 #include <lighting/animation.hpp>
+#include <lighting/animation_params.hpp>
+#include <platform/synchronized_clock.hpp>
+#include <util/seqlock.hpp>
+#include <util/metrics.hpp>
+#include <array>
 #include <atomic>
+#include <span>
 #include <variant>
 
 #include <freertos/FreeRTOS.h>
@@ -12,9 +18,61 @@ class animation_handler {
 public:
 	using animation_t = variable_speed_animation<animations_t>;
 
-	void init(const animation_t& newAnimation);
+	// Pixels rendered at once, the strip is rendered, modulated and sent in parts of this size,
+	// so the work per pixel does not depend on the length of the strip.
+	static constexpr usize chunkPixels = 64;
 
-	void setAnimation(const animation_t& newAnimation);
+	static constexpr usize maxPreviewPixels = 256;
+
+	/**
+	 * @brief Every n-th pixel of the strip, as many as fit into 'maxPreviewPixels'.
+	 */
+	struct preview_frame {
+		u16 numPixels{ 0 };
+		std::array<color, maxPreviewPixels> pixels{};
+
+		[[nodiscard]] std::span<const color> colors() const {
+			return { pixels.data(), numPixels };
+		}
+	};
+
+	/**
+	 * @param numPixels Length of the strip, its buffers are allocated once here.
+	 */
+	void init(const animation_t& newAnimation, const synchronized_clock& clock, usize numPixels);
+
+	/**
+	 * @brief Replaces the running animation once the clock reaches the given epoch.
+	 *
+	 * @param epoch Reference time in microseconds at which the animation starts at t = 0.
+	 * Epochs in the past start the animation right away, but with the phase it would have by now.
+	 */
+	void setAnimation(const animation_t& newAnimation, i64 epoch);
+
+	void setParams(const animation_params& newParams);
+
+	/**
+	 * @brief Makes the animation task publish every frame it renders, until disabled again.
+	 */
+	void setPreviewEnabled(bool enabled);
+
+	/**
+	 * @brief Copies the last published frame without blocking the animation task.
+	 *
+	 * @param version Changes whenever a new frame is published.
+	 */
+	[[nodiscard]] preview_frame previewFrame(u32 &version) const;
+
+	struct render_stats {
+		ztu::timing_summary renderMicros;
+		u32 missedTicks;
+		u32 stackHighWater;		// bytes of the task stack never used
+	};
+
+	/**
+	 * @brief Timing of the animation task, zero until 'init' is called.
+	 */
+	[[nodiscard]] render_stats renderStats() const;
 
 	~animation_handler();
 
@@ -24,6 +82,15 @@ private:
 	struct shared_animation_state {
 		std::atomic_flag hasNewAnimation{ ATOMIC_FLAG_INIT };
 		animation_t animation;
+		i64 epoch;
+		const synchronized_clock *clock;
+		std::atomic<animation_params> params{};
+		usize numPixels;
+		std::atomic<bool> previewEnabled{ false };
+		ztu::seqlock<preview_frame> preview{};
+		preview_frame nextPreview{};		// only touched by the animation task
+		ztu::metric_timing renderMicros{};
+		ztu::metric_counter missedTicks{};
 	};
 
 	shared_animation_state *shared_state{ nullptr };
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <concepts/nvs_backend_concept.hpp>
+#include <util/uix.hpp>
+#include <nvs_flash.h>
+#include <esp_timer.h>
+#include <concepts>
+#include <system_error>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Backend of the 'nvs_handler' that stores the entries in the nvs partition.
+ *
+ * Commits are delayed with an esp_timer, so the callback runs on the timer task.
+ */
+class esp_nvs_backend {
+public:
+	esp_nvs_backend() = default;
+
+	esp_nvs_backend(const esp_nvs_backend&) = delete;
+	esp_nvs_backend& operator=(const esp_nvs_backend&) = delete;
+
+	/**
+	 * @brief Initializes the nvs flash on first use and opens the namespace for reading and writing.
+	 *
+	 * @return std::error_code indicating the result of the operation. Zero on success, non-zero on error.
+	 */
+	[[nodiscard]] std::error_code open(const char *name);
+
+	template<std::integral T>
+	[[nodiscard]] std::error_code get_int(const char *key, T &dst);
+
+	template<std::integral T>
+	[[nodiscard]] std::error_code set_int(const char *key, T src);
+
+	[[nodiscard]] std::error_code get_str(const char *key, char *dst, usize &size);
+
+	[[nodiscard]] std::error_code set_str(const char *key, const char *src);
+
+	[[nodiscard]] std::error_code get_blob(const char *key, void *dst, usize &size);
+
+	[[nodiscard]] std::error_code set_blob(const char *key, const void *src, usize size);
+
+	[[nodiscard]] std::error_code commit();
+
+	bool schedule_commit(i64 delayMicros, void (*callback)(void*), void *arg);
+
+	void cancel_commit();
+
+	~esp_nvs_backend();
+
+private:
+	nvs_handle_t m_handle{};
+	esp_timer_handle_t m_commitTimer{ nullptr };
+};
+
+static_assert(nvs_backend_concept<esp_nvs_backend>);
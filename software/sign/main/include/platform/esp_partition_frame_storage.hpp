@@ -0,0 +1,53 @@
+#pragma once
+
+#include <concepts/frame_storage_concept.hpp>
+#include <util/uix.hpp>
+#include <esp_partition.h>
+#include <system_error>
+#include <span>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Frame library storage backed by a data partition of the flash.
+ *
+ * The partition is memory mapped for reading, so frames are fetched through
+ * the flash cache instead of being copied into ram.
+ */
+class esp_partition_frame_storage {
+public:
+	static constexpr auto partitionSubtype = static_cast<esp_partition_subtype_t>(0x40);
+
+	esp_partition_frame_storage() = default;
+
+	esp_partition_frame_storage(const esp_partition_frame_storage&) = delete;
+	esp_partition_frame_storage& operator=(const esp_partition_frame_storage&) = delete;
+
+	/**
+	 * @brief Looks up the partition with the given label.
+	 *
+	 * @return std::error_code indicating the result of the operation. Zero on success, non-zero on error.
+	 */
+	[[nodiscard]] std::error_code open(const char *label);
+
+	[[nodiscard]] usize size() const;
+
+	[[nodiscard]] usize block_size() const;
+
+	[[nodiscard]] std::error_code erase(usize offset, usize size);
+
+	[[nodiscard]] std::error_code write(usize offset, std::span<const u8> data);
+
+	[[nodiscard]] std::error_code map(std::span<const u8> &region);
+
+	void unmap();
+
+	~esp_partition_frame_storage();
+
+private:
+	const esp_partition_t *m_partition{ nullptr };
+	esp_partition_mmap_handle_t m_mapHandle{};
+	const u8 *m_mapped{ nullptr };
+};
+
+static_assert(frame_storage_concept<esp_partition_frame_storage>);
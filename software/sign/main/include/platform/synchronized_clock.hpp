@@ -0,0 +1,28 @@
+#pragma once
+
+#include <util/clock_estimator.hpp>
+#include <util/seqlock.hpp>
+
+/**
+ * @brief Local clock that follows the reference clock of the plugin.
+ *
+ * Samples are fed by the task handling the connection, the current mapping
+ * can be read from any task without locking.
+ * Until the first sample arrives the reference time equals the local time.
+ */
+class synchronized_clock {
+public:
+	static constexpr usize windowSize = 16;
+
+	[[nodiscard]] static i64 local();
+
+	[[nodiscard]] i64 now() const;
+
+	[[nodiscard]] clock_mapping mapping() const;
+
+	void addSample(const clock_sample &sample);
+
+private:
+	clock_estimator<windowSize> m_estimator{};
+	ztu::seqlock<clock_mapping> m_mapping{};
+};
@@ -35,6 +35,7 @@ namespace config_webserver {
 	}
 
 	inline esp_err_t stop() {
+		stop_preview();
 		return httpd_ssl_stop(server);
 	}
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <concepts>
+#include <string_view>
+
+#include <util/string_literal.hpp>
+
+namespace html {
+
+	/**
+	 * @brief Receives the chunks of a response, an empty chunk ends the response.
+	 */
+	template<typename T>
+	concept chunk_sink = requires(T sink, std::string_view chunk) {
+		{ sink.sendChunk(chunk) } -> std::same_as<bool>;
+	};
+
+	/**
+	 * @brief Streams html to a sink, collecting small pieces in a fixed buffer.
+	 *
+	 * Pieces that do not fit into the buffer are sent as they are, so the memory
+	 * per response stays at 'BufferSize' no matter how large the page is.
+	 * After the first failed send everything is dropped and 'finish' reports the failure.
+	 */
+	template<chunk_sink Sink, std::size_t BufferSize = 512>
+	class chunked_writer {
+	public:
+		explicit chunked_writer(Sink &sink);
+
+		void write(std::string_view text);
+
+		template<ztu::sl_ssize_t N>
+		void write(const ztu::string_literal<N> &text);
+
+		/**
+		 * @brief Writes text that is not part of the markup, escaping the characters html would interpret.
+		 */
+		void writeEscaped(std::string_view text);
+
+		/**
+		 * @brief Sends the buffered bytes and ends the response.
+		 * @return false if any chunk could not be sent.
+		 */
+		[[nodiscard]] bool finish();
+
+	private:
+		void flush();
+
+		Sink &m_sink;
+		std::array<char, BufferSize> m_buffer;
+		std::size_t m_size{ 0 };
+		bool m_ok{ true };
+	};
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	chunked_writer<Sink, BufferSize>::chunked_writer(Sink &sink) : m_sink{ sink } {}
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	void chunked_writer<Sink, BufferSize>::write(std::string_view text) {
+		if (text.size() > m_buffer.size() - m_size) {
+			flush();
+			if (text.size() >= m_buffer.size()) {
+				if (m_ok and not text.empty()) {
+					m_ok = m_sink.sendChunk(text);
+				}
+				return;
+			}
+		}
+		std::copy(text.begin(), text.end(), m_buffer.begin() + m_size);
+		m_size += text.size();
+	}
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	template<ztu::sl_ssize_t N>
+	void chunked_writer<Sink, BufferSize>::write(const ztu::string_literal<N> &text) {
+		write(std::string_view(text.c_str(), text.size()));
+	}
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	void chunked_writer<Sink, BufferSize>::writeEscaped(std::string_view text) {
+		auto begin = text.begin();
+		for (auto it = begin; it != text.end(); ++it) {
+			std::string_view entity;
+			switch (*it) {
+				case '&':  entity = "&amp;"; break;
+				case '<':  entity = "&lt;"; break;
+				case '>':  entity = "&gt;"; break;
+				case '\'': entity = "&#39;"; break;
+				case '"':  entity = "&quot;"; break;
+				default: continue;
+			}
+			write({ begin, it });
+			write(entity);
+			begin = it + 1;
+		}
+		write({ begin, text.end() });
+	}
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	bool chunked_writer<Sink, BufferSize>::finish() {
+		flush();
+		if (m_ok) {
+			m_ok = m_sink.sendChunk({});
+		}
+		return m_ok;
+	}
+
+	template<chunk_sink Sink, std::size_t BufferSize>
+	void chunked_writer<Sink, BufferSize>::flush() {
+		if (m_ok and m_size > 0) {
+			m_ok = m_sink.sendChunk({ m_buffer.data(), m_size });
+		}
+		m_size = 0;
+	}
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <span>
+#include <string_view>
 #include <tuple>
 
 #include <util/string_literal.hpp>
-#include "esp_https_server.h"
+#include "chunked_writer.hpp"
+
+// defined by esp_http_server, only the post parsing in 'form_post.hpp' needs to know it
+struct httpd_req;
 
 namespace html {
 
@@ -28,35 +32,40 @@ namespace html {
 
 	template<form_field... Fields>
 	class form {
+		template<form_field>
+		using field_view_t = std::string_view;
+
 	public:
 
+		/**
+		 * @brief Streams the form with the given field values, the markup around them is built at compile time.
+		 */
 		template<
 			string_literal Title,
 			string_literal PostTo,
 			string_literal RedirectTo,
-			ssize_t... Ns
+			class Writer
 		>
-			requires (sizeof...(Ns) == sizeof...(Fields))
-		static constexpr auto createForm(const string_literal<Ns>&... values);
+		static void render(Writer &writer, field_view_t<Fields>... values);
 
-		static auto getPostData(httpd_req_t *req, bool &success);
+		static auto getPostData(httpd_req *req, bool &success);
 
 	private:
 		using value_tuple_t = std::tuple<typename decltype(Fields)::type::value_t...>;
 
-		template<class Field, ssize_t N>
-		static constexpr auto createField(const string_literal<N> &value);
+		template<class Field, class Writer>
+		static void renderField(Writer &writer, std::string_view value);
 
 		static auto parsePostBody(std::span<char> buffer, value_tuple_t &values);
 
 	};
 
 	template<form_field... Fields>
-	template<class Field, ssize_t N>
-	constexpr auto form<Fields...>::createField(const string_literal<N> &value) {
+	template<class Field, class Writer>
+	void form<Fields...>::renderField(Writer &writer, std::string_view value) {
 		using namespace ztu::string_literals;
 
-		constexpr auto labelHtml = [&]() {
+		static constexpr auto labelHtml = []() {
 			if constexpr (Field::title.length() > 0) {
 				return "<label for='"_sl + Field::name + "'>"_sl + Field::title + "</label><br>"_sl;
 			} else {
@@ -64,10 +73,12 @@ namespace html {
 			}
 		}();
 
-		constexpr auto beforeValue = labelHtml +
+		static constexpr auto beforeValue = labelHtml +
 			"<input name='"_sl + Field::name + "'"_sl + Field::type::getAttributes() + " value='"_sl;
-		
-		return beforeValue + value + "'><br>"_sl;
+
+		writer.write(beforeValue);
+		writer.writeEscaped(value);
+		writer.write("'><br>");
 	}
 
 	template<form_field... Fields>
@@ -75,15 +86,12 @@ namespace html {
 		string_literal Title,
 		string_literal PostTo,
 		string_literal RedirectTo,
-		ssize_t... Ns
+		class Writer
 	>
-		requires (sizeof...(Ns) == sizeof...(Fields))
-	constexpr auto form<Fields...>::createForm(
-		const string_literal<Ns>&... values
-	) {
+	void form<Fields...>::render(Writer &writer, field_view_t<Fields>... values) {
 		using namespace ztu::string_literals;
 
-		constexpr auto title = []() {
+		static constexpr auto title = []() {
 			if constexpr (Title.length() > 0) {
 				return "<h1>"_sl + Title + "</h1>"_sl;
 			} else {
@@ -91,92 +99,14 @@ namespace html {
 			}
 		}();
 
-		constexpr auto beforeFields = (
+		static constexpr auto beforeFields = (
 			"<div id='input-box' class='content-container'>"_sl + title +
 			"<form action='"_sl + PostTo + "'redirect='"_sl + RedirectTo +
 			"'method='post'>"_sl
 		);
 
-		constexpr auto afterFields = "<input type=submit value=Ok></form></div>"_sl;
-		
-		if constexpr (sizeof...(values) > 0) {
-			return beforeFields + (createField<decltype(Fields)>(values) + ...) + afterFields;
-		} else {
-			return beforeFields + afterFields;
-		}
-	}
-
-	template<form_field... Fields>
-	auto form<Fields...>::getPostData(httpd_req_t *req, bool &success) {
-		constexpr auto BufferSize = ((
-			decltype(decltype(Fields)::name)::max_size + 1 +
-			decltype(Fields)::type::maxBytes) + ...
-		) + sizeof...(Fields) - 1;
-		
-		std::array<char, BufferSize> buffer;
-
-		value_tuple_t values;
-
-		if (req->content_len <= buffer.size() && httpd_req_recv(req, buffer.data(), req->content_len) > 0) {
-			success = parsePostBody({ buffer.begin(), buffer.begin() + req->content_len }, values);
-		} else {
-			printf("Could not parse buffer %d %d\n", req->content_len, buffer.size());
-			success = false;
-		}
-
-		return values;
-	}
-
-	template<form_field... Fields>
-	auto form<Fields...>::parsePostBody(std::span<char> buffer, value_tuple_t &values) {
-		
-		constexpr char equalChar = 255;
-		constexpr char andChar = 254;
-
-		auto bufferEnd = buffer.end();
-		const auto parseKeyValuePair = [&]<typename Field>(auto &value) {
-			const auto sv = std::string_view(buffer.begin(), bufferEnd);
-
-			constexpr auto &key = Field::name;
-
-			const auto keyIndex = sv.find(key.c_str());
-			if (keyIndex == std::string::npos)
-				return false;
-
-			const auto keyBegin = buffer.begin() + keyIndex;
-			if ((bufferEnd - keyBegin) < key.max_length + 1)
-				return false;
-
-			const auto keyEnd = keyBegin + key.max_length;
-			if (*keyEnd != equalChar)
-				return false;
-
-			const auto valueBegin = keyEnd + 1;
-			const auto valueEnd = std::find(valueBegin, bufferEnd, andChar);
-
-			const auto length = valueEnd - valueBegin;
-			using valueType = typename Field::type;
-			if (length > valueType::maxBytes)
-				return false;
-
-			valueType::parseValue(&(*valueBegin), &(*valueEnd), value);
-
-			const auto fullLength = valueEnd - keyBegin;
-			std::move(valueEnd, bufferEnd, keyBegin);
-			bufferEnd -= fullLength;
-		
-			return true;
-		};
-
-	
-		bool success = true;
-		std::apply(
-			[&](auto&... value) {
-				success = (parseKeyValuePair.template operator()<decltype(Fields)>(value) && ... );
-			},
-			values
-		);
-
-		return success;
+		writer.write(beforeFields);
+		(renderField<decltype(Fields)>(writer, values), ...);
+		writer.write("<input type=submit value=Ok></form></div>");
 	}
 }
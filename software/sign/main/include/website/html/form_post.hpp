@@ -0,0 +1,82 @@
+#pragma once
+
+#include "form.hpp"
+#include <algorithm>
+#include "esp_https_server.h"
+
+namespace html {
+
+	template<form_field... Fields>
+	auto form<Fields...>::getPostData(httpd_req *req, bool &success) {
+		constexpr auto BufferSize = ((
+			decltype(decltype(Fields)::name)::max_size + 1 +
+			decltype(Fields)::type::maxBytes) + ...
+		) + sizeof...(Fields) - 1;
+		
+		std::array<char, BufferSize> buffer;
+
+		value_tuple_t values;
+
+		if (req->content_len <= buffer.size() && httpd_req_recv(req, buffer.data(), req->content_len) > 0) {
+			success = parsePostBody({ buffer.begin(), buffer.begin() + req->content_len }, values);
+		} else {
+			printf("Could not parse buffer %d %d\n", req->content_len, buffer.size());
+			success = false;
+		}
+
+		return values;
+	}
+
+	template<form_field... Fields>
+	auto form<Fields...>::parsePostBody(std::span<char> buffer, value_tuple_t &values) {
+		
+		constexpr char equalChar = 255;
+		constexpr char andChar = 254;
+
+		auto bufferEnd = buffer.end();
+		const auto parseKeyValuePair = [&]<typename Field>(auto &value) {
+			const auto sv = std::string_view(buffer.begin(), bufferEnd);
+
+			constexpr auto &key = Field::name;
+
+			const auto keyIndex = sv.find(key.c_str());
+			if (keyIndex == std::string::npos)
+				return false;
+
+			const auto keyBegin = buffer.begin() + keyIndex;
+			if ((bufferEnd - keyBegin) < key.max_length + 1)
+				return false;
+
+			const auto keyEnd = keyBegin + key.max_length;
+			if (*keyEnd != equalChar)
+				return false;
+
+			const auto valueBegin = keyEnd + 1;
+			const auto valueEnd = std::find(valueBegin, bufferEnd, andChar);
+
+			const auto length = valueEnd - valueBegin;
+			using valueType = typename Field::type;
+			if (length > valueType::maxBytes)
+				return false;
+
+			valueType::parseValue(&(*valueBegin), &(*valueEnd), value);
+
+			const auto fullLength = valueEnd - keyBegin;
+			std::move(valueEnd, bufferEnd, keyBegin);
+			bufferEnd -= fullLength;
+		
+			return true;
+		};
+
+	
+		bool success = true;
+		std::apply(
+			[&](auto&... value) {
+				success = (parseKeyValuePair.template operator()<decltype(Fields)>(value) && ... );
+			},
+			values
+		);
+
+		return success;
+	}
+}
@@ -85,4 +85,29 @@ namespace input_types {
 			dst = *reinterpret_cast<const value_t*>(begin);
 		}
 	};
+
+	template<uint16_t MaxCount>
+	struct led_count {
+		static constexpr auto maxBytes = 2;
+		using value_t = uint16_t;
+		static constexpr auto getAttributes() {
+			using namespace ztu::string_literals;
+
+			std::array<char, 5> digits{};
+			auto first = digits.end();
+			auto count = MaxCount;
+			do {
+				*--first = static_cast<char>('0' + count % 10);
+				count /= 10;
+			} while (count != 0);
+
+			string_literal<digits.size() + 1> max;
+			max.assign(first, digits.end() - first);
+
+			return "type=number min=1 max="_sl + max + " step=1 data-t=u16"_sl;
+		}
+		static constexpr auto parseValue(const char *begin, const char *end, value_t &dst) {
+			dst = *reinterpret_cast<const value_t*>(begin);
+		}
+	};
 }
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "form.hpp"
+#include "input_types.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Fields of the networking page, 'MaxPixels' is the longest strip the sign can drive.
+ */
+template<std::uint16_t MaxPixels>
+using networking_form = html::form<
+	html::form_field<"IP-Address:", "ip",  input_types::ipv4>{},
+	html::form_field<"Netmask:", "nm", input_types::ipv4>{},
+	html::form_field<"Gateway:", "gw", input_types::ipv4>{},
+	html::form_field<"Port:", "port", input_types::port>{},
+	html::form_field<"LEDs:", "leds", input_types::led_count<MaxPixels>>{}
+>;
@@ -1,18 +1,26 @@
 #pragma once
 
 #include "util/string_literal.hpp"
+#include "chunked_writer.hpp"
 
 namespace html::page {
-	template<string_literal Title, string_literal Script, string_literal Css, ssize_t N>
-	constexpr auto createDefault(const string_literal<N> &body) {
+
+	using ztu::string_literal;
+
+	/**
+	 * @brief Streams the default page around the content written by 'renderBody'.
+	 */
+	template<string_literal Title, string_literal Script, string_literal Css, class Writer, class BodyRenderer>
+	void renderDefault(Writer &writer, BodyRenderer &&renderBody) {
 		using namespace ztu::string_literals;
-		constexpr auto beforeBody = 
+		static constexpr auto beforeBody = 
 			"<!doctype html><html lang='en'><head><meta charset='utf-8'><title>"_sl +
 			Title + "</title><script src="_sl + Script +
 			"></script><link rel='stylesheet' type='text/css' href="_sl + Css +
 			"></head><body><div class='centered-content center'>"_sl;
-		
-		constexpr auto afterBody = "</div></body></html>"_sl;
-		return beforeBody + body + afterBody;
+
+		writer.write(beforeBody);
+		renderBody(writer);
+		writer.write("</div></body></html>");
 	}
 }
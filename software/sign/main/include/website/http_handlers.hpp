@@ -1,9 +1,14 @@
 #pragma once
 
 #include "html/form.hpp"
+#include "html/form_post.hpp"
 #include "html/page.hpp"
 #include "html/input_types.hpp"
 #include "html/error_form.hpp"
+#include "static_asset.hpp"
+
+// generated from source/website at build time
+#include <website/assets.hpp>
 
 #include <domain_logic/sign.hpp>
 #include <esp_https_server.h>
@@ -13,6 +18,42 @@ inline esp_err_t httpd_resp_send_400(httpd_req_t *req) {
 	return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, NULL);
 }
 
+/**
+ * @brief Sends the chunks of 'html::chunked_writer' as a chunked http response.
+ */
+struct httpd_chunk_sink {
+	httpd_req_t *req;
+
+	bool sendChunk(std::string_view chunk) {
+		return httpd_resp_send_chunk(req, chunk.data(), static_cast<ssize_t>(chunk.size())) == ESP_OK;
+	}
+};
+
+using html_writer = html::chunked_writer<httpd_chunk_sink>;
+
+/**
+ * @brief Streams a page of the config website, 'renderForm' writes the form above the error form.
+ */
+template<ztu::string_literal Title, class FormRenderer>
+esp_err_t send_page(httpd_req_t *req, FormRenderer &&renderForm) {
+	httpd_resp_set_type(req, "text/html");
+
+	httpd_chunk_sink sink{ req };
+	html_writer writer(sink);
+
+	html::page::renderDefault<Title, website_assets::script_js_uri, website_assets::style_css_uri>(
+		writer,
+		[&](html_writer &writer) {
+			// filled by the live preview in 'script.js'
+			writer.write("<canvas id=preview class=content-container></canvas>");
+			renderForm(writer);
+			renderErrorForm(writer, sign.error);
+		}
+	);
+
+	return writer.finish() ? ESP_OK : ESP_FAIL;
+}
+
 inline esp_err_t httpd_resp_send_200(httpd_req_t *req) {
 	httpd_resp_set_type(req, "text/html");
 	return httpd_resp_send(req, "", HTTPD_RESP_USE_STRLEN);
@@ -40,15 +81,24 @@ esp_err_t done_post_handler(httpd_req_t *req);
 
 esp_err_t reset_error_handler(httpd_req_t *req);
 
+esp_err_t preview_handler(httpd_req_t *req);
+
+esp_err_t metrics_handler(httpd_req_t *req);
+
+/**
+ * @brief Ends the stream of the live preview, has to be called before the server stops.
+ */
+void stop_preview();
+
 constexpr httpd_uri_t handlers[]{
 	{
-		.uri		= "/style.css",
+		.uri		= website_assets::style_css.uri,
 		.method		= HTTP_GET,
 		.handler	= style_handler,
 		.user_ctx	= nullptr
 	},
 	{
-		.uri		= "/script.js",
+		.uri		= website_assets::script_js.uri,
 		.method		= HTTP_GET,
 		.handler	= script_handler,
 		.user_ctx	= nullptr
@@ -112,5 +162,18 @@ constexpr httpd_uri_t handlers[]{
 		.method		= HTTP_POST,
 		.handler	= reset_error_handler,
 		.user_ctx	= nullptr
+	},
+	{
+		.uri			= "/preview/",
+		.method			= HTTP_GET,
+		.handler		= preview_handler,
+		.user_ctx		= nullptr,
+		.is_websocket	= true
+	},
+	{
+		.uri		= "/metrics",
+		.method		= HTTP_GET,
+		.handler	= metrics_handler,
+		.user_ctx	= nullptr
 	}
 };
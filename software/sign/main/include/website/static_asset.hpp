@@ -0,0 +1,24 @@
+#pragma once
+
+#include <esp_http_server.h>
+#include <util/uix.hpp>
+#include <span>
+
+using namespace ztu::uix;
+
+/**
+ * @brief Gzipped website asset embedded by 'tools/website_assets.py'.
+ *
+ * The uri contains the content hash, so a given uri always serves the same bytes.
+ */
+struct static_asset {
+	const char *uri;
+	const char *content_type;
+	const char *etag;
+	std::span<const u8> gzipped;
+};
+
+/**
+ * @brief Sends the asset with caching headers or '304 Not Modified' if the client already has it.
+ */
+esp_err_t send_static_asset(httpd_req_t *req, const static_asset &asset);
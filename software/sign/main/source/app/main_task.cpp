@@ -8,13 +8,48 @@
 
 constexpr auto MAIN_TAG = "MAIN_TASK";
 
+// Recorded for the whole runtime, so the plugin can see how the sign got to the connection.
+static main_task_stats_t task_stats;
+
+// Local time at which the plugin connected, the handshake duration is measured from it.
+static i64 handshake_start = 0;
+
+
+static bool load_frame_library() {
+	std::span<const u8> region;
+	if (const auto e = sign.frame_storage.map(region); e) {
+		ESP_LOGW(MAIN_TAG, "[FRAME_LIBRARY]: %s", e.message().c_str());
+		return false;
+	}
+
+	const auto library = frame_library::open(region);
+	if (not library) {
+		ESP_LOGI(MAIN_TAG, "No frame library found");
+		return false;
+	}
+
+	sign.frames = *library;
+	frame_library::activate(&sign.frames);
+	ESP_LOGI(MAIN_TAG, "Frame library with %d clips loaded", static_cast<int>(sign.frames.size()));
+
+	return true;
+}
+
 void main_task(void *) {
 
+	sign.main_task_handle = xTaskGetCurrentTaskHandle();
+
 	if (not sign.storage.open("storage")) {
 		ESP_LOGE(MAIN_TAG, "[NVS_INIT_ERROR]: nvs init failed");
 		return;
 	}
 
+	if (const auto e = sign.frame_storage.open("animations"); e) {
+		ESP_LOGW(MAIN_TAG, "[FRAME_LIBRARY]: %s", e.message().c_str());
+	} else {
+		load_frame_library();
+	}
+
 	/*
 	ESP_LOGI(TAG, "Resetting setup done flag");
 	sign.storage.set<storage_keys::SETUP_DONE>(false);
@@ -86,7 +121,8 @@ void main_task(void *) {
 		return from != CONFIG_ERROR;
 	};
 
-	state_machine<
+	basic_state_machine<
+		main_task_stats_t&,
 	    decltype(on_state_change),
 		choose_task,
 		start_setup_server,
@@ -97,7 +133,7 @@ void main_task(void *) {
 		validate_connection,
 		connect_to_plugin,
 		reveive_message
-	> task(std::move(on_state_change));
+	> task(std::move(on_state_change), task_stats);
 
 	task.run(main_task_states::CHOOSE_TASK);
 
@@ -111,21 +147,32 @@ static inline void handleCommand(const sign_message &msg) {
 		using enum sign_message_type;
 		case CHANGE_STATE: {
 			ESP_LOGI(TAG, "change state");
-			const auto &[ state ] = msg.get<CHANGE_STATE>();
+			const auto &[ state, applyAt ] = msg.get<CHANGE_STATE>();
 			ESP_LOGI(TAG, "Entering state: %d", (int) state);
-			sign.animation_controller.setState(state);
+			sign.animation_controller.setState(state, applyAt);
 			break;
 		};
 		case SET_ANIMATION: {
 			ESP_LOGI(TAG, "set animation");
-			const auto &[ state, animation ] = msg.get<SET_ANIMATION>();
-			sign.animation_controller.setAnimation(state, animation);
+			const auto &[ state, animation, applyAt ] = msg.get<SET_ANIMATION>();
+			sign.animation_controller.setAnimation(state, animation, applyAt);
 			break;
 		};
 		case HEARTBEAT: {
 			ESP_LOGI(TAG, "heartbeat");
 			break;
 		};
+		case SET_PARAMS: {
+			const auto &[ params ] = msg.get<SET_PARAMS>();
+			ESP_LOGD(TAG, "set params: brightness %d hue %d speed %d", params.brightness, params.hueShift, params.speed);
+			sign.animation_controller.setParams(params);
+			break;
+		};
+		case TIME_SYNC: {
+			const auto &[ sample ] = msg.get<TIME_SYNC>();
+			sign.clock.addSample(sample);
+			break;
+		};
     default: {
 			ESP_LOGI(TAG, "(unimplemented command)");
 		}
@@ -133,6 +180,73 @@ static inline void handleCommand(const sign_message &msg) {
 }
 
 
+static std::optional<frame_upload::reply> handleUpload(const sign_message &msg, hmac_sha_512_engine &sha_engine) {
+	static constexpr auto TAG = "HANDLE_UPLOAD";
+	using enum frame_upload::status;
+
+	std::optional<frame_upload::reply> reply;
+
+	switch (msg.type()) {
+		using enum sign_message_type;
+		case UPLOAD_BEGIN: {
+			const auto &[ uploadId, clips ] = msg.get<UPLOAD_BEGIN>();
+			if (frame_library::active() and uploadId == sign.storage.get<storage_keys::FRAME_LIBRARY_ID>()) {
+				ESP_LOGI(TAG, "library %08lx is already installed", uploadId);
+				return frame_upload::reply{ uploadId, 0, COMPLETE };
+			}
+			reply = sign.frame_upload.begin(uploadId, clips.clips(), []() {
+				// The partition is about to be overwritten.
+				frame_library::activate(nullptr);
+			});
+			ESP_LOGI(TAG, "upload %08lx of %d clips continues at %lu", uploadId, clips.numClips, reply->offset);
+			break;
+		}
+		case UPLOAD_CHUNK: {
+			const auto &[ chunk ] = msg.get<UPLOAD_CHUNK>();
+			reply = sign.frame_upload.write(sha_engine, chunk);
+			if (reply->state == REJECTED) {
+				ESP_LOGW(TAG, "rejected chunk at %lu, expected %lu", chunk.offset, reply->offset);
+			}
+			break;
+		}
+		case UPLOAD_COMMIT: {
+			const auto &[ uploadId ] = msg.get<UPLOAD_COMMIT>();
+			reply = sign.frame_upload.commit(uploadId);
+			if (reply->state == COMPLETE) {
+				if (load_frame_library()) {
+					sign.storage.set<storage_keys::FRAME_LIBRARY_ID>(uploadId);
+				} else {
+					reply->state = FAILED;
+				}
+			}
+			break;
+		}
+		default:
+			return std::nullopt;
+	}
+
+	if (reply->state == FAILED) {
+		if (const auto e = sign.frame_upload.error(); e) {
+			ESP_LOGE(TAG, "[%s]: %s", e.category().name(), e.message().c_str());
+		} else {
+			ESP_LOGE(TAG, "upload failed");
+		}
+	}
+
+	return reply;
+}
+
+
+static state_stats::summary state_summary(u8 state) {
+	auto summary = task_stats.summary(static_cast<main_task_states>(state)).value_or(state_stats::summary{});
+	if (summary.numStates != 0) {
+		const auto name = main_task_state_name(static_cast<main_task_states>(state));
+		std::strncpy(summary.name.data(), name, summary.name.size() - 1);
+	}
+	return summary;
+}
+
+
 static inline void log_error_code(const char *origin, const std::error_code &e) {
 	ESP_LOGE(origin, "[%s]: %s", e.category().name(), e.message().c_str());
 }
@@ -268,6 +382,7 @@ main_task_states connect_to_wifi::run(
 
 	if (error) {
 		++num_retries;
+		sign.connection_metrics.wifiFailures.add();
 		log_error_code(TAG, error);
 		switch (static_cast<esp_error::codes>(error.value())) {
 			using enum esp_error::codes;
@@ -278,6 +393,8 @@ main_task_states connect_to_wifi::run(
 		}
 	}
 
+	sign.connection_metrics.wifiConnects.add();
+
 	return PREPARE_CONNECTION;
 }
 
@@ -342,6 +459,8 @@ main_task_states connect_to_plugin::run(
 	}
 
 	ESP_LOGI(MAIN_TAG, "Client connected");
+	sign.connection_metrics.pluginConnects.add();
+	handshake_start = synchronized_clock::local();
 
 	if ((error = conn.set_send_timeout(CONFIG_STATE_TIMEOUT_MS))) {
 		log_error_code(TAG, error);
@@ -398,6 +517,7 @@ main_task_states validate_connection::run(
 							state = RECEIVE_CHALLENGE;
 						} else {
 							ESP_LOGE(TAG, "Peer was not able to solve buffer.");
+							sign.connection_metrics.handshakeFailures.add();
 							return main_task_states::CONNECT_TO_PLUGIN;
 						}
 						break;
@@ -433,9 +553,13 @@ main_task_states validate_connection::run(
 					case RECEIVE_OK: {
 						if (buffer[0]) {
 							ESP_LOGI(TAG, "Connection validated.");
+							sign.connection_metrics.handshakeMillis.record(
+								static_cast<u32>((synchronized_clock::local() - handshake_start) / 1000)
+							);
 							return main_task_states::RECEIVE_MESSAGE;
 						} else {
 							ESP_LOGE(TAG, "Could not olve buffer sent by peer");
+							sign.connection_metrics.handshakeFailures.add();
 							return main_task_states::SETUP_ERROR;
 						}
 					}
@@ -449,6 +573,10 @@ main_task_states validate_connection::run(
 	return main_task_states::VALIDATE_CONNECTION;
 
 on_error:
+	if (error.value() != EAGAIN) {
+		sign.connection_metrics.handshakeFailures.add();
+	}
+
 	switch (error.value()) {
 		case EAGAIN: // just a timeout
 			return main_task_states::VALIDATE_CONNECTION;
@@ -478,7 +606,8 @@ main_task_states reveive_message::run(
 	sign_transceiver& transceiver,
 	sign_header& header,
 	sign_message& message,
-	std::span<u8>& io_bytes
+	std::span<u8>& io_bytes,
+	i64& receive_time
 ) {
 	using enum main_task_states;
 
@@ -498,20 +627,62 @@ main_task_states reveive_message::run(
 			if ((error = conn.receive(io_bytes))) goto on_error;
 			if (io_bytes.empty()) {
 				if (state == RECEIVE_HEADER) {
-					if ((error = transceiver.decrypt_header(header, io_bytes)))
+					receive_time = synchronized_clock::local();
+					if ((error = transceiver.decrypt_header(header, io_bytes))) {
+						sign.connection_metrics.decryptErrors.add();
 						goto on_error;
+					}
 					state = RECEIVE_BODY;
 				} else {
-					if ((error = transceiver.decrypt_body(header, message)))
+					if ((error = transceiver.decrypt_body(header, message))) {
+						sign.connection_metrics.decryptErrors.add();
 						goto on_error;
+					}
 					state = HANDLE_MESSAGE;
 				}
 			}
 			break;
 		}
 		case HANDLE_MESSAGE: {
-			handleCommand(message);
-			state = INIT_RECEIVE;
+			if (message.type() == sign_message_type::TIME_PING) {
+				const auto &[ reference_time ] = message.get<sign_message_type::TIME_PING>();
+				std::span<u8> packet;
+				if ((error = transceiver.encrypt_message<sign_message_type::TIME_PONG>(
+					packet, reference_time, receive_time, synchronized_clock::local()
+				))) goto on_error;
+				io_bytes = packet;
+				state = SEND_REPLY;
+			} else if (message.type() == sign_message_type::STATE_STATS_REQUEST) {
+				const auto &[ stats_state ] = message.get<sign_message_type::STATE_STATS_REQUEST>();
+				std::span<u8> packet;
+				if ((error = transceiver.encrypt_message<sign_message_type::STATE_STATS>(packet, state_summary(stats_state))))
+					goto on_error;
+				io_bytes = packet;
+				state = SEND_REPLY;
+			} else if (message.type() == sign_message_type::GET_METRICS) {
+				std::span<u8> packet;
+				if ((error = transceiver.encrypt_message<sign_message_type::METRICS>(packet, collect_metrics())))
+					goto on_error;
+				io_bytes = packet;
+				state = SEND_REPLY;
+			} else if (const auto reply = handleUpload(message, sha_engine); reply) {
+				std::span<u8> packet;
+				if ((error = transceiver.encrypt_message<sign_message_type::UPLOAD_STATUS>(packet, *reply)))
+					goto on_error;
+				io_bytes = packet;
+				state = SEND_REPLY;
+			} else {
+				handleCommand(message);
+				state = INIT_RECEIVE;
+			}
+			break;
+		}
+		case SEND_REPLY: {
+			auto &o_bytes = *reinterpret_cast<std::span<const u8>*>(&io_bytes);
+			if ((error = conn.send(o_bytes))) goto on_error;
+			if (io_bytes.empty()) {
+				state = INIT_RECEIVE;
+			}
 			break;
 		}
 	}
@@ -1,7 +1,47 @@
 #include <domain_logic/sign.hpp>
 
+#include <esp_system.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
 sign_t sign{
 	.storage{ },
+	.frame_storage{ },
+	.frames{ },
+	.frame_upload = frame_upload_receiver{ sign.frame_storage },
+	.clock{ },
 	.animation_controller{ },
-	.switch_task{ ATOMIC_FLAG_INIT }
+	.switch_task{ ATOMIC_FLAG_INIT },
+	.error{ },
+	.connection_metrics{ },
+	.main_task_handle = nullptr
 };
+
+sign_metrics collect_metrics() {
+	const auto render = sign.animation_controller.renderStats();
+	const auto handshake = sign.connection_metrics.handshakeMillis.summary();
+	const auto main_task_handle = sign.main_task_handle;
+
+	return {
+		.uptimeSeconds = static_cast<u32>(esp_timer_get_time() / 1'000'000),
+		.frames = render.renderMicros.count,
+		.missedTicks = render.missedTicks,
+		.renderMicrosLast = render.renderMicros.last,
+		.renderMicrosAverage = render.renderMicros.average,
+		.renderMicrosMax = render.renderMicros.max,
+		.freeHeap = esp_get_free_heap_size(),
+		.minFreeHeap = esp_get_minimum_free_heap_size(),
+		.largestFreeBlock = static_cast<u32>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)),
+		.mainStackHighWater = main_task_handle ? static_cast<u32>(uxTaskGetStackHighWaterMark(main_task_handle)) : 0,
+		.animationStackHighWater = render.stackHighWater,
+		.wifiConnects = sign.connection_metrics.wifiConnects.value(),
+		.wifiFailures = sign.connection_metrics.wifiFailures.value(),
+		.pluginConnects = sign.connection_metrics.pluginConnects.value(),
+		.handshakes = handshake.count,
+		.handshakeFailures = sign.connection_metrics.handshakeFailures.value(),
+		.handshakeMillisLast = handshake.last,
+		.handshakeMillisAverage = handshake.average,
+		.handshakeMillisMax = handshake.max,
+		.decryptErrors = sign.connection_metrics.decryptErrors.value()
+	};
+}
@@ -1,35 +1,79 @@
 #include <domain_logic/sign_animation_controller.hpp>
 #include <domain_logic/sign.hpp>
 
-void sign_animation_controller_t::init(sign_state initialState) {
-
-	animations[static_cast<size_t>(sign_state::IDLE)] = sign.storage.get<storage_keys::IDLE_ANIMATION>();
-	animations[static_cast<size_t>(sign_state::SETUP)] = sign.storage.get<storage_keys::SETUP_ANIMATION>();
+#include <util/for_each.hpp>
+#include <algorithm>
 
-	animationHandler.init(animations[static_cast<size_t>(initialState)]);
+void sign_animation_controller_t::init(sign_state initialState) {
+	currentState = initialState;
+	const auto numPixels = std::clamp<usize>(sign.storage.get<storage_keys::NUM_PIXELS>(), 1, CONFIG_MAX_NUM_PIXELS);
+	animationHandler.init(loadAnimation(initialState), sign.clock, numPixels);
 }
 
-void sign_animation_controller_t::setState(sign_state newState) {
+void sign_animation_controller_t::setState(sign_state newState, i64 applyAt) {
+	// Restarting the same animation would break its phase with other signs.
+	if (newState == currentState and applyAt == 0)
+		return;
 	currentState = newState;
-	updateAnimation();
+	updateAnimation(applyAt);
 }
 
-void sign_animation_controller_t::setAnimation(sign_state state, const sign_animation& newAnimation)  {
-	const auto stateIndex = static_cast<size_t>(state);
-	assert(stateIndex < animations.size());
-	animations[stateIndex] = newAnimation;
+void sign_animation_controller_t::setAnimation(sign_state state, const sign_animation& newAnimation, i64 applyAt)  {
+	assert(state < sign_state::LAST);
+	// The storage coalesces bursts of changes into a single deferred commit.
+	storeAnimation(state, newAnimation);
 	if (state == currentState) {
-		updateAnimation();
+		updateAnimation(applyAt);
 	}
-	if (state == sign_state::IDLE) {
-		sign.storage.set<storage_keys::IDLE_ANIMATION>(newAnimation);
-		sign.storage.save();
-	} else if (state == sign_state::SETUP) {
-		sign.storage.set<storage_keys::SETUP_ANIMATION>(newAnimation);
-		sign.storage.save();
+}
+
+void sign_animation_controller_t::setParams(const sign_animation_params& newParams) {
+	// Parameters are transient and intentionally never written to flash.
+	animationHandler.setParams(newParams);
+}
+
+void sign_animation_controller_t::setPreviewEnabled(bool enabled) {
+	animationHandler.setPreviewEnabled(enabled);
+}
+
+sign_animation_handler_t::preview_frame sign_animation_controller_t::previewFrame(u32 &version) const {
+	return animationHandler.previewFrame(version);
+}
+
+sign_animation_handler_t::render_stats sign_animation_controller_t::renderStats() const {
+	return animationHandler.renderStats();
+}
+
+void sign_animation_controller_t::updateAnimation(i64 applyAt) {
+	// Bounds the time a bogus timestamp can delay an animation.
+	constexpr i64 maxDelayMicros = 10'000'000;
+
+	const auto now = sign.clock.now();
+
+	auto epoch = now;
+	if (applyAt != 0 and sign.clock.mapping().synchronized) {
+		epoch = std::min(applyAt, now + maxDelayMicros);
 	}
+
+	animationHandler.setAnimation(loadAnimation(currentState), epoch);
+}
+
+sign_animation sign_animation_controller_t::loadAnimation(sign_state state) {
+	sign_animation animation;
+	ztu::for_each::index<animation_storage_keys.size()>([&]<auto Index>() {
+		if (Index != static_cast<size_t>(state))
+			return false;
+		animation = sign.storage.get<animation_storage_keys[Index]>();
+		return true;
+	});
+	return animation;
 }
 
-void sign_animation_controller_t::updateAnimation() {
-	animationHandler.setAnimation(animations[static_cast<size_t>(currentState)]);
+void sign_animation_controller_t::storeAnimation(sign_state state, const sign_animation& animation) {
+	ztu::for_each::index<animation_storage_keys.size()>([&]<auto Index>() {
+		if (Index != static_cast<size_t>(state))
+			return false;
+		sign.storage.set<animation_storage_keys[Index]>(animation);
+		return true;
+	});
 }
@@ -3,54 +3,46 @@
 #endif
 
 #include <cassert>
+#include <utility>
 
-rmt_color_converter &rmt_color_converter::operator=(const color& c) {
-	const auto setBit = [&](const auto index, const auto bit) {
-		if (bit) {
-			rmtPattern[index] = {
-				.duration0 = 10,
-				.level0    = 1,
-				.duration1 = 6,
-				.level1    = 0
-			};
-		} else {
-			rmtPattern[index] =  {
-				.duration0 = 4,
-				.level0    = 1,
-				.duration1 = 8,
-				.level1    = 0
-			};
-		}
+void WS2815_handler::translate(
+	const void *src, rmt_item32_t *dst, size_t srcSize, size_t wantedItems,
+	size_t *translatedSize, size_t *itemCount
+) {
+	static constexpr rmt_item32_t bit0{
+		.duration0 = 4,
+		.level0    = 1,
+		.duration1 = 8,
+		.level1    = 0
 	};
+	static constexpr rmt_item32_t bit1{
+		.duration0 = 10,
+		.level0    = 1,
+		.duration1 = 6,
+		.level1    = 0
+	};
+
+	const auto bytes = static_cast<const u8*>(src);
 
-	const auto setByte = [&](const auto index, auto byte) {
-		const auto bitOffset = index * 8;
+	size_t size = 0, items = 0;
+	// only whole bytes, the driver asks again for the rest
+	for (; size < srcSize and items + 8 <= wantedItems; size++) {
+		auto byte = bytes[size];
 		for (auto i = 0U; i < 8U; i++) {
-			setBit(bitOffset + i, byte & 0x80);
+			dst[items++] = byte & 0x80 ? bit1 : bit0;
 			byte <<= 1;
 		}
-	};
-
-	setByte(0, c.g);
-	setByte(1, c.r);
-	setByte(2, c.b);
+	}
 
-	return *this;
+	*translatedSize = size;
+	*itemCount = items;
 }
 
-
 WS2815_handler::WS2815_handler(gpio_num_t dataPin, usize pixels, rmt_channel_t channel):
-	rmtPattern(pixels * 24 + 1), rmtChannel{ channel }, numPixels{ pixels }
+	grbFrames(2 * 3 * pixels, 0),
+	writeFrame{ grbFrames.data() }, sendFrame{ grbFrames.data() + 3 * pixels },
+	rmtChannel{ channel }, numPixels{ pixels }
 {
-	std::fill(begin(), end(), colors::black);
-
-	rmtPattern.back() = {
-		.duration0 = 0,
-		.level0    = 0,
-		.duration1 = 0,
-		.level1    = 0
-	};
-
 	rmt_config_t rmtConfig {
 		.rmt_mode = RMT_MODE_TX,
 		.channel = rmtChannel,
@@ -65,31 +57,40 @@ WS2815_handler::WS2815_handler(gpio_num_t dataPin, usize pixels, rmt_channel_t c
 			.carrier_duty_percent = 50,
 			.carrier_en = false,
 			.loop_en = false,
-			.idle_output_en = true			
+			.idle_output_en = true
 		}
 	};
 
 	rmt_config(&rmtConfig);
 	rmt_driver_install(rmtChannel, 0, 0);
+	rmt_translator_init(rmtChannel, translate);
 }
 
-rmt_color_converter* WS2815_handler::begin() {
-	return reinterpret_cast<rmt_color_converter*>(rmtPattern.data());
+usize WS2815_handler::size() const {
+	return numPixels;
 }
 
-rmt_color_converter* WS2815_handler::end() {
-	return begin() + size();
+void WS2815_handler::write(usize firstPixel, std::span<const color> colors) {
+	assert(firstPixel + colors.size() <= size());
+	auto dst = writeFrame + 3 * firstPixel;
+	for (const auto &c : colors) {
+		*dst++ = c.g;
+		*dst++ = c.r;
+		*dst++ = c.b;
+	}
 }
 
-usize WS2815_handler::size() {
-	return numPixels;
-}
+bool WS2815_handler::operator()() {
+	// the driver translates from the frame while sending, so it must not be written until then
+	if (rmt_wait_tx_done(rmtChannel, portMAX_DELAY) != ESP_OK)
+		return false;
 
-rmt_color_converter &WS2815_handler::operator[](usize index) {
-	assert(index < size());
-	return *(begin() + index);
+	std::swap(writeFrame, sendFrame);
+
+	return rmt_write_sample(rmtChannel, sendFrame, 3 * numPixels, false) == ESP_OK;
 }
 
-bool WS2815_handler::operator()() {
-	return rmt_write_items(rmtChannel, rmtPattern.data(), rmtPattern.size() - 1, 1) == ESP_OK;
+WS2815_handler::~WS2815_handler() {
+	rmt_wait_tx_done(rmtChannel, portMAX_DELAY);
+	rmt_driver_uninstall(rmtChannel);
 }
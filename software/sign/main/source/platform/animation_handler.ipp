@@ -4,29 +4,57 @@
 
 #include <variant>
 #include <mutex>
+#include <cmath>
+#include <algorithm>
 
 #include <lighting/color.hpp>
+#include <lighting/color_modulator.hpp>
 #include <platform/WS2815_handler.hpp>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_timer.h>
 #include <util/variant_visit.hpp>
+#include <fill_random.hpp>
 
 template<class animations_t>
 void animation_handler<animations_t>::animation_task(void *arg) {
 
-	WS2815_handler leds(static_cast<gpio_num_t>(CONFIG_LED_DATA_PIN), animations_t::numPixels);
+	auto &shared = *static_cast<shared_animation_state*>(arg);
 
-	auto &[hasNewAnimation, newAnimation] = *static_cast<shared_animation_state*>(arg);
+	WS2815_handler leds(static_cast<gpio_num_t>(CONFIG_LED_DATA_PIN), shared.numPixels);
+	const auto numPixels = leds.size();
 
 	constexpr auto tickMillis = 1000 / CONFIG_ANIMATION_TICKS_PER_SECOND;
+	constexpr auto ticksPerMicro = static_cast<double>(CONFIG_ANIMATION_TICKS_PER_SECOND) / 1'000'000.0;
 
-	animation_t currentAnimation;
+	animation_t currentAnimation, pendingAnimation;
+	i64 pendingEpoch = 0;
+	bool hasPendingAnimation = false;
 
-	std::array<color, animations_t::numPixels> colorFrame{};
-	std::fill(colorFrame.begin(), colorFrame.end(), colors::black);
+	animation_params params{};
+	color_modulator modulator{};
 
-	u32 t = 0;
+	std::array<color, chunkPixels> chunk;
+
+	// the preview shows every n-th pixel of strips that are longer than it
+	const auto previewStride = (numPixels + maxPreviewPixels - 1) / maxPreviewPixels;
+	shared.nextPreview.numPixels = static_cast<u16>((numPixels + previewStride - 1) / previewStride);
+
+	// Animation time is a linear function of the shared reference clock,
+	// so signs that agree on the epoch also agree on the rendered frame.
+	i64 epoch = 0;
+	double epochT = 0.0, ticksPerReferenceMicro = 0.0;
+
+	const auto setRate = [&](i64 now) {
+		epochT += static_cast<double>(now - epoch) * ticksPerReferenceMicro;
+		epoch = now;
+		ticksPerReferenceMicro = (
+			ticksPerMicro * static_cast<double>(currentAnimation.speed) *
+			static_cast<double>(params.speed) / static_cast<double>(animation_params::unitSpeed)
+		);
+	};
+
+	auto mapping = shared.clock->mapping();
 
 	while (true) {
 		const auto startMicro = esp_timer_get_time();
@@ -36,30 +64,88 @@ void animation_handler<animations_t>::animation_task(void *arg) {
 
 		leds();
 
-		if (hasNewAnimation.test()) {
-			
-			currentAnimation = newAnimation;
-			hasNewAnimation.clear();
-			hasNewAnimation.notify_one();
-			
-			ztu::visit([](auto &animator) {
-				animator.init();
+		const auto newMapping = shared.clock->mapping();
+		if (newMapping.synchronized != mapping.synchronized) {
+			// The first synchronization moves the timeline from local into reference time, keep the phase.
+			epoch += newMapping.toReference(startMicro) - mapping.toReference(startMicro);
+		}
+		mapping = newMapping;
+
+		const auto now = mapping.toReference(startMicro);
+
+		if (shared.hasNewAnimation.test()) {
+
+			pendingAnimation = shared.animation;
+			pendingEpoch = shared.epoch;
+			hasPendingAnimation = true;
+
+			shared.hasNewAnimation.clear();
+			shared.hasNewAnimation.notify_one();
+		}
+
+		if (hasPendingAnimation and now >= pendingEpoch) {
+
+			currentAnimation = pendingAnimation;
+			hasPendingAnimation = false;
+
+			// Signs that get the same seed show the same random colors.
+			auto seed = currentAnimation.seed;
+			if (seed == 0) {
+				fill_random({ reinterpret_cast<u8*>(&seed), sizeof(seed) });
+			}
+
+			ztu::visit([&](auto &animator) {
+				animator.init(seed);
 			}, currentAnimation.animator);
 
-			t = 0;
+			epoch = pendingEpoch;
+			epochT = 0.0;
+			setRate(pendingEpoch);
 		}
 
+		if (const auto currentParams = shared.params.load(std::memory_order_relaxed); currentParams != params) {
+			params = currentParams;
+			modulator = color_modulator(params);
+			setRate(now);
+		}
+
+		const auto t = static_cast<u32>(static_cast<i64>(
+			std::floor(epochT + static_cast<double>(now - epoch) * ticksPerReferenceMicro)
+		));
+
+		const auto previewEnabled = shared.previewEnabled.load(std::memory_order_relaxed);
+
 		ztu::visit([&](auto &animate) {
-			animate(colorFrame, t);
-		}, currentAnimation.animator);
+			for (usize firstPixel = 0; firstPixel < numPixels; firstPixel += chunkPixels) {
+				const auto part = std::span(chunk).first(std::min(chunkPixels, numPixels - firstPixel));
 
-		t += currentAnimation.speed;
+				animate(part, t, firstPixel, numPixels);
+				modulator(part);
 
-		std::copy(colorFrame.begin(), colorFrame.end(), leds.begin());
+				if (previewEnabled) {
+					const auto firstSample = (firstPixel + previewStride - 1) / previewStride;
+					for (auto p = firstSample * previewStride; p < firstPixel + part.size(); p += previewStride) {
+						shared.nextPreview.pixels[p / previewStride] = part[p - firstPixel];
+					}
+				}
+
+				leds.write(firstPixel, part);
+			}
+		}, currentAnimation.animator);
+
+		if (previewEnabled) {
+			shared.preview.store(shared.nextPreview);
+		}
 
 		const auto endMicro = esp_timer_get_time();
 
-		const auto millisUsed = (endMicro - startMicro) / 1000;
+		const auto microsUsed = endMicro - startMicro;
+		shared.renderMicros.record(static_cast<u32>(microsUsed));
+		if (microsUsed > tickMillis * 1000) {
+			shared.missedTicks.add(static_cast<u32>(microsUsed / (tickMillis * 1000)));
+		}
+
+		const auto millisUsed = microsUsed / 1000;
 		const auto timeLeftInTick = std::max(tickMillis - millisUsed, 0LL);
 
 		vTaskDelay(timeLeftInTick / portTICK_PERIOD_MS);
@@ -67,21 +153,52 @@ void animation_handler<animations_t>::animation_task(void *arg) {
 }
 
 template<class animations_t>
-void animation_handler<animations_t>::init(const animation_t& newAnimation) {
+void animation_handler<animations_t>::init(const animation_t& newAnimation, const synchronized_clock& clock, usize numPixels) {
 	static std::once_flag initFlag;
 	std::call_once(initFlag, [&]() {
-		shared_state = new shared_animation_state(true, newAnimation);
-		xTaskCreate(animation_task, "animation", 4096, shared_state, tskIDLE_PRIORITY + 1, &animation_task_handle);
+		shared_state = new shared_animation_state(true, newAnimation, clock.now(), &clock);
+		shared_state->numPixels = numPixels;
+		// the preview is copied through the stack when it is published
+		xTaskCreate(animation_task, "animation", 4096 + sizeof(preview_frame), shared_state, tskIDLE_PRIORITY + 1, &animation_task_handle);
 	});
 }
 
 template<class animations_t>
-void animation_handler<animations_t>::setAnimation(const animation_t& newAnimation) {
+void animation_handler<animations_t>::setAnimation(const animation_t& newAnimation, i64 epoch) {
 	shared_state->hasNewAnimation.wait(true);
 	shared_state->animation = newAnimation;
+	shared_state->epoch = epoch;
 	shared_state->hasNewAnimation.test_and_set();
 }
 
+template<class animations_t>
+void animation_handler<animations_t>::setParams(const animation_params& newParams) {
+	shared_state->params.store(newParams, std::memory_order_relaxed);
+}
+
+template<class animations_t>
+void animation_handler<animations_t>::setPreviewEnabled(bool enabled) {
+	shared_state->previewEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+template<class animations_t>
+typename animation_handler<animations_t>::preview_frame animation_handler<animations_t>::previewFrame(u32 &version) const {
+	version = shared_state->preview.version();
+	return shared_state->preview.load();
+}
+
+template<class animations_t>
+typename animation_handler<animations_t>::render_stats animation_handler<animations_t>::renderStats() const {
+	if (shared_state == nullptr)
+		return {};
+
+	return {
+		.renderMicros = shared_state->renderMicros.summary(),
+		.missedTicks = shared_state->missedTicks.value(),
+		.stackHighWater = static_cast<u32>(uxTaskGetStackHighWaterMark(animation_task_handle))
+	};
+}
+
 template<class animations_t>
 animation_handler<animations_t>::~animation_handler() {
 	vTaskDelete(animation_task_handle);
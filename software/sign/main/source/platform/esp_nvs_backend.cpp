@@ -0,0 +1,148 @@
+#include <platform/esp_nvs_backend.hpp>
+#include <platform/esp_error.hpp>
+
+#include <esp_log.h>
+
+
+static constexpr auto TAG = "nvs_backend";
+
+static std::error_code make_esp_error(esp_err_t code) {
+	return esp_error::make_error_code(static_cast<esp_error::codes>(code));
+}
+
+static std::error_code check_read(esp_err_t ret, const char *key) {
+	if (ret != ESP_OK) {
+		ESP_LOGW(TAG, "Error '0x%x' while retrieving value with key '%s'.", ret, key);
+	}
+	return make_esp_error(ret);
+}
+
+static std::error_code check_write(esp_err_t ret, const char *key) {
+	if (ret != ESP_OK) {
+		ESP_LOGE(TAG, "Error '0x%x' while storing value with key '%s'.", ret, key);
+	}
+	return make_esp_error(ret);
+}
+
+static esp_err_t init_nvs() {
+	static auto ret = ESP_FAIL;
+
+	if (ret != ESP_OK) {
+		ret = nvs_flash_init();
+		if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+			if ((ret = nvs_flash_erase()) == ESP_OK) {
+				ret = nvs_flash_init();
+			}
+		}
+		ESP_LOGI(TAG, "NVS init %s", ret == ESP_OK ? "success" : "failure");
+	}
+
+	return ret;
+}
+
+
+std::error_code esp_nvs_backend::open(const char *name) {
+	if (const auto ret = init_nvs(); ret != ESP_OK)
+		return make_esp_error(ret);
+
+	return make_esp_error(nvs_open(name, NVS_READWRITE, &m_handle));
+}
+
+template<std::integral T>
+std::error_code esp_nvs_backend::get_int(const char *key, T &dst) {
+	esp_err_t ret;
+	if constexpr (std::same_as<T, u8>) ret = nvs_get_u8(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, i8>) ret = nvs_get_i8(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, u16>) ret = nvs_get_u16(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, i16>) ret = nvs_get_i16(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, u32>) ret = nvs_get_u32(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, i32>) ret = nvs_get_i32(m_handle, key, &dst);
+	else if constexpr (std::same_as<T, u64>) ret = nvs_get_u64(m_handle, key, &dst);
+	else ret = nvs_get_i64(m_handle, key, &dst);
+	return check_read(ret, key);
+}
+
+template<std::integral T>
+std::error_code esp_nvs_backend::set_int(const char *key, T src) {
+	esp_err_t ret;
+	if constexpr (std::same_as<T, u8>) ret = nvs_set_u8(m_handle, key, src);
+	else if constexpr (std::same_as<T, i8>) ret = nvs_set_i8(m_handle, key, src);
+	else if constexpr (std::same_as<T, u16>) ret = nvs_set_u16(m_handle, key, src);
+	else if constexpr (std::same_as<T, i16>) ret = nvs_set_i16(m_handle, key, src);
+	else if constexpr (std::same_as<T, u32>) ret = nvs_set_u32(m_handle, key, src);
+	else if constexpr (std::same_as<T, i32>) ret = nvs_set_i32(m_handle, key, src);
+	else if constexpr (std::same_as<T, u64>) ret = nvs_set_u64(m_handle, key, src);
+	else ret = nvs_set_i64(m_handle, key, src);
+	return check_write(ret, key);
+}
+
+#define INSTANTIATE_INT_ACCESS(T) \
+	template std::error_code esp_nvs_backend::get_int<T>(const char*, T&); \
+	template std::error_code esp_nvs_backend::set_int<T>(const char*, T);
+
+INSTANTIATE_INT_ACCESS(u8)
+INSTANTIATE_INT_ACCESS(i8)
+INSTANTIATE_INT_ACCESS(u16)
+INSTANTIATE_INT_ACCESS(i16)
+INSTANTIATE_INT_ACCESS(u32)
+INSTANTIATE_INT_ACCESS(i32)
+INSTANTIATE_INT_ACCESS(u64)
+INSTANTIATE_INT_ACCESS(i64)
+
+#undef INSTANTIATE_INT_ACCESS
+
+std::error_code esp_nvs_backend::get_str(const char *key, char *dst, usize &size) {
+	return check_read(nvs_get_str(m_handle, key, dst, &size), key);
+}
+
+std::error_code esp_nvs_backend::set_str(const char *key, const char *src) {
+	return check_write(nvs_set_str(m_handle, key, src), key);
+}
+
+std::error_code esp_nvs_backend::get_blob(const char *key, void *dst, usize &size) {
+	return check_read(nvs_get_blob(m_handle, key, dst, &size), key);
+}
+
+std::error_code esp_nvs_backend::set_blob(const char *key, const void *src, usize size) {
+	return check_write(nvs_set_blob(m_handle, key, src, size), key);
+}
+
+std::error_code esp_nvs_backend::commit() {
+	const auto ret = nvs_commit(m_handle);
+	if (ret != ESP_OK) {
+		ESP_LOGE(TAG, "Error '0x%x' while committing.", ret);
+	}
+	return make_esp_error(ret);
+}
+
+bool esp_nvs_backend::schedule_commit(i64 delayMicros, void (*callback)(void*), void *arg) {
+	// the timer keeps the callback of the first call, the handler always passes the same one
+	if (m_commitTimer == nullptr) {
+		const esp_timer_create_args_t timerArgs{
+			.callback = callback,
+			.arg = arg,
+			.dispatch_method = ESP_TIMER_TASK,
+			.name = "nvs_commit",
+			.skip_unhandled_events = true
+		};
+		if (esp_timer_create(&timerArgs, &m_commitTimer) != ESP_OK) {
+			m_commitTimer = nullptr;
+			return false;
+		}
+	}
+
+	return esp_timer_start_once(m_commitTimer, delayMicros) == ESP_OK;
+}
+
+void esp_nvs_backend::cancel_commit() {
+	if (m_commitTimer != nullptr) {
+		esp_timer_stop(m_commitTimer);
+	}
+}
+
+esp_nvs_backend::~esp_nvs_backend() {
+	if (m_commitTimer != nullptr) {
+		esp_timer_stop(m_commitTimer);
+		esp_timer_delete(m_commitTimer);
+	}
+}
@@ -0,0 +1,74 @@
+#include <platform/esp_partition_frame_storage.hpp>
+#include <platform/esp_error.hpp>
+
+#include <spi_flash_mmap.h>
+
+
+static inline std::error_code make_esp_error(esp_err_t code) {
+	return esp_error::make_error_code(static_cast<esp_error::codes>(code));
+}
+
+
+std::error_code esp_partition_frame_storage::open(const char *label) {
+	m_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, partitionSubtype, label);
+	return make_esp_error(m_partition ? ESP_OK : ESP_ERR_NOT_FOUND);
+}
+
+usize esp_partition_frame_storage::size() const {
+	return m_partition ? m_partition->size : 0;
+}
+
+usize esp_partition_frame_storage::block_size() const {
+	return SPI_FLASH_SEC_SIZE;
+}
+
+std::error_code esp_partition_frame_storage::erase(usize offset, usize size) {
+	if (m_partition == nullptr)
+		return make_esp_error(ESP_ERR_INVALID_STATE);
+
+	// flash can only be erased in whole sectors
+	const auto alignedSize = (size + SPI_FLASH_SEC_SIZE - 1) / SPI_FLASH_SEC_SIZE * SPI_FLASH_SEC_SIZE;
+	return make_esp_error(esp_partition_erase_range(m_partition, offset, alignedSize));
+}
+
+std::error_code esp_partition_frame_storage::write(usize offset, std::span<const u8> data) {
+	if (m_partition == nullptr)
+		return make_esp_error(ESP_ERR_INVALID_STATE);
+
+	return make_esp_error(esp_partition_write(m_partition, offset, data.data(), data.size()));
+}
+
+std::error_code esp_partition_frame_storage::map(std::span<const u8> &region) {
+	if (m_partition == nullptr)
+		return make_esp_error(ESP_ERR_INVALID_STATE);
+
+	if (m_mapped) {
+		region = { m_mapped, m_partition->size };
+		return make_esp_error(ESP_OK);
+	}
+
+	const void *mapped;
+	const auto error = esp_partition_mmap(
+		m_partition, 0, m_partition->size,
+		ESP_PARTITION_MMAP_DATA,
+		&mapped, &m_mapHandle
+	);
+
+	if (error == ESP_OK) {
+		m_mapped = static_cast<const u8*>(mapped);
+		region = { m_mapped, m_partition->size };
+	}
+
+	return make_esp_error(error);
+}
+
+void esp_partition_frame_storage::unmap() {
+	if (m_mapped) {
+		esp_partition_munmap(m_mapHandle);
+		m_mapped = nullptr;
+	}
+}
+
+esp_partition_frame_storage::~esp_partition_frame_storage() {
+	unmap();
+}
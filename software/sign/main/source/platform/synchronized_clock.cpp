@@ -0,0 +1,30 @@
+#include <platform/synchronized_clock.hpp>
+
+#include <esp_timer.h>
+#include <esp_log.h>
+
+i64 synchronized_clock::local() {
+	return esp_timer_get_time();
+}
+
+i64 synchronized_clock::now() const {
+	return mapping().toReference(local());
+}
+
+clock_mapping synchronized_clock::mapping() const {
+	return m_mapping.load();
+}
+
+void synchronized_clock::addSample(const clock_sample &sample) {
+	static constexpr auto TAG = "SYNCHRONIZED_CLOCK";
+
+	m_estimator.addSample(sample);
+
+	const auto &mapping = m_estimator.mapping();
+	m_mapping.store(mapping);
+
+	ESP_LOGD(
+		TAG, "delay: %lldus offset: %lldus skew: %ldppb",
+		sample.delay, mapping.anchorOffset, mapping.skewPpb
+	);
+}
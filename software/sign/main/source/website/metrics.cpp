@@ -0,0 +1,29 @@
+#include <website/http_handlers.hpp>
+
+#include <array>
+#include <charconv>
+
+// Metrics of the sign in the prometheus text format, one 'openstreamsign_<name> <value>' line each.
+// The numbers are read from relaxed counters, so nothing waits for the animation or main task.
+
+esp_err_t metrics_handler(httpd_req_t *req) {
+	httpd_resp_set_type(req, "text/plain; version=0.0.4");
+	httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+	const auto metrics = collect_metrics();
+
+	httpd_chunk_sink sink{ req };
+	html_writer writer(sink);
+
+	std::array<char, 12> number;
+	for (const auto &field : sign_metrics_fields::fields) {
+		const auto [ end, ec ] = std::to_chars(number.begin(), number.end(), metrics.*field.member);
+		writer.write("openstreamsign_");
+		writer.write(field.name);
+		writer.write(" ");
+		writer.write({ number.begin(), end });
+		writer.write("\n");
+	}
+
+	return writer.finish() ? ESP_OK : ESP_FAIL;
+}
@@ -1,35 +1,37 @@
 #include <website/http_handlers.hpp>
+#include <website/html/networking_form.hpp>
 
-using networkingForm = html::form<
-	html::form_field<"IP-Address:", "ip",  input_types::ipv4>{},
-	html::form_field<"Netmask:", "nm", input_types::ipv4>{},
-	html::form_field<"Gateway:", "gw", input_types::ipv4>{},
-	html::form_field<"Port:", "port", input_types::port>{}
->;
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
+
+using networkingForm = networking_form<CONFIG_MAX_NUM_PIXELS>;
 
 esp_err_t networking_get_handler(httpd_req_t *req) {
 
 	ESP_LOGI("NET", "net handler started");
 
-	using ztu::string_literal;
-	
-	const auto form = networkingForm::createForm<"Networking", "", "/secret/">(
-		string_literal(CONFIG_DEFAULT_IP_ADDRESS),
-		string_literal(CONFIG_DEFAULT_NETMASK),
-		string_literal(CONFIG_DEFAULT_GATEWAY),
-		string_literal(CONFIG_DEFAULT_PORT)
-	);
-
-	const auto html = html::page::createDefault<"Networking", "/script.js", "/style.css">(
-		form + getErrorForm(sign.error)
-	);
-
-	httpd_resp_set_type(req, "text/html");
-	httpd_resp_send(req, html.c_str(), HTTPD_RESP_USE_STRLEN);
+	// the current length, it is only known at runtime
+	std::array<char, 6> numPixels;
+	const auto numPixelsEnd = std::to_chars(
+		numPixels.data(), numPixels.data() + numPixels.size(), sign.storage.get<storage_keys::NUM_PIXELS>()
+	).ptr;
+
+	const auto ret = send_page<"Networking">(req, [&](html_writer &writer) {
+		networkingForm::render<"Networking", "", "/secret/">(
+			writer,
+			CONFIG_DEFAULT_IP_ADDRESS,
+			CONFIG_DEFAULT_NETMASK,
+			CONFIG_DEFAULT_GATEWAY,
+			CONFIG_DEFAULT_PORT,
+			std::string_view(numPixels.data(), numPixelsEnd)
+		);
+	});
 
 	ESP_LOGI("NET", "net handler terminated");
 
-	return ESP_OK;
+	return ret;
 }
 
 esp_err_t networking_post_handler(httpd_req_t *req) {
@@ -40,6 +42,8 @@ esp_err_t networking_post_handler(httpd_req_t *req) {
 		sign.storage.set<storage_keys::SUBNETMASK>(std::get<1>(values));
 		sign.storage.set<storage_keys::GATEWAY	>(std::get<2>(values));
 		sign.storage.set<storage_keys::PORT		>(std::get<3>(values));
+		// the frame buffers are allocated at startup, so the count applies after the next restart
+		sign.storage.set<storage_keys::NUM_PIXELS	>(std::clamp<u16>(std::get<4>(values), 1, CONFIG_MAX_NUM_PIXELS));
 		return httpd_resp_send_200(req);
 	} else {
 		return httpd_resp_send_400(req);
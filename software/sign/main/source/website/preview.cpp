@@ -0,0 +1,175 @@
+#include <website/http_handlers.hpp>
+
+#include <lighting/frame_delta.hpp>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+
+// The live preview streams the frames of the animation task to one browser at a time.
+// The browser sends the frame rate it wants as single byte and gets the accepted rate
+// back as text, after that it receives binary 'frame_delta' messages.
+//
+// Sockets of the server may only be used from its own task, so the preview task only
+// encodes the frames and queues the sending as work item of the server.
+
+inline constexpr auto PREVIEW_TAG = "PREVIEW";
+
+using preview_frame_t = sign_animation_handler_t::preview_frame;
+
+static constexpr u8 maxFramesPerSecond = CONFIG_ANIMATION_TICKS_PER_SECOND;
+
+static struct {
+	httpd_handle_t server{ nullptr };
+	// socket of the client, -1 while nobody watches
+	std::atomic<int> fd{ -1 };
+	std::atomic<u8> framesPerSecond{ 1 };
+	std::atomic<bool> taskRunning{ false };
+	std::atomic<bool> stopRequested{ false };
+	// set while a message waits in the work queue of the server, the buffer must not change until then
+	std::atomic<bool> sending{ false };
+	std::array<u8, frame_delta::max_encoded_size(sign_animation_handler_t::maxPreviewPixels)> message;
+	usize messageSize{ 0 };
+	// kept out of the small stack of the preview task
+	preview_frame_t frame, previous;
+} preview;
+
+static void send_preview_message(void *) {
+	auto fd = preview.fd.load();
+
+	if (httpd_ws_get_fd_info(preview.server, fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+		ESP_LOGI(PREVIEW_TAG, "Client %d left", fd);
+		preview.fd.compare_exchange_strong(fd, -1);
+	} else {
+		httpd_ws_frame_t frame{
+			.final = true,
+			.fragmented = false,
+			.type = HTTPD_WS_TYPE_BINARY,
+			.payload = preview.message.data(),
+			.len = preview.messageSize
+		};
+		if (const auto ret = httpd_ws_send_frame_async(preview.server, fd, &frame); ret != ESP_OK) {
+			ESP_LOGW(PREVIEW_TAG, "Sending to %d failed: %s", fd, esp_err_to_name(ret));
+			preview.fd.compare_exchange_strong(fd, -1);
+		}
+	}
+
+	preview.sending = false;
+}
+
+static void preview_task(void *) {
+	auto &frame = preview.frame, &previous = preview.previous;
+	u32 previousVersion = 0;
+	// the first frame for a client is sent whole
+	int previousFd = -1;
+
+	while (not preview.stopRequested) {
+		vTaskDelay(pdMS_TO_TICKS(1000 / preview.framesPerSecond.load()));
+
+		const auto fd = preview.fd.load();
+
+		// the animation task only copies its frames while someone watches
+		sign.animation_controller.setPreviewEnabled(fd != -1);
+
+		if (fd == -1 or preview.sending) {
+			continue;
+		}
+
+		u32 version;
+		frame = sign.animation_controller.previewFrame(version);
+		if (version == previousVersion and fd == previousFd)
+			continue;
+
+		preview.messageSize = frame_delta::encode(
+			fd == previousFd ? previous.colors() : std::span<const color>(),
+			frame.colors(),
+			preview.message
+		);
+
+		preview.sending = true;
+		if (httpd_queue_work(preview.server, send_preview_message, nullptr) != ESP_OK) {
+			preview.sending = false;
+			continue;
+		}
+
+		previous = frame;
+		previousVersion = version;
+		previousFd = fd;
+	}
+
+	sign.animation_controller.setPreviewEnabled(false);
+
+	// a queued message still points into the buffer
+	while (preview.sending) {
+		vTaskDelay(1);
+	}
+
+	preview.taskRunning = false;
+	vTaskDelete(nullptr);
+}
+
+static esp_err_t reply_rate(httpd_req_t *req, u8 framesPerSecond) {
+	std::array<char, 4> text;
+	const auto [ end, ec ] = std::to_chars(text.data(), text.data() + text.size(), framesPerSecond);
+
+	httpd_ws_frame_t frame{
+		.final = true,
+		.fragmented = false,
+		.type = HTTPD_WS_TYPE_TEXT,
+		.payload = reinterpret_cast<u8*>(text.data()),
+		.len = static_cast<size_t>(end - text.data())
+	};
+	return httpd_ws_send_frame(req, &frame);
+}
+
+esp_err_t preview_handler(httpd_req_t *req) {
+	if (req->method == HTTP_GET) {
+		// handshake done, streaming starts with the first rate request
+		return ESP_OK;
+	}
+
+	std::array<u8, 8> payload;
+	httpd_ws_frame_t frame{};
+	if (const auto ret = httpd_ws_recv_frame(req, &frame, 0); ret != ESP_OK)
+		return ret;
+
+	if (frame.len > payload.size())
+		return ESP_ERR_INVALID_SIZE;
+
+	frame.payload = payload.data();
+	if (const auto ret = httpd_ws_recv_frame(req, &frame, payload.size()); ret != ESP_OK) {
+		ESP_LOGW(PREVIEW_TAG, "Receiving rate failed: %s", esp_err_to_name(ret));
+		return ret;
+	}
+
+	if (frame.type != HTTPD_WS_TYPE_BINARY or frame.len != 1)
+		return ESP_OK;
+
+	const auto framesPerSecond = std::clamp(payload[0], u8{ 1 }, maxFramesPerSecond);
+	preview.framesPerSecond = framesPerSecond;
+	preview.server = req->handle;
+	preview.fd = httpd_req_to_sockfd(req);
+
+	if (not preview.taskRunning.exchange(true)) {
+		preview.stopRequested = false;
+		// reading a frame copies it through the stack
+		if (xTaskCreate(preview_task, "preview", 3072 + 2 * sizeof(preview_frame_t), nullptr, tskIDLE_PRIORITY + 1, nullptr) != pdPASS) {
+			preview.taskRunning = false;
+			return ESP_ERR_NO_MEM;
+		}
+	}
+
+	ESP_LOGI(PREVIEW_TAG, "Streaming to %d at %u frames per second", preview.fd.load(), framesPerSecond);
+
+	return reply_rate(req, framesPerSecond);
+}
+
+void stop_preview() {
+	preview.stopRequested = true;
+	while (preview.taskRunning) {
+		vTaskDelay(1);
+	}
+	preview.fd = -1;
+}
@@ -31,7 +31,64 @@ function encodeIPv4(str, dst) {
 	return true;
 }
 
+// Applies a 'frame_delta' message of the live preview to the rgba pixels of an image.
+function applyFrame(bytes, pixels) {
+	const numPixels = bytes[2] | (bytes[3] << 8);
+	if (pixels.length !== numPixels * 4)
+		return false;
+	const setPixels = (offset, pixel, count) => {
+		for (let i = 0; i < count; i++) {
+			pixels.set([bytes[offset], bytes[offset + 1], bytes[offset + 2], 255], (pixel + i) * 4);
+			offset += 3;
+		}
+	};
+	if (bytes[0] === 0) {
+		setPixels(4, 0, numPixels);
+		return true;
+	}
+	let offset = 4, pixel = 0;
+	while (offset + 4 <= bytes.length) {
+		pixel += bytes[offset] | (bytes[offset + 1] << 8);
+		const count = bytes[offset + 2] | (bytes[offset + 3] << 8);
+		setPixels(offset + 4, pixel, count);
+		offset += 4 + count * 3;
+		pixel += count;
+	}
+	return true;
+}
+
+function startPreview(canvas) {
+	const framesPerSecond = 10;
+	const socket = new WebSocket(`wss://${window.location.host}/preview/`);
+	socket.binaryType = 'arraybuffer';
+	let image = null;
+	socket.onopen = () => socket.send(new Uint8Array([framesPerSecond]));
+	socket.onmessage = (event) => {
+		// text messages carry the frame rate the sign accepted
+		if (typeof event.data === 'string')
+			return;
+		const bytes = new Uint8Array(event.data);
+		const numPixels = bytes[2] | (bytes[3] << 8);
+		if (!image || image.width !== numPixels) {
+			canvas.width = numPixels;
+			canvas.height = 1;
+			image = canvas.getContext('2d').createImageData(numPixels, 1);
+		}
+		if (applyFrame(bytes, image.data)) {
+			canvas.getContext('2d').putImageData(image, 0, 0);
+			canvas.style.display = 'block';
+		}
+	};
+	socket.onclose = () => {
+		canvas.style.display = 'none';
+	};
+}
+
 window.addEventListener('load', () => {
+	const preview = document.getElementById('preview');
+	if (preview && window.WebSocket)
+		startPreview(preview);
+
 	const andChar = 254;
 	const equalChar = 255;
 
@@ -26,16 +26,13 @@ esp_err_t secret_get_handler(httpd_req_t *req) {
 		assert(success);
 	}
 
-	using namespace ztu::string_literals;
-	const auto form = secretForm::createForm<"Secret", "", "/done/">(encodedSecret, "Copy"_sl);
-	const auto html = html::page::createDefault<"Secret", "/script.js", "/style.css">(
-		form + getErrorForm(sign.error)
-	);
-
-	httpd_resp_set_type(req, "text/html");
-	httpd_resp_send(req, html.c_str(), HTTPD_RESP_USE_STRLEN);
-
-	return ESP_OK;
+	return send_page<"Secret">(req, [&](html_writer &writer) {
+		secretForm::render<"Secret", "", "/done/">(
+			writer,
+			{ encodedSecret.c_str(), static_cast<std::size_t>(encodedSecret.size()) },
+			"Copy"
+		);
+	});
 }
 
 esp_err_t secret_post_handler(httpd_req_t *req) {
@@ -0,0 +1,37 @@
+#include <website/static_asset.hpp>
+
+#include <array>
+#include <cstring>
+
+static bool client_has_asset(httpd_req_t *req, const static_asset &asset) {
+	// room for a handful of etags, longer lists are answered with the asset
+	std::array<char, 128> if_none_match;
+
+	const auto length = httpd_req_get_hdr_value_len(req, "If-None-Match");
+	if (length == 0 or length >= if_none_match.size())
+		return false;
+
+	if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match.data(), if_none_match.size()) != ESP_OK)
+		return false;
+
+	return std::strstr(if_none_match.data(), asset.etag) != nullptr;
+}
+
+esp_err_t send_static_asset(httpd_req_t *req, const static_asset &asset) {
+	httpd_resp_set_hdr(req, "ETag", asset.etag);
+	httpd_resp_set_hdr(req, "Cache-Control", "public, max-age=31536000, immutable");
+
+	if (client_has_asset(req, asset)) {
+		httpd_resp_set_status(req, "304 Not Modified");
+		return httpd_resp_send(req, nullptr, 0);
+	}
+
+	httpd_resp_set_type(req, asset.content_type);
+	httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+
+	return httpd_resp_send(
+		req,
+		reinterpret_cast<const char*>(asset.gzipped.data()),
+		static_cast<ssize_t>(asset.gzipped.size())
+	);
+}
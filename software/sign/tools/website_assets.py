@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Minifies and gzips the static assets of the config webserver into a C++ header.
+
+Every asset is embedded as a gzip blob together with a content hash. The hash
+is part of the uri and doubles as ETag, so browsers may cache the assets for
+good and a new firmware with changed assets is picked up through the new uri.
+
+The minifiers only strip comments and whitespace and know about strings, they
+do not support regular expression literals in scripts.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+CONTENT_TYPES = {
+	'.css': 'text/css',
+	'.js': 'text/javascript',
+	'.html': 'text/html',
+}
+
+IDENTIFIER_CHARS = re.compile(r'[A-Za-z0-9_$]')
+
+
+def minify_css(text):
+	text = re.sub(r'/\*.*?\*/', '', text, flags=re.S)
+	text = re.sub(r'\s+', ' ', text)
+	text = re.sub(r'\s*([{};,>])\s*', r'\1', text)
+	text = re.sub(r':\s+', ':', text)
+	return text.replace(';}', '}').strip()
+
+
+def js_tokens(text):
+	"""Splits a script into code, string and whitespace pieces, comments are dropped."""
+	i, n = 0, len(text)
+	while i < n:
+		c = text[i]
+		if c in '\'"`':
+			j = i + 1
+			while j < n and text[j] != c:
+				j += 2 if text[j] == '\\' else 1
+			yield 'string', text[i:j + 1]
+			i = j + 1
+		elif text.startswith('//', i):
+			i = text.find('\n', i)
+			i = n if i < 0 else i
+		elif text.startswith('/*', i):
+			i = text.index('*/', i) + 2
+			yield 'space', ' '
+		elif c.isspace():
+			j = i
+			while j < n and text[j].isspace():
+				j += 1
+			yield 'space', '\n' if '\n' in text[i:j] else ' '
+			i = j
+		else:
+			j = i
+			while j < n and not text[j].isspace() and text[j] not in '\'"`' and not text.startswith(('//', '/*'), j):
+				j += 1
+			yield 'code', text[i:j]
+			i = j
+
+
+def minify_js(text):
+	out = []
+	pending = None
+	for kind, token in js_tokens(text):
+		if kind == 'space':
+			# a line break may end a statement, keep the strongest whitespace
+			pending = '\n' if '\n' in (pending or '') + token else ' '
+			continue
+		if pending and out:
+			prev, next = out[-1][-1], token[0]
+			if IDENTIFIER_CHARS.match(prev) and IDENTIFIER_CHARS.match(next):
+				out.append(pending if pending == '\n' and not keeps_statement(out) else ' ')
+			elif prev in '+-' and next in '+-':
+				out.append(' ')
+			elif pending == '\n' and not continues_statement(out, next):
+				out.append('\n')
+		out.append(token)
+		pending = None
+	return ''.join(out).strip()
+
+
+def keeps_statement(out):
+	return out[-1][-1] in '{([,;:=+-*/&|!?<>' and not out[-1].endswith(('++', '--'))
+
+
+def continues_statement(out, next):
+	"""True if the line break can not terminate a statement, so dropping it is safe."""
+	return keeps_statement(out) or next in ')]},;.?:'
+
+
+def c_identifier(path):
+	return re.sub(r'\W', '_', os.path.basename(path))
+
+
+def embed(path):
+	stem, extension = os.path.splitext(os.path.basename(path))
+	with open(path, encoding='utf-8') as file:
+		text = file.read()
+
+	if extension == '.css':
+		text = minify_css(text)
+	elif extension == '.js':
+		text = minify_js(text)
+
+	# without a timestamp the output only depends on the content
+	data = gzip.compress(text.encode('utf-8'), compresslevel=9, mtime=0)
+	digest = hashlib.sha256(data).hexdigest()[:8]
+
+	return {
+		'name': c_identifier(path),
+		'uri': f'/{stem}.{digest}{extension}',
+		'etag': f'"{digest}"',
+		'type': CONTENT_TYPES.get(extension, 'application/octet-stream'),
+		'data': data,
+		'size': len(text),
+	}
+
+
+def render(assets, sources):
+	lines = [
+		'// Generated by website_assets.py from ' + ', '.join(os.path.basename(s) for s in sources) + ', do not edit.',
+		'#pragma once',
+		'',
+		'#include <website/static_asset.hpp>',
+		'#include <util/string_literal.hpp>',
+		'',
+		'namespace website_assets {',
+	]
+	for asset in assets:
+		name, data = asset['name'], asset['data']
+		lines.append('')
+		lines.append(f'\t// {asset["size"]} bytes minified, {len(data)} bytes compressed')
+		lines.append(f'\tinline constexpr auto {name}_uri = ztu::string_literal{{ "{asset["uri"]}" }};')
+		lines.append(f'\tinline constexpr u8 {name}_data[{len(data)}]{{')
+		for offset in range(0, len(data), 16):
+			lines.append('\t\t' + ', '.join(f'0x{b:02x}' for b in data[offset:offset + 16]) + ',')
+		lines.append('\t};')
+		lines.append(f'\tinline constexpr static_asset {name}{{')
+		lines.append(f'\t\t.uri\t\t\t= {name}_uri.c_str(),')
+		lines.append(f'\t\t.content_type\t= "{asset["type"]}",')
+		lines.append(f'\t\t.etag\t\t\t= "\\"{asset["etag"][1:-1]}\\"",')
+		lines.append(f'\t\t.gzipped\t\t= {name}_data')
+		lines.append('\t};')
+	lines.append('}')
+	return '\n'.join(lines) + '\n'
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+	parser.add_argument('--output', required=True, help='header to generate')
+	parser.add_argument('sources', nargs='+')
+	args = parser.parse_args()
+
+	assets = [embed(source) for source in args.sources]
+	header = render(assets, args.sources)
+
+	os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+
+	# leave the header alone if nothing changed, so dependent sources are not rebuilt
+	if os.path.exists(args.output):
+		with open(args.output, encoding='utf-8') as file:
+			if file.read() == header:
+				return 0
+
+	with open(args.output, 'w', encoding='utf-8') as file:
+		file.write(header)
+
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())